@@ -0,0 +1,15 @@
+#include "buffer/buffer_access_strategy.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, size_t ring_size)
+    : buffer_pool_manager_(buffer_pool_manager) {
+  size_t num_instances = buffer_pool_manager_->GetNumInstances();
+  size_t ring_capacity = std::max<size_t>(1, (ring_size + num_instances - 1) / num_instances);
+  rings_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    rings_.emplace_back(ring_capacity, buffer_pool_manager_->GetDatabaseId());
+  }
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() { buffer_pool_manager_->ReleaseStrategy(this); }
@@ -0,0 +1,326 @@
+#include "buffer/buffer_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "glog/logging.h"
+
+BufferPool::BufferPool(size_t pool_size, size_t num_instances, ReplacerType replacer_type, size_t lru_k)
+    : pool_size_(pool_size), disk_managers_(MAX_OPEN_DATABASES, nullptr) {
+  ASSERT(num_instances > 0 && num_instances <= pool_size, "Invalid number of buffer pool instances.");
+  for (size_t i = 0; i < num_instances; i++) {
+    // spread the remainder over the first instances
+    size_t instance_size = pool_size_ / num_instances + (i < pool_size_ % num_instances ? 1 : 0);
+    instances_.emplace_back(new BufferPoolManagerInstance(instance_size, disk_managers_.data(), replacer_type, lru_k));
+  }
+}
+
+BufferPool::~BufferPool() {
+  StopPrefetcher();
+  StopCleaner();
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+db_id_t BufferPool::AttachDatabase(DiskManager *disk_manager) {
+  scoped_lock<mutex> lock(databases_latch_);
+  auto slot = find(disk_managers_.begin(), disk_managers_.end(), nullptr);
+  if (slot == disk_managers_.end()) {
+    throw logic_error("Too many databases share the buffer pool.");
+  }
+  *slot = disk_manager;
+  return static_cast<db_id_t>(slot - disk_managers_.begin());
+}
+
+void BufferPool::DetachDatabase(db_id_t db_id) {
+  deque<PrefetchRequest> dropped;
+  {
+    unique_lock<mutex> lock(prefetch_latch_);
+    for (auto iter = prefetch_queue_.begin(); iter != prefetch_queue_.end();) {
+      if (iter->db_id_ == db_id) {
+        dropped.push_back(std::move(*iter));
+        iter = prefetch_queue_.erase(iter);
+      } else {
+        iter++;
+      }
+    }
+    prefetch_done_cv_.wait(lock, [&] { return !prefetch_busy_ || prefetch_db_id_ != db_id; });
+  }
+  // Dropping a request may release the last reference to a strategy, which needs the disk manager.
+  dropped.clear();
+  // Write the dirty pages as one sorted batch first, the instances then only drop the frames.
+  FlushAllPages(db_id);
+  for (auto instance : instances_) {
+    instance->DropDatabase(db_id);
+  }
+  scoped_lock<mutex> lock(databases_latch_);
+  disk_managers_[db_id] = nullptr;
+}
+
+Page *BufferPool::FetchPage(db_id_t db_id, page_id_t page_id, BufferAccessStrategy *strategy) {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  size_t index = GetInstanceIndex(db_id, page_id);
+  return instances_[index]->FetchPage(db_id, page_id, strategy == nullptr ? nullptr : strategy->GetRing(index));
+}
+
+bool BufferPool::UnpinPage(db_id_t db_id, page_id_t page_id, bool is_dirty) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetInstance(db_id, page_id)->UnpinPage(db_id, page_id, is_dirty);
+}
+
+bool BufferPool::FlushPage(db_id_t db_id, page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetInstance(db_id, page_id)->FlushPage(db_id, page_id);
+}
+
+Page *BufferPool::NewPage(db_id_t db_id, page_id_t page_id) {
+  return GetInstance(db_id, page_id)->NewPage(db_id, page_id);
+}
+
+bool BufferPool::DeletePage(db_id_t db_id, page_id_t page_id) {
+  return GetInstance(db_id, page_id)->DeletePage(db_id, page_id);
+}
+
+void BufferPool::PrefetchPages(db_id_t db_id, const vector<page_id_t> &page_ids,
+                               shared_ptr<BufferAccessStrategy> strategy) {
+  PrefetchRequest request;
+  request.db_id_ = db_id;
+  request.page_ids_ = page_ids;
+  request.strategy_ = std::move(strategy);
+  SubmitPrefetch(std::move(request));
+}
+
+void BufferPool::PrefetchChain(db_id_t db_id, page_id_t first_page_id, size_t num_pages, NextPageFunc next_page,
+                               shared_ptr<BufferAccessStrategy> strategy) {
+  if (first_page_id == INVALID_PAGE_ID || num_pages == 0) {
+    return;
+  }
+  PrefetchRequest request;
+  request.db_id_ = db_id;
+  request.page_ids_.push_back(first_page_id);
+  request.chain_length_ = num_pages;
+  request.next_page_ = std::move(next_page);
+  request.strategy_ = std::move(strategy);
+  SubmitPrefetch(std::move(request));
+}
+
+void BufferPool::SubmitPrefetch(PrefetchRequest &&request) {
+  {
+    scoped_lock<mutex> lock(prefetch_latch_);
+    if (prefetch_stop_ || prefetch_queue_.size() >= static_cast<size_t>(DEFAULT_PREFETCH_QUEUE_SIZE)) {
+      return;
+    }
+    if (!prefetch_thread_.joinable()) {
+      prefetch_thread_ = thread(&BufferPool::RunPrefetcher, this);
+    }
+    prefetch_queue_.push_back(std::move(request));
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPool::RunPrefetcher() {
+  unique_lock<mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return prefetch_stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_stop_) {
+      return;
+    }
+    PrefetchRequest request = std::move(prefetch_queue_.front());
+    prefetch_queue_.pop_front();
+    prefetch_busy_ = true;
+    prefetch_db_id_ = request.db_id_;
+    lock.unlock();
+    auto prefetch = [&](page_id_t page_id) {
+      size_t index = GetInstanceIndex(request.db_id_, page_id);
+      BufferRing *ring = GetRing(request, index);
+      bool loaded;
+      page_id_t next_page_id =
+          instances_[index]->PrefetchPage(request.db_id_, page_id, ring, request.next_page_, &loaded);
+      if (loaded) {
+        prefetched_pages_++;
+      }
+      return next_page_id;
+    };
+    if (request.chain_length_ == 0) {
+      // Reserve the frames in every instance first, so that all the pages of the list are read in one batch.
+      vector<vector<page_id_t>> page_ids(instances_.size());
+      for (auto page_id : request.page_ids_) {
+        if (page_id != INVALID_PAGE_ID) {
+          page_ids[GetInstanceIndex(request.db_id_, page_id)].push_back(page_id);
+        }
+      }
+      IoBatch reads;
+      vector<vector<pair<frame_id_t, page_id_t>>> frames(instances_.size());
+      for (size_t i = 0; i < instances_.size(); i++) {
+        if (!page_ids[i].empty()) {
+          frames[i] = instances_[i]->StartPrefetch(request.db_id_, page_ids[i], GetRing(request, i), reads);
+        }
+      }
+      DiskManager::SubmitBatch(reads);
+      reads.Wait();
+      for (size_t i = 0; i < instances_.size(); i++) {
+        if (!frames[i].empty()) {
+          prefetched_pages_ += instances_[i]->FinishPrefetch(request.db_id_, frames[i], GetRing(request, i));
+        }
+      }
+    } else {
+      page_id_t page_id = request.page_ids_[0];
+      for (size_t i = 0; i < request.chain_length_ && page_id >= 0; i++) {
+        page_id = prefetch(page_id);
+      }
+    }
+    // The last reference to the strategy may be the request, release its rings outside the latch.
+    request = PrefetchRequest();
+    lock.lock();
+    prefetch_busy_ = false;
+    prefetch_done_cv_.notify_all();
+  }
+}
+
+void BufferPool::StopPrefetcher() {
+  {
+    scoped_lock<mutex> lock(prefetch_latch_);
+    prefetch_stop_ = true;
+  }
+  prefetch_cv_.notify_all();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  prefetch_queue_.clear();
+}
+
+void BufferPool::ReleaseStrategy(BufferAccessStrategy *strategy) {
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->ReleaseRing(strategy->GetRing(i));
+  }
+}
+
+void BufferPool::FlushAllPages(db_id_t db_id) { Flush(db_id, nullptr); }
+
+size_t BufferPool::FlushPages(db_id_t db_id, const vector<page_id_t> &page_ids) { return Flush(db_id, &page_ids); }
+
+size_t BufferPool::Flush(db_id_t db_id, const vector<page_id_t> *page_ids) {
+  vector<vector<page_id_t>> instance_page_ids;
+  if (page_ids != nullptr) {
+    instance_page_ids.resize(instances_.size());
+    for (auto page_id : *page_ids) {
+      if (page_id != INVALID_PAGE_ID) {
+        instance_page_ids[GetInstanceIndex(db_id, page_id)].push_back(page_id);
+      }
+    }
+  }
+  // Adjacent pages belong to different instances, so the pages of all of them go into one batch.
+  vector<vector<PageFlush>> flushes(instances_.size());
+  vector<pair<page_id_t, const char *>> pages;
+  size_t resident = 0;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    resident += instances_[i]->BeginFlush(db_id, page_ids == nullptr ? nullptr : &instance_page_ids[i], flushes[i]);
+    for (auto &flush : flushes[i]) {
+      pages.emplace_back(flush.page_id_, flush.page_->GetData());
+    }
+  }
+  auto start = LatencyRecorder::Clock::now();
+  if (!pages.empty()) {
+    IoBatch batch;
+    disk_managers_[db_id]->AddWrites(batch, pages);
+    DiskManager::SubmitBatch(batch);
+    batch.Wait();
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->EndFlush(flushes[i], start);
+  }
+  return resident;
+}
+
+void BufferPool::StartCleaner(size_t clean_target, uint32_t interval_ms) {
+  scoped_lock<mutex> lock(cleaner_latch_);
+  if (cleaner_thread_.joinable()) {
+    return;
+  }
+  cleaner_stop_ = false;
+  cleaner_thread_ = thread(&BufferPool::RunCleaner, this, clean_target, interval_ms);
+}
+
+void BufferPool::StopCleaner() {
+  {
+    scoped_lock<mutex> lock(cleaner_latch_);
+    if (!cleaner_thread_.joinable()) {
+      return;
+    }
+    cleaner_stop_ = true;
+  }
+  cleaner_cv_.notify_all();
+  cleaner_thread_.join();
+}
+
+void BufferPool::RunCleaner(size_t clean_target, uint32_t interval_ms) {
+  unique_lock<mutex> lock(cleaner_latch_);
+  while (!cleaner_stop_) {
+    lock.unlock();
+    for (auto instance : instances_) {
+      // never aim at more than a quarter of an instance, small pools would be flushed all the time
+      size_t target = min(clean_target, max<size_t>(1, instance->GetPoolSize() / 4));
+      cleaner_pages_ += instance->CleanFrames(target);
+    }
+    cleaner_rounds_++;
+    lock.lock();
+    cleaner_cv_.wait_for(lock, chrono::milliseconds(interval_ms), [this] { return cleaner_stop_; });
+  }
+}
+
+CleanerStats BufferPool::GetCleanerStats() {
+  CleanerStats stats;
+  stats.rounds_ = cleaner_rounds_;
+  stats.pages_cleaned_ = cleaner_pages_;
+  for (auto instance : instances_) {
+    stats.dirty_evictions_ += instance->GetDirtyEvictions();
+  }
+  return stats;
+}
+
+vector<BufferPoolStats> BufferPool::GetInstanceStats() {
+  vector<BufferPoolStats> stats;
+  stats.reserve(instances_.size());
+  for (auto instance : instances_) {
+    stats.push_back(instance->GetStats());
+  }
+  return stats;
+}
+
+BufferPoolStats BufferPool::GetStats() {
+  BufferPoolStats stats;
+  for (auto instance : instances_) {
+    stats.Add(instance->GetStats());
+  }
+  return stats;
+}
+
+size_t BufferPool::Resize(size_t pool_size) {
+  scoped_lock<mutex> lock(resize_latch_);
+  // every instance keeps at least one frame
+  pool_size = max(pool_size, instances_.size());
+  size_t new_size = 0;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    size_t instance_size = pool_size / instances_.size() + (i < pool_size % instances_.size() ? 1 : 0);
+    new_size += instances_[i]->Resize(instance_size);
+  }
+  pool_size_ = new_size;
+  return new_size;
+}
+
+// Only used for debug
+bool BufferPool::CheckAllUnpinned(db_id_t db_id) {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned(db_id) && res;
+  }
+  return res;
+}
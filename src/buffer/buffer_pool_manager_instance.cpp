@@ -0,0 +1,762 @@
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "glog/logging.h"
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *const *disk_managers,
+                                                     ReplacerType replacer_type, size_t lru_k)
+    : pool_size_(0),
+      disk_managers_(disk_managers),
+      page_table_(pool_size),
+      replacer_type_(replacer_type),
+      lru_k_(lru_k) {
+  AddFrames(pool_size);
+  replacer_ = Replacer::Create(replacer_type_, capacity_, lru_k_);
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  {
+    unique_lock<mutex> lock(latch_);
+    vector<frame_id_t> frame_ids(capacity_);
+    for (size_t i = 0; i < capacity_; i++) {
+      frame_ids[i] = static_cast<frame_id_t>(i);
+    }
+    WaitForWrites(lock, frame_ids);
+    WriteBackFrames(frame_ids);
+  }
+  delete replacer_;
+}
+
+Page *BufferPoolManagerInstance::FetchPage(db_id_t db_id, page_id_t page_id, BufferRing *ring) {
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  frame_id_t frame_id = page_table_.Find(db_id, page_id);
+  if (frame_id != INVALID_FRAME_ID) {
+    if (TryPin(GetFrame(frame_id), db_id, page_id, ring == nullptr)) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      // Whoever holds the latch drains the log before evicting, only a filling log needs a drain here.
+      if (ring == nullptr && access_log_.Add(frame_id, page_id)) {
+        unique_lock<mutex> lock(latch_, try_to_lock);
+        if (lock.owns_lock()) {
+          DrainAccessLog();
+        }
+      }
+      return GetFrame(frame_id);
+    }
+    pin_waits_.fetch_add(1, std::memory_order_relaxed);
+  }
+  // Missed without the latch, the page may still be resident (e.g. it was being loaded by another thread).
+  scoped_lock<mutex> lock(latch_);
+  frame_id = page_table_.Find(db_id, page_id);
+  if (frame_id != INVALID_FRAME_ID) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    Page *page = GetFrame(frame_id);
+    page->pin_count_++;
+    if (ring == nullptr) {
+      DrainAccessLog();
+      replacer_->RecordAccess(frame_id);
+    }
+    return page;
+  }
+  frame_id = ring == nullptr ? TryToFindFreePage() : TryToFindRingFrame(ring, page_id);
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  Page *page = GetFrame(frame_id);
+  LoadPage(frame_id, db_id, page_id);
+  // Ring frames stay out of the replacer until the ring lets them go.
+  if (ring == nullptr) {
+    replacer_->RecordAccess(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+  page->pin_count_ = 1;
+  return page;
+}
+
+page_id_t BufferPoolManagerInstance::PrefetchPage(db_id_t db_id, page_id_t page_id, BufferRing *ring,
+                                                  const NextPageFunc &next_page, bool *loaded) {
+  // A single page goes through the same reservation as a batched read-ahead, so the read runs without the latch.
+  IoBatch reads;
+  auto frames = StartPrefetch(db_id, {page_id}, ring, reads);
+  *loaded = false;
+  if (!frames.empty()) {
+    DiskManager::SubmitBatch(reads);
+    reads.Wait();
+    *loaded = FinishPrefetch(db_id, frames, ring) > 0;
+  }
+  scoped_lock<mutex> lock(latch_);
+  frame_id_t frame_id = page_table_.Find(db_id, page_id);
+  if (!next_page || frame_id == INVALID_FRAME_ID) {
+    return INVALID_PAGE_ID;
+  }
+  // The latch keeps the frame from being evicted while the link is read, and the page read latch keeps a writer from
+  // changing it meanwhile. Waiting for a writer here could deadlock with it missing on another page, so a page being
+  // written ends the chain instead.
+  Page *page = GetFrame(frame_id);
+  if (!page->TryRLatch()) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t next_page_id = next_page(page);
+  page->RUnlatch();
+  return next_page_id;
+}
+
+vector<pair<frame_id_t, page_id_t>> BufferPoolManagerInstance::StartPrefetch(db_id_t db_id,
+                                                                             const vector<page_id_t> &page_ids,
+                                                                             BufferRing *ring, IoBatch &reads) {
+  vector<pair<frame_id_t, page_id_t>> frames;
+  IoBatch write_backs;
+  scoped_lock<mutex> lock(latch_);
+  for (auto page_id : page_ids) {
+    if (page_table_.Find(db_id, page_id) != INVALID_FRAME_ID ||
+        any_of(frames.begin(), frames.end(), [page_id](auto &frame) { return frame.second == page_id; })) {
+      continue;
+    }
+    frame_id_t frame_id =
+        ring == nullptr ? TryToFindFreePage(&write_backs) : TryToFindRingFrame(ring, page_id, &write_backs);
+    if (frame_id == INVALID_FRAME_ID) {
+      break;
+    }
+    // The frame stays locked, and holding no page it cannot be mistaken for one by a lock-free lookup.
+    GetFrame(frame_id)->page_id_ = INVALID_PAGE_ID;
+    frames.emplace_back(frame_id, page_id);
+  }
+  // Evicted pages are no longer in the page table, their writes must land before another thread can miss on them.
+  WriteBatch(write_backs);
+  for (auto &frame : frames) {
+    if (SetFrameData(frame.first, db_id, frame.second)) {
+      disk_managers_[db_id]->AddRead(reads, frame.second, GetFrame(frame.first)->GetData());
+    }
+  }
+  return frames;
+}
+
+size_t BufferPoolManagerInstance::FinishPrefetch(db_id_t db_id, const vector<pair<frame_id_t, page_id_t>> &frames,
+                                                 BufferRing *ring) {
+  size_t loaded = 0;
+  scoped_lock<mutex> lock(latch_);
+  for (auto [frame_id, page_id] : frames) {
+    if (page_table_.Find(db_id, page_id) != INVALID_FRAME_ID) {
+      free_list_.push_back(frame_id);
+      continue;
+    }
+    Page *page = GetFrame(frame_id);
+    page->page_id_ = page_id;
+    page->db_id_ = db_id;
+    page->is_dirty_ = false;
+    page->is_referenced_ = false;
+    page_table_.Insert(db_id, page_id, frame_id);
+    if (ring == nullptr) {
+      replacer_->RecordAccess(frame_id);
+      replacer_->Unpin(frame_id);
+    }
+    page->pin_count_ = 0;
+    loaded++;
+  }
+  return loaded;
+}
+
+Page *BufferPoolManagerInstance::NewPage(db_id_t db_id, page_id_t page_id) {
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  unique_lock<mutex> lock(latch_);
+  frame_id_t frame_id = page_table_.Find(db_id, page_id);
+  if (frame_id != INVALID_FRAME_ID) {
+    // Read-ahead may have loaded the page right before it was de-allocated, take over the stale frame.
+    int unpinned = 0;
+    if (!GetFrame(frame_id)->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+      return nullptr;
+    }
+    // the frame is locked, it keeps the page while latch_ is released
+    WaitForWrite(lock, GetFrame(frame_id));
+    replacer_->Remove(frame_id);
+    page_table_.Erase(db_id, page_id);
+  } else {
+    frame_id = TryToFindFreePage();
+  }
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  Page *page = GetFrame(frame_id);
+  page->data_ = GetFrameData(frame_id);
+  page->ResetMemory();
+  page->page_id_ = page_id;
+  page->db_id_ = db_id;
+  page->is_dirty_ = false;
+  page->is_referenced_ = false;
+  page_table_.Insert(db_id, page_id, frame_id);
+  replacer_->RecordAccess(frame_id);
+  replacer_->Unpin(frame_id);
+  page->pin_count_ = 1;
+  return page;
+}
+
+bool BufferPoolManagerInstance::DeletePage(db_id_t db_id, page_id_t page_id) {
+  // 1.   Search the page table for the requested page (P).
+  // 1.   If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  unique_lock<mutex> lock(latch_);
+  frame_id_t frame_id = page_table_.Find(db_id, page_id);
+  if (frame_id == INVALID_FRAME_ID) {
+    return true;
+  }
+  Page *page = GetFrame(frame_id);
+  int unpinned = 0;
+  if (!page->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+    return false;
+  }
+  WaitForWrite(lock, page);
+  replacer_->Remove(frame_id);
+  page_table_.Erase(db_id, page_id);
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->data_ = GetFrameData(frame_id);
+  page->ResetMemory();
+  free_list_.push_back(frame_id);
+  return true;
+}
+
+bool BufferPoolManagerInstance::UnpinPage(db_id_t db_id, page_id_t page_id, bool is_dirty) {
+  frame_id_t frame_id = page_table_.Find(db_id, page_id);
+  if (frame_id == INVALID_FRAME_ID) {
+    scoped_lock<mutex> lock(latch_);
+    frame_id = page_table_.Find(db_id, page_id);
+    if (frame_id == INVALID_FRAME_ID) {
+      return false;
+    }
+  }
+  // The caller holds a pin, so the frame cannot be evicted or deleted under our feet.
+  Page *page = GetFrame(frame_id);
+  if (!Holds(page, db_id, page_id)) {
+    return false;
+  }
+  // Mark dirty before dropping the pin, otherwise the page could be evicted without being written back.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  return true;
+}
+
+bool BufferPoolManagerInstance::FlushPage(db_id_t db_id, page_id_t page_id) {
+  unique_lock<mutex> lock(latch_);
+  frame_id_t frame_id;
+  // the page may have been evicted while latch_ was released, look it up again after a wait
+  do {
+    frame_id = page_table_.Find(db_id, page_id);
+    if (frame_id == INVALID_FRAME_ID) {
+      return false;
+    }
+  } while (WaitForWrite(lock, GetFrame(frame_id)));
+  WriteBack(GetFrame(frame_id));
+  return true;
+}
+
+size_t BufferPoolManagerInstance::BeginFlush(db_id_t db_id, const vector<page_id_t> *page_ids,
+                                             vector<PageFlush> &flushes) {
+  unique_lock<mutex> lock(latch_);
+  vector<frame_id_t> frame_ids;
+  do {
+    frame_ids.clear();
+    if (page_ids != nullptr) {
+      for (auto page_id : *page_ids) {
+        frame_id_t frame_id = page_table_.Find(db_id, page_id);
+        if (frame_id != INVALID_FRAME_ID) {
+          frame_ids.push_back(frame_id);
+        }
+      }
+    } else {
+      for (size_t i = 0; i < capacity_; i++) {
+        if (GetFrame(i)->GetPageId() != INVALID_PAGE_ID && GetFrame(i)->db_id_ == db_id) {
+          frame_ids.push_back(static_cast<frame_id_t>(i));
+        }
+      }
+    }
+  } while (WaitForWrites(lock, frame_ids));
+  for (auto frame_id : frame_ids) {
+    Page *page = GetFrame(frame_id);
+    if (page->IsDirty()) {
+      // Like a write of the page cleaner, the frame cannot be evicted, deleted or written again meanwhile.
+      page->is_writing_ = true;
+      page->is_dirty_ = false;
+      flushes.push_back({page->GetPageId(), page});
+    }
+  }
+  return frame_ids.size();
+}
+
+void BufferPoolManagerInstance::EndFlush(const vector<PageFlush> &flushes, LatencyRecorder::Clock::time_point start) {
+  if (flushes.empty()) {
+    return;
+  }
+  vector<Page *> pages;
+  for (auto &flush : flushes) {
+    pages.push_back(flush.page_);
+  }
+  FinishWrites(pages);
+  write_latency_.Record(start, flushes.size());
+  write_backs_.fetch_add(flushes.size(), std::memory_order_relaxed);
+}
+
+void BufferPoolManagerInstance::DropDatabase(db_id_t db_id) {
+  unique_lock<mutex> lock(latch_);
+  vector<frame_id_t> frame_ids;
+  do {
+    frame_ids.clear();
+    for (size_t i = 0; i < capacity_; i++) {
+      if (GetFrame(i)->GetPageId() != INVALID_PAGE_ID && GetFrame(i)->db_id_ == db_id) {
+        frame_ids.push_back(static_cast<frame_id_t>(i));
+      }
+    }
+  } while (WaitForWrites(lock, frame_ids));
+  WriteBackFrames(frame_ids);
+  for (auto i : frame_ids) {
+    Page *page = GetFrame(i);
+    page->pin_count_ = Page::LOCKED_PIN_COUNT;
+    replacer_->Remove(i);
+    page_table_.Erase(db_id, page->GetPageId());
+    page->page_id_ = INVALID_PAGE_ID;
+    // The mapping of a read-only database goes away with its disk manager.
+    page->data_ = GetFrameData(i);
+    free_list_.push_back(i);
+  }
+}
+
+size_t BufferPoolManagerInstance::CleanFrames(size_t clean_target) {
+  vector<tuple<db_id_t, page_id_t, frame_id_t>> writes;
+  {
+    scoped_lock<mutex> lock(latch_);
+    // Free frames are ready for a miss as well.
+    size_t clean = free_list_.size();
+    for (size_t i = 0; i < capacity_; i++) {
+      Page *page = GetFrame(i);
+      if (page->pin_count_ != 0 || page->is_referenced_ || page->is_writing_) {
+        continue;
+      }
+      if (page->IsDirty()) {
+        writes.emplace_back(page->db_id_, page->GetPageId(), i);
+      } else {
+        clean++;
+      }
+    }
+    if (clean >= clean_target) {
+      return 0;
+    }
+    sort(writes.begin(), writes.end());
+    writes.resize(min(writes.size(), clean_target - clean));
+    // Lock each frame while it is copied, hits fall back to the latched path and wait for the copy.
+    cleaner_buffer_.resize(writes.size() * PAGE_SIZE);
+    size_t copied = 0;
+    for (auto &write : writes) {
+      Page *page = GetFrame(get<2>(write));
+      int unpinned = 0;
+      if (!page->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+        continue;
+      }
+      page->is_writing_ = true;
+      page->is_dirty_ = false;
+      memcpy(&cleaner_buffer_[copied * PAGE_SIZE], page->GetData(), PAGE_SIZE);
+      page->pin_count_ = 0;
+      writes[copied++] = write;
+    }
+    writes.resize(copied);
+  }
+  // The frames cannot be evicted before their copy is on disk, or a fetch could read the old content back.
+  IoBatch batch;
+  vector<pair<page_id_t, const char *>> pages;
+  for (size_t i = 0; i < writes.size(); i++) {
+    auto [db_id, page_id, frame_id] = writes[i];
+    pages.emplace_back(page_id, &cleaner_buffer_[i * PAGE_SIZE]);
+    // the writes are sorted by database, adjacent pages of one database are merged
+    if (i + 1 == writes.size() || get<0>(writes[i + 1]) != db_id) {
+      disk_managers_[db_id]->AddWrites(batch, pages);
+      pages.clear();
+    }
+  }
+  WriteBatch(batch);
+  vector<Page *> written;
+  for (auto &write : writes) {
+    written.push_back(GetFrame(get<2>(write)));
+  }
+  FinishWrites(written);
+  return writes.size();
+}
+
+size_t BufferPoolManagerInstance::Resize(size_t pool_size) {
+  scoped_lock<mutex> lock(latch_);
+  if (pool_size >= pool_size_) {
+    // Bring retired frames back first, they may still have their data.
+    for (size_t i = 0; i < capacity_ && pool_size_ < pool_size; i++) {
+      if (retired_[i]) {
+        ReviveFrame(i);
+      }
+    }
+    if (pool_size_ < pool_size) {
+      AddFrames(pool_size - pool_size_);
+      // The replacer is sized for the frame ids, move the evictable frames over in their eviction order.
+      Replacer *replacer = Replacer::Create(replacer_type_, capacity_, lru_k_);
+      frame_id_t frame_id;
+      while (replacer_->Victim(&frame_id)) {
+        replacer->RecordAccess(frame_id);
+        replacer->Unpin(frame_id);
+      }
+      delete replacer_;
+      replacer_ = replacer;
+    }
+    return pool_size_;
+  }
+  // Give up free frames first, from the highest ids so that whole blocks can be released.
+  free_list_.sort();
+  while (pool_size_ > pool_size && !free_list_.empty()) {
+    RetireFrame(free_list_.back());
+    free_list_.pop_back();
+  }
+  // Then evict unpinned pages, pinned frames keep their page.
+  for (size_t i = capacity_; i-- > 0 && pool_size_ > pool_size;) {
+    Page *page = GetFrame(i);
+    int unpinned = 0;
+    if (retired_[i] || page->is_writing_ ||
+        !page->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+      continue;
+    }
+    replacer_->Remove(i);
+    page_table_.Erase(page->db_id_, page->GetPageId());
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+    if (page->IsDirty()) {
+      WriteBack(page);
+    }
+    RetireFrame(i);
+  }
+  return pool_size_;
+}
+
+frame_id_t BufferPoolManagerInstance::TryToFindFreePage(IoBatch *write_backs) {
+  frame_id_t frame_id;
+  if (!free_list_.empty()) {
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    return frame_id;
+  }
+  DrainAccessLog();
+  // Every resident frame is in the replacer. Skipped frames are only put back once the scan is over, so that the
+  // replacer offers its next candidate instead of the same one again. If the scan failed only because of reference
+  // bits, they are cleared by now and a second round finds a victim.
+  frame_id_t victim_id = INVALID_FRAME_ID;
+  for (int round = 0; round < 2 && victim_id == INVALID_FRAME_ID; round++) {
+    bool skipped_referenced = false;
+    while (victim_id == INVALID_FRAME_ID && replacer_->Victim(&frame_id)) {
+      Page *victim = GetFrame(frame_id);
+      if (victim->GetPinCount() != 0 || victim->is_writing_) {
+        rejected_.push_back(frame_id);
+      } else if (victim->is_referenced_.exchange(false)) {
+        replacer_->RecordAccess(frame_id);
+        rejected_.push_back(frame_id);
+        skipped_referenced = true;
+      } else {
+        int unpinned = 0;
+        if (victim->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+          victim_id = frame_id;
+        } else {
+          rejected_.push_back(frame_id);
+        }
+      }
+    }
+    for (auto rejected : rejected_) {
+      replacer_->Unpin(rejected);
+    }
+    rejected_.clear();
+    if (!skipped_referenced) {
+      break;
+    }
+  }
+  if (victim_id == INVALID_FRAME_ID) {
+    return INVALID_FRAME_ID;
+  }
+  Page *victim = GetFrame(victim_id);
+  replacer_->Remove(victim_id);
+  page_table_.Erase(victim->db_id_, victim->GetPageId());
+  evictions_.fetch_add(1, std::memory_order_relaxed);
+  if (victim->IsDirty()) {
+    dirty_evictions_++;
+    WriteBack(victim, write_backs);
+  }
+  return victim_id;
+}
+
+frame_id_t BufferPoolManagerInstance::TryToFindRingFrame(BufferRing *ring, page_id_t page_id,
+                                                         IoBatch *write_backs) {
+  if (ring->frames_.size() < ring->capacity_) {
+    frame_id_t frame_id = TryToFindFreePage(write_backs);
+    if (frame_id != INVALID_FRAME_ID) {
+      ring->frames_.emplace_back(frame_id, page_id);
+    }
+    return frame_id;
+  }
+  auto &slot = ring->frames_[ring->next_];
+  Page *page = GetFrame(slot.first);
+  int unpinned = 0;
+  bool owned = Holds(page, ring->db_id_, slot.second);
+  if (owned && !page->is_referenced_ && !page->is_writing_ &&
+      page->pin_count_.compare_exchange_strong(unpinned, Page::LOCKED_PIN_COUNT)) {
+    page_table_.Erase(ring->db_id_, slot.second);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+    if (page->IsDirty()) {
+      WriteBack(page, write_backs);
+    }
+    slot.second = page_id;
+    ring->next_ = (ring->next_ + 1) % ring->capacity_;
+    return slot.first;
+  }
+  // Somebody else is using the frame (or it was deleted and reused), the shared pool takes it over.
+  if (owned) {
+    replacer_->RecordAccess(slot.first);
+    replacer_->Unpin(slot.first);
+  }
+  frame_id_t frame_id = TryToFindFreePage(write_backs);
+  if (frame_id == INVALID_FRAME_ID) {
+    ring->frames_.erase(ring->frames_.begin() + ring->next_);
+    ring->next_ = 0;
+    return INVALID_FRAME_ID;
+  }
+  slot = {frame_id, page_id};
+  ring->next_ = (ring->next_ + 1) % ring->capacity_;
+  return frame_id;
+}
+
+void BufferPoolManagerInstance::ReleaseRing(BufferRing *ring) {
+  scoped_lock<mutex> lock(latch_);
+  for (auto &slot : ring->frames_) {
+    if (Holds(GetFrame(slot.first), ring->db_id_, slot.second)) {
+      replacer_->RecordAccess(slot.first);
+      replacer_->Unpin(slot.first);
+    }
+  }
+  ring->frames_.clear();
+  ring->next_ = 0;
+}
+
+void BufferPoolManagerInstance::DrainAccessLog() {
+  if (access_log_.Empty()) {
+    return;
+  }
+  access_log_.Drain([this](frame_id_t frame_id, page_id_t page_id) {
+    Page *page = GetFrame(frame_id);
+    if (page->GetPageId() == page_id && page->pin_count_ >= 0) {
+      page->is_referenced_ = false;
+      replacer_->RecordAccess(frame_id);
+    }
+  });
+}
+
+bool BufferPoolManagerInstance::TryPin(Page *page, db_id_t db_id, page_id_t page_id, bool mark_referenced) {
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The frame may have been recycled between the page table lookup and the pin.
+  if (!Holds(page, db_id, page_id)) {
+    page->pin_count_--;
+    return false;
+  }
+  if (mark_referenced && !page->is_referenced_.load(std::memory_order_relaxed)) {
+    page->is_referenced_ = true;
+  }
+  return true;
+}
+
+void BufferPoolManagerInstance::LoadPage(frame_id_t frame_id, db_id_t db_id, page_id_t page_id) {
+  Page *page = GetFrame(frame_id);
+  if (SetFrameData(frame_id, db_id, page_id)) {
+    auto start = LatencyRecorder::Clock::now();
+    disk_managers_[db_id]->ReadPage(page_id, page->GetData());
+    read_latency_.Record(start);
+  }
+  page->page_id_ = page_id;
+  page->db_id_ = db_id;
+  page->is_dirty_ = false;
+  page->is_referenced_ = false;
+  page_table_.Insert(db_id, page_id, frame_id);
+}
+
+bool BufferPoolManagerInstance::SetFrameData(frame_id_t frame_id, db_id_t db_id, page_id_t page_id) {
+  char *mapped = disk_managers_[db_id]->GetMappedPage(page_id);
+  GetFrame(frame_id)->data_ = mapped != nullptr ? mapped : GetFrameData(frame_id);
+  return mapped == nullptr;
+}
+
+void BufferPoolManagerInstance::AddFrames(size_t num_frames) {
+  size_t capacity = capacity_ + num_frames;
+  auto directory = make_unique<Page *[]>(capacity);
+  for (size_t i = 0; i < capacity_; i++) {
+    directory[i] = frames_[i].get();
+  }
+  FrameBlock block{static_cast<frame_id_t>(capacity_), num_frames, num_frames,
+                   unique_ptr<char[]>(new char[num_frames * PAGE_SIZE])};
+  for (size_t i = 0; i < num_frames; i++) {
+    frames_.emplace_back(new Page(&block.data_[i * PAGE_SIZE]));
+    frames_.back()->pin_count_ = Page::LOCKED_PIN_COUNT;
+    directory[capacity_ + i] = frames_.back().get();
+    frame_blocks_.push_back(blocks_.size());
+    retired_.push_back(false);
+    free_list_.emplace_back(capacity_ + i);
+  }
+  blocks_.push_back(std::move(block));
+  // Readers holding the old directory still find the same frames in it.
+  pages_.store(directory.get(), std::memory_order_release);
+  directories_.push_back(std::move(directory));
+  capacity_ = capacity;
+  pool_size_ += num_frames;
+  page_table_.Grow(capacity_);
+  rejected_.reserve(capacity_);
+}
+
+void BufferPoolManagerInstance::RetireFrame(frame_id_t frame_id) {
+  Page *page = GetFrame(frame_id);
+  page->pin_count_ = Page::LOCKED_PIN_COUNT;
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->is_referenced_ = false;
+  retired_[frame_id] = true;
+  pool_size_--;
+  FrameBlock &block = blocks_[frame_blocks_[frame_id]];
+  if (--block.active_ == 0) {
+    for (size_t i = 0; i < block.num_frames_; i++) {
+      GetFrame(block.first_frame_ + i)->data_ = nullptr;
+    }
+    block.data_.reset();
+  }
+}
+
+void BufferPoolManagerInstance::ReviveFrame(frame_id_t frame_id) {
+  FrameBlock &block = blocks_[frame_blocks_[frame_id]];
+  if (block.data_ == nullptr) {
+    block.data_.reset(new char[block.num_frames_ * PAGE_SIZE]);
+    for (size_t i = 0; i < block.num_frames_; i++) {
+      GetFrame(block.first_frame_ + i)->data_ = &block.data_[i * PAGE_SIZE];
+    }
+  }
+  block.active_++;
+  retired_[frame_id] = false;
+  pool_size_++;
+  free_list_.push_back(frame_id);
+}
+
+void BufferPoolManagerInstance::WriteBack(Page *page, IoBatch *batch) {
+  page->is_dirty_ = false;
+  if (batch != nullptr) {
+    disk_managers_[page->db_id_]->AddWrite(*batch, page->GetPageId(), page->GetData());
+    return;
+  }
+  auto start = LatencyRecorder::Clock::now();
+  disk_managers_[page->db_id_]->WritePage(page->GetPageId(), page->GetData());
+  write_latency_.Record(start);
+  write_backs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPoolManagerInstance::WriteBatch(IoBatch &batch) {
+  if (batch.Empty()) {
+    return;
+  }
+  auto start = LatencyRecorder::Clock::now();
+  DiskManager::SubmitBatch(batch);
+  batch.Wait();
+  // A write may carry several pages, every page of the batch waited for the whole batch.
+  size_t num_pages = 0;
+  for (auto &request : batch.GetRequests()) {
+    num_pages += request.len_ / PAGE_SIZE;
+  }
+  write_latency_.Record(start, num_pages);
+  write_backs_.fetch_add(num_pages, std::memory_order_relaxed);
+}
+
+size_t BufferPoolManagerInstance::WriteBackFrames(const vector<frame_id_t> &frame_ids) {
+  // dirty pages of each database the frames belong to
+  map<db_id_t, vector<pair<page_id_t, const char *>>> pages;
+  for (auto frame_id : frame_ids) {
+    Page *page = GetFrame(frame_id);
+    if (page->GetPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (page->IsDirty()) {
+      page->is_dirty_ = false;
+      pages[page->db_id_].emplace_back(page->GetPageId(), page->GetData());
+    }
+  }
+  IoBatch batch;
+  size_t num_pages = 0;
+  for (auto &[db_id, db_pages] : pages) {
+    num_pages += db_pages.size();
+    disk_managers_[db_id]->AddWrites(batch, db_pages);
+  }
+  WriteBatch(batch);
+  return num_pages;
+}
+
+bool BufferPoolManagerInstance::WaitForWrites(unique_lock<mutex> &lock, const vector<frame_id_t> &frame_ids) {
+  bool waited = false;
+  for (auto frame_id : frame_ids) {
+    waited |= WaitForWrite(lock, GetFrame(frame_id));
+  }
+  return waited;
+}
+
+void BufferPoolManagerInstance::FinishWrites(const vector<Page *> &pages) {
+  if (pages.empty()) {
+    return;
+  }
+  {
+    // cleared under latch_, so that a thread in WaitForWrite() cannot miss the wake-up
+    scoped_lock<mutex> lock(latch_);
+    for (auto page : pages) {
+      page->is_writing_ = false;
+    }
+  }
+  write_cv_.notify_all();
+}
+
+BufferPoolStats BufferPoolManagerInstance::GetStats() const {
+  BufferPoolStats stats;
+  stats.pool_size_ = pool_size_;
+  stats.hits_ = hits_.load(std::memory_order_relaxed);
+  stats.misses_ = misses_.load(std::memory_order_relaxed);
+  stats.evictions_ = evictions_.load(std::memory_order_relaxed);
+  stats.dirty_write_backs_ = write_backs_.load(std::memory_order_relaxed);
+  stats.pin_waits_ = pin_waits_.load(std::memory_order_relaxed);
+  stats.read_latency_ = read_latency_.Snapshot();
+  stats.write_latency_ = write_latency_.Snapshot();
+  return stats;
+}
+
+// Only used for debug
+bool BufferPoolManagerInstance::CheckAllUnpinned(db_id_t db_id) {
+  scoped_lock<mutex> lock(latch_);
+  bool res = true;
+  for (size_t i = 0; i < capacity_; i++) {
+    if (GetFrame(i)->db_id_ == db_id && GetFrame(i)->GetPinCount() != 0) {
+      res = false;
+      LOG(ERROR) << "page " << GetFrame(i)->GetPageId() << " pin count:" << GetFrame(i)->GetPinCount() << endl;
+    }
+  }
+  return res;
+}
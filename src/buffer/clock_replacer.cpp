@@ -0,0 +1,47 @@
+#include "buffer/clock_replacer.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages)
+    : capacity(num_pages), in_clock_(num_pages, false), ref_(num_pages, false) {}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  // Terminates within two sweeps: the first one clears every reference bit it passes.
+  while (true) {
+    size_t current = hand_;
+    hand_ = (hand_ + 1) % capacity;
+    if (!in_clock_[current]) {
+      continue;
+    }
+    if (ref_[current]) {
+      ref_[current] = false;
+      continue;
+    }
+    in_clock_[current] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+  if (in_clock_[frame_id]) {
+    in_clock_[frame_id] = false;
+    size_--;
+  }
+}
+
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+  if (!in_clock_[frame_id]) {
+    in_clock_[frame_id] = true;
+    ref_[frame_id] = true;
+    size_++;
+  }
+}
+
+size_t CLOCKReplacer::Size() { return size_; }
+
+void CLOCKReplacer::RecordAccess(frame_id_t frame_id) { ref_[frame_id] = true; }
@@ -0,0 +1,133 @@
+#include "buffer/lock_free_page_table.h"
+
+#include <vector>
+
+LockFreePageTable::Slots::Slots(size_t num_frames) {
+  capacity_ = 2;
+  while (capacity_ < num_frames * 2) {
+    capacity_ <<= 1;
+  }
+  mask_ = capacity_ - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+LockFreePageTable::LockFreePageTable(size_t num_frames) {
+  tables_.emplace_back(std::make_unique<Slots>(num_frames));
+  table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+frame_id_t LockFreePageTable::Find(db_id_t db_id, page_id_t page_id) const {
+  const Slots *table = table_.load(std::memory_order_acquire);
+  uint64_t key = Key(db_id, page_id);
+  for (size_t i = Hash(table, key), probes = 0; probes < table->capacity_; i = (i + 1) & table->mask_, probes++) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return INVALID_FRAME_ID;
+    }
+    if (slot != TOMBSTONE_SLOT && (slot & KEY_MASK) == key) {
+      return UnpackFrameId(slot);
+    }
+  }
+  return INVALID_FRAME_ID;
+}
+
+void LockFreePageTable::Insert(db_id_t db_id, page_id_t page_id, frame_id_t frame_id) {
+  ASSERT(page_id != INVALID_PAGE_ID, "Invalid page id for page table insert.");
+  ASSERT(static_cast<uint64_t>(frame_id) <= FRAME_MASK, "Frame id does not fit in a page table slot.");
+  Slots *table = table_.load(std::memory_order_relaxed);
+  if ((size_ + tombstones_ + 1) * 4 > table->capacity_ * 3) {
+    Rebuild();
+  }
+  InsertKey(table, Key(db_id, page_id), frame_id);
+}
+
+void LockFreePageTable::InsertKey(Slots *table, uint64_t key, frame_id_t frame_id) {
+  size_t i = Hash(table, key);
+  for (;; i = (i + 1) & table->mask_) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    if (slot == TOMBSTONE_SLOT) {
+      tombstones_--;
+      break;
+    }
+  }
+  table->slots_[i].store(Pack(key, frame_id), std::memory_order_release);
+  size_++;
+}
+
+bool LockFreePageTable::Erase(db_id_t db_id, page_id_t page_id) {
+  Slots *table = table_.load(std::memory_order_relaxed);
+  size_t mask = table->mask_;
+  uint64_t key = Key(db_id, page_id);
+  for (size_t i = Hash(table, key), probes = 0; probes < table->capacity_; i = (i + 1) & mask, probes++) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (slot == TOMBSTONE_SLOT || (slot & KEY_MASK) != key) {
+      continue;
+    }
+    size_--;
+    if (table->slots_[(i + 1) & mask].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+      // some probe chain may still run through this slot
+      table->slots_[i].store(TOMBSTONE_SLOT, std::memory_order_release);
+      tombstones_++;
+      return true;
+    }
+    // end of a chain, the slot and the tombstones right before it can become empty again
+    table->slots_[i].store(EMPTY_SLOT, std::memory_order_release);
+    for (size_t j = (i - 1) & mask; table->slots_[j].load(std::memory_order_relaxed) == TOMBSTONE_SLOT;
+         j = (j - 1) & mask) {
+      table->slots_[j].store(EMPTY_SLOT, std::memory_order_release);
+      tombstones_--;
+    }
+    return true;
+  }
+  return false;
+}
+
+void LockFreePageTable::Grow(size_t num_frames) {
+  if (num_frames * 2 <= table_.load(std::memory_order_relaxed)->capacity_) {
+    return;
+  }
+  std::vector<uint64_t> live = LiveSlots();
+  auto table = std::make_unique<Slots>(num_frames);
+  size_ = 0;
+  tombstones_ = 0;
+  for (auto slot : live) {
+    InsertKey(table.get(), slot & KEY_MASK, UnpackFrameId(slot));
+  }
+  table_.store(table.get(), std::memory_order_release);
+  tables_.push_back(std::move(table));
+}
+
+void LockFreePageTable::Rebuild() {
+  Slots *table = table_.load(std::memory_order_relaxed);
+  std::vector<uint64_t> live = LiveSlots();
+  for (size_t i = 0; i < table->capacity_; i++) {
+    table->slots_[i].store(EMPTY_SLOT, std::memory_order_release);
+  }
+  size_ = 0;
+  tombstones_ = 0;
+  for (auto slot : live) {
+    InsertKey(table, slot & KEY_MASK, UnpackFrameId(slot));
+  }
+}
+
+std::vector<uint64_t> LockFreePageTable::LiveSlots() const {
+  const Slots *table = table_.load(std::memory_order_relaxed);
+  std::vector<uint64_t> live;
+  live.reserve(size_);
+  for (size_t i = 0; i < table->capacity_; i++) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    if (slot != EMPTY_SLOT && slot != TOMBSTONE_SLOT) {
+      live.push_back(slot);
+    }
+  }
+  return live;
+}
@@ -0,0 +1,65 @@
+#include "buffer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : num_pages_(num_pages),
+      k_(k == 0 ? 1 : k),
+      history_(num_pages * k_, 0),
+      access_count_(num_pages, 0),
+      evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  frame_id_t victim = INVALID_FRAME_ID;
+  bool victim_infinite = false;
+  uint64_t victim_timestamp = 0;
+  for (size_t i = 0; i < num_pages_; i++) {
+    if (!evictable_[i]) {
+      continue;
+    }
+    // Frames below k accesses are compared by their first access, the others by their k-th most recent one, which
+    // is the slot the ring is about to overwrite.
+    bool infinite = access_count_[i] < k_;
+    uint64_t timestamp = infinite ? history_[i * k_] : history_[i * k_ + access_count_[i] % k_];
+    if (victim == INVALID_FRAME_ID || (infinite && !victim_infinite) ||
+        (infinite == victim_infinite && timestamp < victim_timestamp)) {
+      victim = static_cast<frame_id_t>(i);
+      victim_infinite = infinite;
+      victim_timestamp = timestamp;
+    }
+  }
+  evictable_[victim] = false;
+  size_--;
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  if (!evictable_[frame_id]) {
+    evictable_[frame_id] = true;
+    size_++;
+  }
+}
+
+size_t LRUKReplacer::Size() { return size_; }
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  history_[frame_id * k_ + access_count_[frame_id] % k_] = ++current_timestamp_;
+  access_count_[frame_id]++;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  Pin(frame_id);
+  access_count_[frame_id] = 0;
+  history_[frame_id * k_] = 0;
+}
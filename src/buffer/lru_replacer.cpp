@@ -1,49 +1,35 @@
 #include "buffer/lru_replacer.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages):cache(num_pages, v_list.end()){
-  num = num_pages;
-}
+LRUReplacer::LRUReplacer(size_t num_pages) : lru_list_(num_pages), num_pages_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-/**
- * TODO: Student Implement
- */
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  if(v_list.empty()){
+  if (lru_list_.Empty()) {
     return false;
   }
-  (*frame_id) = v_list.back();
-  cache[(*frame_id)] = v_list.end();
-  v_list.pop_back();
+  *frame_id = lru_list_.Back();
+  lru_list_.Remove(*frame_id);
   return true;
 }
 
-/**
- * TODO: Student Implement
- */
 void LRUReplacer::Pin(frame_id_t frame_id) {
-  auto it = cache[frame_id];
-  if(it != v_list.end()){
-    v_list.erase(it);
-    cache[frame_id] = v_list.end();
+  if (lru_list_.Contains(frame_id)) {
+    lru_list_.Remove(frame_id);
   }
 }
 
-/**
- * TODO: Student Implement
- */
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-  if(v_list.size() >= num || cache[frame_id] != v_list.end()){
+  if (lru_list_.Size() >= num_pages_ || lru_list_.Contains(frame_id)) {
     return;
   }
-  v_list.push_front(frame_id);
-  cache[frame_id] = v_list.begin();
+  lru_list_.PushFront(frame_id);
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id) {
+  if (lru_list_.Contains(frame_id)) {
+    lru_list_.MoveToFront(frame_id);
+  }
 }
 
-/**
- * TODO: Student Implement
- */
-size_t LRUReplacer::Size() {
-  return v_list.size();
-}
\ No newline at end of file
+size_t LRUReplacer::Size() { return lru_list_.Size(); }
@@ -0,0 +1,20 @@
+#include "buffer/replacer.h"
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+
+Replacer *Replacer::Create(ReplacerType type, size_t num_pages, size_t lru_k) {
+  switch (type) {
+    case ReplacerType::kClock:
+      return new CLOCKReplacer(num_pages);
+    case ReplacerType::kLRUK:
+      return new LRUKReplacer(num_pages, lru_k);
+    case ReplacerType::k2Q:
+      return new TwoQueueReplacer(num_pages);
+    case ReplacerType::kLRU:
+    default:
+      return new LRUReplacer(num_pages);
+  }
+}
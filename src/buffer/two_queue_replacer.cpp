@@ -0,0 +1,63 @@
+#include "buffer/two_queue_replacer.h"
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages)
+    : a1_threshold_(num_pages / 4), a1_list_(num_pages), am_list_(num_pages), queue_(num_pages, QueueType::kNone) {}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  FrameList *list = &a1_list_;
+  if (a1_list_.Empty() || (a1_list_.Size() <= a1_threshold_ && !am_list_.Empty())) {
+    list = &am_list_;
+  }
+  if (list->Empty()) {
+    return false;
+  }
+  *frame_id = list->Back();
+  list->Remove(*frame_id);
+  return true;
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  FrameList &list = ListOf(frame_id);
+  if (list.Contains(frame_id)) {
+    list.Remove(frame_id);
+  }
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  if (queue_[frame_id] == QueueType::kNone) {
+    queue_[frame_id] = QueueType::kA1;
+  }
+  FrameList &list = ListOf(frame_id);
+  if (!list.Contains(frame_id)) {
+    list.PushFront(frame_id);
+  }
+}
+
+size_t TwoQueueReplacer::Size() { return a1_list_.Size() + am_list_.Size(); }
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id) {
+  switch (queue_[frame_id]) {
+    case QueueType::kNone:
+      queue_[frame_id] = QueueType::kA1;
+      break;
+    case QueueType::kA1:
+      queue_[frame_id] = QueueType::kAm;
+      if (a1_list_.Contains(frame_id)) {
+        a1_list_.Remove(frame_id);
+        am_list_.PushFront(frame_id);
+      }
+      break;
+    case QueueType::kAm:
+      if (am_list_.Contains(frame_id)) {
+        am_list_.MoveToFront(frame_id);
+      }
+      break;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  Pin(frame_id);
+  queue_[frame_id] = QueueType::kNone;
+}
@@ -76,9 +76,10 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
     catalog_meta_ = CatalogMeta::NewInstance();
     FlushCatalogMetaPage();
   } else {
-    Page *page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-    catalog_meta_ = CatalogMeta::DeserializeFrom(page->GetData());
-    buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
+    {
+      ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(CATALOG_META_PAGE_ID);
+      catalog_meta_ = CatalogMeta::DeserializeFrom(guard.GetPage()->GetData());
+    }
     for(auto iter:catalog_meta_->table_meta_pages_){
       LoadTable(iter.first,iter.second);
     }
@@ -91,6 +92,14 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
 }
 
 CatalogManager::~CatalogManager() {
+  {
+    std::scoped_lock<std::mutex> lock(drop_latch_);
+    drop_stop_ = true;
+  }
+  drop_cv_.notify_all();
+  if (drop_thread_.joinable()) {
+    drop_thread_.join();
+  }
   FlushCatalogMetaPage();
   delete catalog_meta_;
   for (auto iter : tables_) {
@@ -106,6 +115,9 @@ CatalogManager::~CatalogManager() {
  */
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info) {
   // ASSERT(false, "Not Implemented yet");
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   if (table_names_.find(table_name) != table_names_.end()) {
     return DB_TABLE_ALREADY_EXIST;
   }
@@ -113,12 +125,12 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   //创建新表堆
   TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_);
   //创建新页面
-  auto page = buffer_pool_manager_->NewPage(meta_data_page_id);
+  BasicPageGuard page_guard = buffer_pool_manager_->NewPageGuarded(meta_data_page_id);
   page_id_t root_page_id = table_heap->GetFirstPageId();
   //创建新表元数据
   TableMetadata *table_metadata = TableMetadata::Create(next_table_id_, table_name, root_page_id, schema);
-  table_metadata->SerializeTo(page->GetData());
-  buffer_pool_manager_->UnpinPage(meta_data_page_id, true);
+  table_metadata->SerializeTo(page_guard.GetDataMut());
+  page_guard.Drop();
   //更新目录元信息
   catalog_meta_->table_meta_pages_.emplace(next_table_id_, meta_data_page_id);
   table_names_.emplace(table_name,next_table_id_);
@@ -128,9 +140,9 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   tables_.emplace(next_table_id_, table_info);
   next_table_id_++;
   //更新目录元数据页面
-  auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-  catalog_meta_->SerializeTo(catalog_meta_page->GetData());
-  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  WritePageGuard catalog_meta_guard = buffer_pool_manager_->FetchPageWrite(CATALOG_META_PAGE_ID);
+  catalog_meta_->SerializeTo(catalog_meta_guard.GetDataMut());
+  catalog_meta_guard.Drop();
   return DB_SUCCESS;
 }
 
@@ -165,6 +177,9 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
                                     const std::vector<std::string> &index_keys, Txn *txn, IndexInfo *&index_info,
                                     const string &index_type) {
   // ASSERT(false, "Not Implemented yet");
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   if(table_names_.find(table_name) == table_names_.end()){
     return DB_TABLE_NOT_EXIST;
   }
@@ -191,18 +206,18 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   }
   //创建新索引元数据页面
   page_id_t meta_data_page_id;
-  auto index_page = buffer_pool_manager_->NewPage(meta_data_page_id);
+  BasicPageGuard index_guard = buffer_pool_manager_->NewPageGuarded(meta_data_page_id);
   IndexMetadata *index_metadata = IndexMetadata::Create(next_index_id_, index_name, table_id, key_map);
-  index_metadata->SerializeTo(index_page->GetData());
-  buffer_pool_manager_->UnpinPage(meta_data_page_id, true);
+  index_metadata->SerializeTo(index_guard.GetDataMut());
+  index_guard.Drop();
   //初始化
   index_info = IndexInfo::Create();
   index_info->Init(index_metadata, tables_[table_id], buffer_pool_manager_);
   //更新目录元数据
   catalog_meta_->index_meta_pages_.emplace(next_index_id_, meta_data_page_id);
-  auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-  catalog_meta_->SerializeTo(catalog_meta_page->GetData());
-  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  WritePageGuard catalog_meta_guard = buffer_pool_manager_->FetchPageWrite(CATALOG_META_PAGE_ID);
+  catalog_meta_->SerializeTo(catalog_meta_guard.GetDataMut());
+  catalog_meta_guard.Drop();
   //更新索引映射名称
   if(index_names_.find(table_name) == index_names_.end()){
     std::unordered_map<std::string,index_id_t> new_index_names;
@@ -270,8 +285,11 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
 /**
  * TODO: Student Implement
  */
-dberr_t CatalogManager::DropTable(const string &table_name) {
+dberr_t CatalogManager::DropTable(const string &table_name, bool wait) {
   // ASSERT(false, "Not Implemented yet");
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   if(table_names_.find(table_name) == table_names_.end()){
     return DB_TABLE_NOT_EXIST;
   }
@@ -285,14 +303,75 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   }
   //删除表的元数据信息
   table_id_t table_id = table_names_[table_name];
+  TableInfo *table_info = tables_[table_id];
   table_names_.erase(table_name);
   tables_.erase(table_id);
-  auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
+  WritePageGuard catalog_meta_guard = buffer_pool_manager_->FetchPageWrite(CATALOG_META_PAGE_ID);
   buffer_pool_manager_->DeletePage(catalog_meta_->table_meta_pages_[table_id]);
   catalog_meta_->table_meta_pages_.erase(table_id);
-  catalog_meta_->SerializeTo(catalog_meta_page->GetData());
-  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  catalog_meta_->SerializeTo(catalog_meta_guard.GetDataMut());
+  catalog_meta_guard.Drop();
+  //释放表堆的页面，表已不在目录中，后台线程可以安全地释放
+  if (wait) {
+    table_info->GetTableHeap()->DeleteTable();
+    delete table_info;
+    return DB_SUCCESS;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(drop_latch_);
+    if (!drop_thread_.joinable()) {
+      drop_thread_ = std::thread(&CatalogManager::RunDrops, this);
+    }
+    drop_queue_.push_back(table_info);
+  }
+  drop_cv_.notify_one();
+  return DB_SUCCESS;
+}
+
+void CatalogManager::WaitForDrops() {
+  std::unique_lock<std::mutex> lock(drop_latch_);
+  drop_done_cv_.wait(lock, [this] { return drop_queue_.empty() && !drop_busy_; });
+}
 
+void CatalogManager::RunDrops() {
+  std::unique_lock<std::mutex> lock(drop_latch_);
+  while (true) {
+    drop_cv_.wait(lock, [this] { return drop_stop_ || !drop_queue_.empty(); });
+    // the tables still queued when the catalog goes away are freed before the thread stops
+    if (drop_queue_.empty()) {
+      return;
+    }
+    TableInfo *table_info = drop_queue_.front();
+    drop_queue_.pop_front();
+    drop_busy_ = true;
+    lock.unlock();
+    table_info->GetTableHeap()->DeleteTable();
+    delete table_info;
+    lock.lock();
+    drop_busy_ = false;
+    drop_done_cv_.notify_all();
+  }
+}
+
+dberr_t CatalogManager::VacuumTable(const string &table_name, Txn *txn, VacuumStats &stats) {
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
+  TableInfo *table_info = nullptr;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  Row key_row;
+  stats = table_info->GetTableHeap()->Vacuum(txn, [&](const RowView &view, const RowId &old_rid) {
+    for (auto index_info : indexes) {
+      // the key schema shares the columns of the table, only the key columns are read
+      view.Materialize(&key_row, index_info->GetIndexKeySchema(), nullptr);
+      index_info->GetIndex()->RemoveEntry(key_row, old_rid, txn);
+      index_info->GetIndex()->InsertEntry(key_row, view.GetRowId(), txn);
+    }
+  });
   return DB_SUCCESS;
 }
 
@@ -301,6 +380,9 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
  */
 dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_name) {
   // ASSERT(false, "Not Implemented yet");
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   if(index_names_.find(table_name) == index_names_.end()){
     return DB_TABLE_NOT_EXIST;
   }
@@ -310,13 +392,16 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   }
   //删除索引
   index_id_t index_id = table[index_name];
+  IndexInfo *index_info = indexes_[index_id];
   index_names_[table_name].erase(index_name);
   indexes_.erase(index_id);
-  auto catalog_meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
+  index_info->GetIndex()->Destroy();
+  delete index_info;
+  WritePageGuard catalog_meta_guard = buffer_pool_manager_->FetchPageWrite(CATALOG_META_PAGE_ID);
   buffer_pool_manager_->DeletePage(catalog_meta_->index_meta_pages_[index_id]);
   catalog_meta_->index_meta_pages_.erase(index_id);
-  catalog_meta_->SerializeTo(catalog_meta_page->GetData());
-  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  catalog_meta_->SerializeTo(catalog_meta_guard.GetDataMut());
+  catalog_meta_guard.Drop();
 
   return DB_SUCCESS;
 }
@@ -326,9 +411,13 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
  */
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
   // ASSERT(false, "Not Implemented yet");
-  auto meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-  catalog_meta_->SerializeTo(meta_page->GetData());
-  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(CATALOG_META_PAGE_ID);
+    catalog_meta_->SerializeTo(guard.GetDataMut());
+  }
   if (!buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID)) return DB_FAILED;
   return DB_SUCCESS;
 }
@@ -342,10 +431,11 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
     return DB_FAILED;
   }
   //加载表格元数据
-  auto page = buffer_pool_manager_->FetchPage(page_id);
   TableMetadata *table_metadata;
-  TableMetadata::DeserializeFrom(page->GetData(), table_metadata);
-  buffer_pool_manager_->UnpinPage(page_id, false);
+  {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id);
+    TableMetadata::DeserializeFrom(guard.GetPage()->GetData(), table_metadata);
+  }
   //创建表格实例
   TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_metadata->GetFirstPageId(), table_metadata->GetSchema(), log_manager_, lock_manager_);
   TableInfo *table_info = TableInfo::Create();
@@ -366,10 +456,11 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
     return DB_FAILED;
   }
   //加载索引元数据
-  auto page = buffer_pool_manager_->FetchPage(page_id);
   IndexMetadata *index_metadata;
-  IndexMetadata::DeserializeFrom(page->GetData(), index_metadata);
-  buffer_pool_manager_->UnpinPage(page_id, false);
+  {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id);
+    IndexMetadata::DeserializeFrom(guard.GetPage()->GetData(), index_metadata);
+  }
   //创建索引信息
   IndexInfo *index_info = IndexInfo::Create();
   index_info->Init(index_metadata, tables_[index_metadata->GetTableId()], buffer_pool_manager_);
@@ -3,7 +3,8 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances, ReplacerType replacer_type, uint32_t lru_k)
     : db_file_name_(std::move(db_name)), init_(init) {
   // Init database file if needed
   db_file_name_ = "./databases/" + db_file_name_;
@@ -12,10 +13,51 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
   }
   // Initialize components
   disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, buffer_pool_instances, replacer_type, lru_k);
+  Open();
+}
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, BufferPool *buffer_pool)
+    : db_file_name_(std::move(db_name)), init_(init) {
+  db_file_name_ = "./databases/" + db_file_name_;
+  if (init_) {
+    remove(db_file_name_.c_str());
+  }
+  disk_mgr_ = new DiskManager(db_file_name_);
+  bpm_ = new BufferPoolManager(buffer_pool, disk_mgr_);
+  Open();
+}
 
+DBStorageEngine::DBStorageEngine(std::string db_file_name, DiskManager *disk_mgr, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances)
+    : disk_mgr_(disk_mgr), db_file_name_(std::move(db_file_name)), init_(false) {
+  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, buffer_pool_instances);
+  Open();
+}
+
+DBStorageEngine::DBStorageEngine(std::string db_file_name, DiskManager *disk_mgr, BufferPool *buffer_pool)
+    : disk_mgr_(disk_mgr), db_file_name_(std::move(db_file_name)), init_(false) {
+  bpm_ = new BufferPoolManager(buffer_pool, disk_mgr_);
+  Open();
+}
+
+std::unique_ptr<DBStorageEngine> DBStorageEngine::OpenReadOnly(std::string db_name, uint32_t buffer_pool_size,
+                                                               uint32_t buffer_pool_instances) {
+  std::string db_file_name = "./databases/" + db_name;
+  auto *disk_mgr = new DiskManager(db_file_name, true);
+  return std::unique_ptr<DBStorageEngine>(
+      new DBStorageEngine(std::move(db_file_name), disk_mgr, buffer_pool_size, buffer_pool_instances));
+}
+
+std::unique_ptr<DBStorageEngine> DBStorageEngine::OpenReadOnly(std::string db_name, BufferPool *buffer_pool) {
+  std::string db_file_name = "./databases/" + db_name;
+  auto *disk_mgr = new DiskManager(db_file_name, true);
+  return std::unique_ptr<DBStorageEngine>(new DBStorageEngine(std::move(db_file_name), disk_mgr, buffer_pool));
+}
+
+void DBStorageEngine::Open() {
   // Allocate static page for db storage engine
-  if (init) {
+  if (init_) {
     page_id_t id;
     if (!bpm_->IsPageFree(CATALOG_META_PAGE_ID)) {
       throw logic_error("Catalog meta page not free.");
@@ -23,22 +65,23 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
     if (!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID)) {
       throw logic_error("Header page not free.");
     }
-    if (bpm_->NewPage(id) == nullptr || id != CATALOG_META_PAGE_ID) {
+    BasicPageGuard catalog_meta_guard = bpm_->NewPageGuarded(id);
+    if (!catalog_meta_guard || id != CATALOG_META_PAGE_ID) {
       throw logic_error("Failed to allocate catalog meta page.");
     }
-    if (bpm_->NewPage(id) == nullptr || id != INDEX_ROOTS_PAGE_ID) {
+    BasicPageGuard index_roots_guard = bpm_->NewPageGuarded(id);
+    if (!index_roots_guard || id != INDEX_ROOTS_PAGE_ID) {
       throw logic_error("Failed to allocate header page.");
     }
     if (bpm_->IsPageFree(CATALOG_META_PAGE_ID) || bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID)) {
       exit(1);
     }
-    bpm_->UnpinPage(CATALOG_META_PAGE_ID, false);
-    bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
   } else {
     ASSERT(!bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Invalid catalog meta page.");
     ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
   }
-  catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
+  catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init_);
+  bpm_->StartCleaner();
 }
 
 DBStorageEngine::~DBStorageEngine() {
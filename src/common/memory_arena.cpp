@@ -0,0 +1,27 @@
+#include "common/memory_arena.h"
+
+void *MemoryArena::AllocateSlow(size_t size, size_t align) {
+  allocated_bytes_ += size;
+  if (size + align > block_size_ / 4) {
+    large_blocks_.emplace_back(new char[size + align]);
+    auto begin = (reinterpret_cast<uintptr_t>(large_blocks_.back().get()) + align - 1) & ~(align - 1);
+    return reinterpret_cast<void *>(begin);
+  }
+  blocks_.emplace_back(new char[block_size_]);
+  ptr_ = blocks_.back().get();
+  end_ = ptr_ + block_size_;
+  auto begin = (reinterpret_cast<uintptr_t>(ptr_) + align - 1) & ~(align - 1);
+  ptr_ = reinterpret_cast<char *>(begin + size);
+  return reinterpret_cast<void *>(begin);
+}
+
+void MemoryArena::Reset() {
+  allocated_bytes_ = 0;
+  large_blocks_.clear();
+  if (blocks_.empty()) {
+    return;
+  }
+  blocks_.resize(1);
+  ptr_ = blocks_.front().get();
+  end_ = ptr_ + block_size_;
+}
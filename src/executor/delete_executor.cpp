@@ -16,13 +16,15 @@ void DeleteExecutor::Init() {
 }
 
 bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  if (child_executor_->Next(row, rid)) {
+  // The row of the scan is only valid until the next one is asked for, so it is not handed up.
+  Row src_row;
+  if (child_executor_->Next(&src_row, rid)) {
     if (!table_info_->GetTableHeap()->MarkDelete(*rid, txn_)) {
       return false;
     }
     Row key_row;
     for (auto info : index_info_) {  // 更新索引
-      row->GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+      src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
       info->GetIndex()->RemoveEntry(key_row, *rid, txn_);
     }
     return true;
@@ -4,7 +4,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
+#include <fstream>
 
 #include "common/result_writer.h"
 #include "executor/executors/delete_executor.h"
@@ -26,7 +28,9 @@ int yyparse(void);
 #include "parser/parser.h"
 }
 
-ExecuteEngine::ExecuteEngine() {
+ExecuteEngine::ExecuteEngine(size_t buffer_pool_size, ReplacerType replacer_type, size_t lru_k)
+    : buffer_pool_(
+          std::make_unique<BufferPool>(buffer_pool_size, DEFAULT_BUFFER_POOL_INSTANCES, replacer_type, lru_k)) {
   char path[] = "./databases";
   DIR *dir;
   if ((dir = opendir(path)) == nullptr) {
@@ -40,32 +44,34 @@ ExecuteEngine::ExecuteEngine() {
         strcmp( stdir->d_name , "..") == 0 ||
         stdir->d_name[0] == '.')
       continue;
-    dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+    // opened on first use
+    dbs_[stdir->d_name] = nullptr;
   }
   closedir(dir);
 }
 
 std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *exec_ctx,
-                                                                const AbstractPlanNodeRef &plan) {
+                                                                const AbstractPlanNodeRef &plan, bool keep_rows) {
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()), keep_rows);
     }
     // Create a new index scan executor
     case PlanType::IndexScan: {
-      return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()));
+      return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()),
+                                                 keep_rows);
     }
     // Create a new update executor
     case PlanType::Update: {
       auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan.get());
-      auto child_executor = CreateExecutor(exec_ctx, update_plan->GetChildPlan());
+      auto child_executor = CreateExecutor(exec_ctx, update_plan->GetChildPlan(), false);
       return std::make_unique<UpdateExecutor>(exec_ctx, update_plan, std::move(child_executor));
     }
       // Create a new delete executor
     case PlanType::Delete: {
       auto delete_plan = dynamic_cast<const DeletePlanNode *>(plan.get());
-      auto child_executor = CreateExecutor(exec_ctx, delete_plan->GetChildPlan());
+      auto child_executor = CreateExecutor(exec_ctx, delete_plan->GetChildPlan(), false);
       return std::make_unique<DeleteExecutor>(exec_ctx, delete_plan, std::move(child_executor));
     }
     case PlanType::Insert: {
@@ -92,7 +98,7 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
     Row row{};
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
-        result_set->push_back(row);
+        result_set->push_back(std::move(row));
       }
     }
   } catch (const exception &ex) {
@@ -143,9 +149,18 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeSetVariable:
+      return ExecuteSetVariable(ast, context.get());
+    case kNodeShowStatus:
+      return ExecuteShowStatus(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
     default:
       break;
   }
+  if (context != nullptr && context->GetBufferPoolManager()->IsReadOnly() && ast->type_ != kNodeSelect) {
+    return DB_READ_ONLY;
+  }
   // Plan the query.
   Planner planner(context.get());
   std::vector<Row> result_set{};
@@ -237,6 +252,9 @@ void ExecuteEngine::ExecuteInformation(dberr_t result) {
     case DB_KEY_NOT_FOUND:
       cout << "Key not exists." << endl;
       break;
+    case DB_READ_ONLY:
+      cout << "Database is read-only." << endl;
+      break;
     case DB_QUIT:
       cout << "Bye." << endl;
       break;
@@ -253,7 +271,7 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   if (dbs_.find(db_name) != dbs_.end()) {
     return DB_ALREADY_EXIST;
   }
-  dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true)));
+  dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true, buffer_pool_.get())));
   return DB_SUCCESS;
 }
 
@@ -265,8 +283,8 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   if (dbs_.find(db_name) == dbs_.end()) {
     return DB_NOT_EXIST;
   }
-  remove(("./databases/" + db_name).c_str());
   delete dbs_[db_name];
+  remove(("./databases/" + db_name).c_str());
   dbs_.erase(db_name);
   if (db_name == current_db_)
     current_db_ = "";
@@ -304,7 +322,29 @@ dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *conte
   LOG(INFO) << "ExecuteUseDatabase" << std::endl;
 #endif
   string db_name = ast->child_->val_;
-  if (dbs_.find(db_name) != dbs_.end()) {
+  // USE ... READONLY maps the file and refuses every change, a database is reopened when the mode changes
+  bool read_only = ast->val_ != nullptr && strcmp(ast->val_, "readonly") == 0;
+  auto iter = dbs_.find(db_name);
+  if (iter != dbs_.end()) {
+    if (iter->second != nullptr && iter->second->bpm_->IsReadOnly() != read_only) {
+      delete iter->second;
+      iter->second = nullptr;
+    }
+    if (iter->second == nullptr) {
+      try {
+        if (read_only) {
+          iter->second = DBStorageEngine::OpenReadOnly(db_name, buffer_pool_.get()).release();
+        } else {
+          iter->second = new DBStorageEngine(db_name, false, buffer_pool_.get());
+        }
+      } catch (const exception &ex) {
+        cout << "Failed to open database " << db_name << ": " << ex.what() << endl;
+        if (current_db_ == db_name) {
+          current_db_ = "";
+        }
+        return DB_FAILED;
+      }
+    }
     current_db_ = db_name;
     cout << "Database changed" << endl;
     return DB_SUCCESS;
@@ -471,7 +511,8 @@ dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context
         return DB_FAILED;
     }
 
-    dberr_t err = context->GetCatalog()->DropTable(table_name);
+    // The pages of the table are freed in the background, the table is gone from the catalog already.
+    dberr_t err = context->GetCatalog()->DropTable(table_name, false);
     if (err != DB_SUCCESS) {
         return err;
     }
@@ -564,14 +605,15 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
         return err;
     }
 
-    // get original field
+    // get original field, the table iterator reads through a ring buffer so the backfill keeps the pool intact
     auto row_begin = tableInfo->GetTableHeap()->Begin(context->GetTransaction());
     auto row_end = tableInfo->GetTableHeap()->End();
     for (auto row_iter = row_begin; row_iter != row_end; row_iter++) {
-      auto rid = (*row_iter).GetRowId();
+      const Row &row = *row_iter;
+      auto rid = row.GetRowId();
       vector<Field> fields;
       for (auto col : indexInfo->GetIndexKeySchema()->GetColumns()) {
-            fields.push_back(*(*row_iter).GetField(col->GetTableInd()));
+            fields.push_back(*row.GetField(col->GetTableInd()));
       }
       Row row_index(fields);
       err = indexInfo->GetIndex()->InsertEntry(row_index, rid, context->GetTransaction());
@@ -717,3 +759,130 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
     dbs_.clear();
  return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteSetVariable(pSyntaxNode ast, [[maybe_unused]] ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSetVariable" << std::endl;
+#endif
+  string name = ast->child_->val_;
+  string value = ast->child_->next_->val_;
+  if (name != "buffer_pool_size") {
+    cout << "Unknown variable " << name << endl;
+    return DB_FAILED;
+  }
+  char *end;
+  long long pool_size = strtoll(value.c_str(), &end, 10);
+  if (*end != '\0' || pool_size <= 0) {
+    cout << "Invalid buffer_pool_size " << value << endl;
+    return DB_FAILED;
+  }
+  // Every open database shares the pool, so they all get the new budget.
+  size_t new_size = buffer_pool_->Resize(pool_size);
+  cout << "Buffer pool resized to " << new_size << " pages";
+  if (new_size != static_cast<size_t>(pool_size)) {
+    cout << " (requested " << pool_size << ")";
+  }
+  cout << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteShowStatus([[maybe_unused]] pSyntaxNode ast, [[maybe_unused]] ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowStatus" << std::endl;
+#endif
+  auto print_table = [](const vector<string> &header, const vector<vector<string>> &rows) {
+    vector<int> data_width;
+    for (const auto &cell : header) {
+      data_width.push_back(cell.length());
+    }
+    for (const auto &row : rows) {
+      for (size_t i = 0; i < row.size(); i++) {
+        data_width[i] = max(data_width[i], int(row[i].length()));
+      }
+    }
+    ResultWriter writer(cout);
+    writer.Divider(data_width);
+    writer.BeginRow();
+    for (size_t i = 0; i < header.size(); i++) {
+      writer.WriteHeaderCell(header[i], data_width[i]);
+    }
+    writer.EndRow();
+    writer.Divider(data_width);
+    for (const auto &row : rows) {
+      writer.BeginRow();
+      for (size_t i = 0; i < row.size(); i++) {
+        writer.WriteCell(row[i], data_width[i]);
+      }
+      writer.EndRow();
+    }
+    writer.Divider(data_width);
+  };
+  auto ratio = [](double value) {
+    stringstream ss;
+    ss << fixed << setprecision(4) << value;
+    return ss.str();
+  };
+  BufferPoolStats stats = buffer_pool_->GetStats();
+  CleanerStats cleaner = buffer_pool_->GetCleanerStats();
+  print_table({"Variable_name", "Value"},
+              {{"Buffer_pool_size", to_string(stats.pool_size_)},
+               {"Buffer_pool_instances", to_string(buffer_pool_->GetNumInstances())},
+               {"Buffer_pool_hits", to_string(stats.hits_)},
+               {"Buffer_pool_misses", to_string(stats.misses_)},
+               {"Buffer_pool_hit_ratio", ratio(stats.HitRatio())},
+               {"Buffer_pool_evictions", to_string(stats.evictions_)},
+               {"Buffer_pool_dirty_write_backs", to_string(stats.dirty_write_backs_)},
+               {"Buffer_pool_pin_waits", to_string(stats.pin_waits_)},
+               {"Buffer_pool_prefetched_pages", to_string(buffer_pool_->GetPrefetchedPages())},
+               {"Buffer_pool_cleaner_pages", to_string(cleaner.pages_cleaned_)},
+               {"Page_reads", to_string(stats.read_latency_.count_)},
+               {"Page_read_avg_us", ratio(stats.read_latency_.Mean())},
+               {"Page_read_p99_us", to_string(stats.read_latency_.Percentile(0.99))},
+               {"Page_writes", to_string(stats.write_latency_.count_)},
+               {"Page_write_avg_us", ratio(stats.write_latency_.Mean())},
+               {"Page_write_p99_us", to_string(stats.write_latency_.Percentile(0.99))}});
+  vector<vector<string>> shards;
+  auto instance_stats = buffer_pool_->GetInstanceStats();
+  for (size_t i = 0; i < instance_stats.size(); i++) {
+    const auto &shard = instance_stats[i];
+    shards.push_back({to_string(i), to_string(shard.pool_size_), to_string(shard.hits_), to_string(shard.misses_),
+                      to_string(shard.evictions_), to_string(shard.dirty_write_backs_), to_string(shard.pin_waits_)});
+  }
+  print_table({"Shard", "Frames", "Hits", "Misses", "Evictions", "Write_backs", "Pin_waits"}, shards);
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    cout << "No database selected" << endl;
+    return DB_FAILED;
+  }
+  vector<string> table_names;
+  if (ast->child_ != nullptr) {
+    table_names.emplace_back(ast->child_->val_);
+  } else {
+    vector<TableInfo *> tables;
+    context->GetCatalog()->GetTables(tables);
+    for (auto table_info : tables) {
+      table_names.push_back(table_info->GetTableName());
+    }
+  }
+  for (const auto &table_name : table_names) {
+    VacuumStats stats;
+    dberr_t err = context->GetCatalog()->VacuumTable(table_name, context->GetTransaction(), stats);
+    if (err != DB_SUCCESS) {
+      return err;
+    }
+    cout << "Table " << table_name << " vacuumed: " << stats.purged_tuples_ << " deleted tuples purged, "
+         << stats.moved_tuples_ << " tuples moved, " << stats.freed_pages_ << " pages freed, "
+         << stats.relocated_pages_ << " pages relocated" << endl;
+  }
+  // Dropped tables give their pages back before the end of the file is cut off.
+  context->GetCatalog()->WaitForDrops();
+  size_t truncated = dbs_[current_db_]->bpm_->Truncate();
+  cout << "Database file truncated by " << truncated << " pages" << endl;
+  return DB_SUCCESS;
+}
@@ -5,8 +5,8 @@ class RowidCompare {
   bool operator()(RowId rid1, RowId rid2) { return rid1.Get() < rid2.Get(); }
 };
 
-IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx), plan_(plan) {}
+IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan, bool keep_rows)
+    : AbstractExecutor(exec_ctx), plan_(plan), arena_(keep_rows ? exec_ctx->GetArena() : &row_arena_) {}
 
 void IndexScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
@@ -32,18 +32,6 @@ bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *ou
   return true;
 }
 
-void IndexScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
-                                      Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
-  }
-  *output_row = Row(dest_row);
-}
-
 vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
   switch (predicate->GetType()) {
     case ExpressionType::LogicExpression: {
@@ -84,24 +72,29 @@ vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
 
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
+  if (arena_ == &row_arena_) {
+    row_arena_.Reset();
+  }
+  // Rows are filtered in their page, which is kept while the following row ids point into it.
+  ReadPageGuard guard;
+  RowView view;
   while (cursor_ < result_.size()) {
-    auto p_row = new Row(result_[cursor_]);
-    table_info_->GetTableHeap()->GetTuple(p_row, nullptr);
+    if (!table_info_->GetTableHeap()->GetTupleView(result_[cursor_], guard, &view)) {
+      cursor_++;
+      continue;
+    }
     if (plan_->need_filter_) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
+      if (predicate->EvaluatePredicate(view) != CmpBool::kTrue) {
         cursor_++;
-        delete p_row;
         continue;
       }
     }
     *rid = result_[cursor_];
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, plan_->OutputSchema(), p_row, row);
+      view.Materialize(row, plan_->OutputSchema(), arena_);
     } else {
-      *row = *p_row;
+      view.Materialize(row, arena_);
     }
-    delete p_row;
     cursor_++;
     return true;
   }
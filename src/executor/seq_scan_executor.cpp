@@ -3,11 +3,12 @@
 //
 #include "executor/executors/seq_scan_executor.h"
 
-SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
+SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan, bool keep_rows)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       iterator_(nullptr, RowId(INVALID_PAGE_ID, 0), nullptr),
-      is_schema_same_(false) {}
+      is_schema_same_(false),
+      arena_(keep_rows ? exec_ctx->GetArena() : &row_arena_) {}
 
 bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
   auto table_columns = table_schema->GetColumns();
@@ -26,18 +27,6 @@ bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *outp
   return true;
 }
 
-void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
-                                    Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
-  }
-  *output_row = Row(dest_row);
-}
-
 void SeqScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
   auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
@@ -48,23 +37,28 @@ void SeqScanExecutor::Init() {
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
+  if (arena_ == &row_arena_) {
+    row_arena_.Reset();
+  }
+  // Rows are filtered in their page, only the one returned is copied out.
   while (iterator_ != table_info_->GetTableHeap()->End()) {
-    auto p_row = &(*iterator_);
+    const RowView &view = iterator_.View();
     if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        iterator_++;
+      if (predicate->EvaluatePredicate(view) != CmpBool::kTrue) {
+        ++iterator_;
         continue;
       }
     }
-    *rid = iterator_->GetRowId();
+    *rid = view.GetRowId();
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, schema_, p_row, row);
+      view.Materialize(row, schema_, arena_);
     } else {
-      *row = *p_row;
+      view.Materialize(row, arena_);
     }
-    iterator_++;
+    ++iterator_;
+    iterator_.Release();
     return true;
   }
+  iterator_.Release();
   return false;
 }
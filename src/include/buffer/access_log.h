@@ -0,0 +1,67 @@
+#ifndef MINISQL_ACCESS_LOG_H
+#define MINISQL_ACCESS_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * AccessLog collects the buffer hits of the lock-free hit path, so that the replacer learns about them without the
+ * hit path taking the instance latch. A hit is appended with one atomic increment, and the holder of the latch
+ * replays the log into the replacer in the order of the hits. A hit that finds the log full is dropped, the reference
+ * bit of its frame still tells the eviction scan about it. No hit is replayed twice.
+ */
+class AccessLog {
+ public:
+  AccessLog() {
+    for (auto &slot : slots_) {
+      slot.store(EMPTY, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Log a hit on the page held by a frame.
+   * @return whether the log is half full and should be drained
+   */
+  inline bool Add(frame_id_t frame_id, page_id_t page_id) {
+    size_t index = tail_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= SIZE) {
+      return true;
+    }
+    slots_[index].store(Pack(frame_id, page_id), std::memory_order_release);
+    return index + 1 >= SIZE / 2;
+  }
+
+  /** @return whether no hit is waiting to be replayed */
+  inline bool Empty() const { return tail_.load(std::memory_order_relaxed) == 0; }
+
+  /**
+   * Hand the logged hits to apply(frame_id, page_id), oldest first. Called by one thread at a time. A hit whose slot
+   * is still being written is replayed by a later drain, or dropped.
+   */
+  template <class Apply>
+  void Drain(Apply &&apply) {
+    size_t end = std::min(tail_.exchange(0, std::memory_order_acq_rel), SIZE);
+    for (size_t i = 0; i < end; i++) {
+      uint64_t entry = slots_[i].exchange(EMPTY, std::memory_order_acquire);
+      if (entry != EMPTY) {
+        apply(static_cast<frame_id_t>(static_cast<uint32_t>(entry)), static_cast<page_id_t>(entry >> 32));
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t SIZE = DEFAULT_ACCESS_LOG_SIZE;
+  static constexpr uint64_t EMPTY = UINT64_MAX;
+
+  static inline uint64_t Pack(frame_id_t frame_id, page_id_t page_id) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32 | static_cast<uint32_t>(frame_id);
+  }
+
+  std::atomic<uint64_t> slots_[SIZE];  // hits packed as page id and frame id, EMPTY once replayed
+  std::atomic<size_t> tail_{0};        // slots handed out since the last drain
+};
+
+#endif  // MINISQL_ACCESS_LOG_H
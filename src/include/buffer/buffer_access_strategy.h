@@ -0,0 +1,55 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+using namespace std;
+
+class BufferPoolManager;
+
+/**
+ * BufferRing is the private set of frames a bulk reader recycles inside one buffer pool instance. Its frames are kept
+ * out of the replacer, so pages loaded through the ring never push other pages out of the shared part of the pool.
+ */
+struct BufferRing {
+  BufferRing(size_t capacity, db_id_t db_id) : capacity_(capacity), db_id_(db_id) { frames_.reserve(capacity); }
+
+  size_t capacity_;                             // maximum number of frames in the ring
+  db_id_t db_id_;                               // database of the pages loaded through the ring
+  size_t next_{0};                              // next frame to recycle once the ring is full
+  vector<pair<frame_id_t, page_id_t>> frames_;  // frames of the ring with the page each one was loaded with
+};
+
+/**
+ * BufferAccessStrategy lets a bulk reader (sequential scans, index backfill, dropping a table) go through the buffer
+ * pool without flushing out the working set of everybody else. Pages the reader misses on are loaded into a small
+ * ring of frames which is recycled once full. A ring frame that somebody else pinned or referenced in the meantime is
+ * handed over to the shared pool and replaced in the ring. Pages that are already resident are used in place.
+ *
+ * A strategy belongs to one reader at a time, the buffer pool's read-ahead thread may load pages into its rings on the
+ * reader's behalf. Its frames are given back to the shared pool when it is destroyed.
+ */
+class BufferAccessStrategy {
+ public:
+  /**
+   * @param ring_size number of frames of the ring, spread over the buffer pool instances
+   */
+  explicit BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, size_t ring_size = DEFAULT_BUFFER_RING_SIZE);
+
+  ~BufferAccessStrategy();
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /** @return the ring used inside the given buffer pool instance */
+  inline BufferRing *GetRing(size_t instance_index) { return &rings_[instance_index]; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  vector<BufferRing> rings_;  // one ring per buffer pool instance
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
@@ -0,0 +1,205 @@
+#ifndef MINISQL_BUFFER_POOL_H
+#define MINISQL_BUFFER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * Counters of the background page cleaner.
+ */
+struct CleanerStats {
+  uint64_t rounds_{0};           // rounds run by the cleaner thread
+  uint64_t pages_cleaned_{0};    // dirty pages written back by the cleaner thread
+  uint64_t dirty_evictions_{0};  // dirty victims that a fetching thread had to write back itself
+};
+
+/**
+ * A read-ahead request waiting for the I/O thread: either a list of pages, or a chain of pages that is followed from
+ * its first page.
+ */
+struct PrefetchRequest {
+  db_id_t db_id_{0};                          // database the pages belong to
+  vector<page_id_t> page_ids_;                // pages to load, or the first page of the chain
+  size_t chain_length_{0};                    // number of chained pages to load, 0 if page_ids_ is a plain list
+  NextPageFunc next_page_;                    // reads the link to the next page of the chain
+  shared_ptr<BufferAccessStrategy> strategy_;  // strategy of the reader the pages are loaded for, may be null
+};
+
+/**
+ * BufferPool holds the frames of the buffer pool, split into independent BufferPoolManagerInstance shards, together
+ * with the background page cleaner and the read-ahead I/O thread. Several databases can share one pool: each one
+ * attaches its disk manager and gets a database id, and pages are identified by (database id, page id). A database
+ * uses the pool through its own BufferPoolManager, so the memory of all open databases is bounded by one budget.
+ */
+class BufferPool {
+ public:
+  /**
+   * @param pool_size number of frames shared by all the databases, i.e. the memory budget in pages
+   */
+  explicit BufferPool(size_t pool_size, size_t num_instances = 1, ReplacerType replacer_type = ReplacerType::kLRU,
+                      size_t lru_k = DEFAULT_LRU_K);
+
+  ~BufferPool();
+
+  DISALLOW_COPY_AND_MOVE(BufferPool);
+
+  /**
+   * Register the disk manager of a database.
+   * @return the id of the database inside the pool
+   */
+  db_id_t AttachDatabase(DiskManager *disk_manager);
+
+  /**
+   * Write back and drop every page of a database, then forget its disk manager. Pending read-ahead requests of the
+   * database are dropped.
+   */
+  void DetachDatabase(db_id_t db_id);
+
+  Page *FetchPage(db_id_t db_id, page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  bool UnpinPage(db_id_t db_id, page_id_t page_id, bool is_dirty);
+
+  bool FlushPage(db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Bring a page allocated on disk by the caller into the pool.
+   */
+  Page *NewPage(db_id_t db_id, page_id_t page_id);
+
+  bool DeletePage(db_id_t db_id, page_id_t page_id);
+
+  /** See BufferPoolManager::PrefetchPages(). */
+  void PrefetchPages(db_id_t db_id, const vector<page_id_t> &page_ids, shared_ptr<BufferAccessStrategy> strategy);
+
+  /** See BufferPoolManager::PrefetchChain(). */
+  void PrefetchChain(db_id_t db_id, page_id_t first_page_id, size_t num_pages, NextPageFunc next_page,
+                     shared_ptr<BufferAccessStrategy> strategy);
+
+  /** @return number of pages read from disk by the I/O thread */
+  inline uint64_t GetPrefetchedPages() const { return prefetched_pages_; }
+
+  /**
+   * Give the frames of a strategy back to the shared part of the pool.
+   */
+  void ReleaseStrategy(BufferAccessStrategy *strategy);
+
+  /**
+   * Write back every dirty page of a database. The dirty pages of all the instances are written as one batch, sorted
+   * by their place in the file, with runs of adjacent pages merged into single writes.
+   */
+  void FlushAllPages(db_id_t db_id);
+
+  /**
+   * Write back the pages of a list that are dirty, the same way as FlushAllPages().
+   * @return number of pages of the list that are resident
+   */
+  size_t FlushPages(db_id_t db_id, const vector<page_id_t> &page_ids);
+
+  /** See BufferPoolManager::StartCleaner(). */
+  void StartCleaner(size_t clean_target, uint32_t interval_ms);
+
+  void StopCleaner();
+
+  CleanerStats GetCleanerStats();
+
+  /** @return the counters of every instance, indexed like the instances */
+  vector<BufferPoolStats> GetInstanceStats();
+
+  /** @return the counters of the pool, summed over the instances */
+  BufferPoolStats GetStats();
+
+  bool CheckAllUnpinned(db_id_t db_id);
+
+  /**
+   * Grow or shrink the pool to pool_size frames while it is in use, spread over the instances like at construction.
+   * Pinned pages are never moved or dropped, so a shrink may stop short of pool_size.
+   * @return the number of frames of the pool after the resize
+   */
+  size_t Resize(size_t pool_size);
+
+  inline size_t GetPoolSize() const { return pool_size_; }
+
+  inline size_t GetNumInstances() const { return instances_.size(); }
+
+ private:
+  /**
+   * Main loop of the page cleaner thread.
+   */
+  void RunCleaner(size_t clean_target, uint32_t interval_ms);
+
+  /**
+   * Queue a read-ahead request, the I/O thread is started by the first one.
+   */
+  void SubmitPrefetch(PrefetchRequest &&request);
+
+  /**
+   * Main loop of the I/O thread serving read-ahead requests.
+   */
+  void RunPrefetcher();
+
+  /** @return the ring a read-ahead request loads the pages of an instance into, null if it has no strategy */
+  static inline BufferRing *GetRing(const PrefetchRequest &request, size_t instance_index) {
+    return request.strategy_ == nullptr ? nullptr : request.strategy_->GetRing(instance_index);
+  }
+
+  /**
+   * Stop the I/O thread and drop the requests it did not get to, called by the destructor.
+   */
+  void StopPrefetcher();
+
+  /**
+   * Flush the dirty pages of a database, or only those of a list, see FlushAllPages().
+   * @return number of the pages that are resident
+   */
+  size_t Flush(db_id_t db_id, const vector<page_id_t> *page_ids);
+
+  /**
+   * @return the index of the instance responsible for the page, the pages of database 0 are spread by page id alone
+   */
+  inline size_t GetInstanceIndex(db_id_t db_id, page_id_t page_id) const {
+    return (static_cast<size_t>(db_id) * 0x9E3779B1 + static_cast<uint32_t>(page_id)) % instances_.size();
+  }
+
+  /**
+   * @return the instance responsible for the page
+   */
+  inline BufferPoolManagerInstance *GetInstance(db_id_t db_id, page_id_t page_id) {
+    return instances_[GetInstanceIndex(db_id, page_id)];
+  }
+
+ private:
+  atomic<size_t> pool_size_;                       // number of pages in all instances
+  mutex resize_latch_;                             // serializes resizes of the pool
+  vector<DiskManager *> disk_managers_;            // disk manager of each attached database, indexed by database id
+  mutex databases_latch_;                          // protects disk_managers_ against concurrent attach and detach
+  vector<BufferPoolManagerInstance *> instances_;  // shards of the buffer pool
+  thread cleaner_thread_;                          // background page cleaner, not running by default
+  mutex cleaner_latch_;                            // protects cleaner_stop_
+  condition_variable cleaner_cv_;                  // wakes the cleaner up when it has to stop
+  bool cleaner_stop_{false};
+  atomic<uint64_t> cleaner_rounds_{0};
+  atomic<uint64_t> cleaner_pages_{0};
+  thread prefetch_thread_;                         // I/O thread serving read-ahead, started on demand
+  mutex prefetch_latch_;                           // protects the prefetch state below
+  condition_variable prefetch_cv_;                 // wakes the I/O thread up for a new request or to stop
+  condition_variable prefetch_done_cv_;            // signals that the I/O thread finished a request
+  deque<PrefetchRequest> prefetch_queue_;          // pending read-ahead requests
+  bool prefetch_busy_{false};                      // whether the I/O thread is serving a request
+  db_id_t prefetch_db_id_{0};                      // database of the request being served
+  bool prefetch_stop_{false};
+  atomic<uint64_t> prefetched_pages_{0};
+};
+
+#endif  // MINISQL_BUFFER_POOL_H
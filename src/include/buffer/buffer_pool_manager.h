@@ -1,58 +1,211 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool.h"
+#include "buffer/page_guard.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * BufferPoolManager is the buffer pool as seen by one database: page ids are those of its disk manager and it
+ * allocates and de-allocates them on disk. The frames live in a BufferPool, which is split into independent shards,
+ * so concurrent sessions touching different pages never contend on the same page table, free list or replacer.
+ *
+ * A manager either owns a private BufferPool, or uses one shared by several databases so that all of them stay within
+ * a single memory budget.
+ */
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /**
+   * Create a manager with a private pool of pool_size frames.
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances = 1,
+                             ReplacerType replacer_type = ReplacerType::kLRU, size_t lru_k = DEFAULT_LRU_K);
+
+  /**
+   * Create a manager using a pool shared with other databases. The pool must outlive the manager.
+   */
+  explicit BufferPoolManager(BufferPool *buffer_pool, DiskManager *disk_manager);
 
+  /**
+   * Write back and drop the pages of the database, and destroy the pool if it is private.
+   */
   ~BufferPoolManager();
 
-  Page *FetchPage(page_id_t page_id);
+  DISALLOW_COPY_AND_MOVE(BufferPoolManager);
+
+  /**
+   * Fetch a page and pin it.
+   * @param strategy access strategy of a bulk reader, nullptr for a regular access
+   */
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
 
   bool UnpinPage(page_id_t page_id, bool is_dirty);
 
+  /**
+   * Fetch a page pinned by the returned guard, without latching it.
+   * @return the guard, empty if every frame is pinned
+   */
+  BasicPageGuard FetchPageBasic(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Fetch a page pinned and read latched by the returned guard.
+   * @return the guard, empty if every frame is pinned
+   */
+  ReadPageGuard FetchPageRead(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Fetch a page pinned and write latched by the returned guard.
+   * @return the guard, empty if every frame is pinned or the database is read-only
+   */
+  WritePageGuard FetchPageWrite(page_id_t page_id);
+
+  /**
+   * Allocate a page like NewPage(), the page is pinned by the returned guard and unpinned as dirty.
+   * @return the guard, empty if every frame is pinned
+   */
+  BasicPageGuard NewPageGuarded(page_id_t &page_id, const void *owner = nullptr);
+
   bool FlushPage(page_id_t page_id);
 
-  Page *NewPage(page_id_t &page_id);
+  /**
+   * Write back the pages of a list that are dirty, as a few large writes in file order rather than one FlushPage()
+   * each. Like FlushPage() it does not make the writes durable, see FlushAllPages().
+   * @return number of pages of the list that are resident
+   */
+  size_t FlushPages(const vector<page_id_t> &page_ids);
+
+  /**
+   * Allocate a page on disk and bring it into the pool zeroed and pinned.
+   * @param owner if set, the page comes from the run of contiguous pages reserved by this owner, see
+   * DiskManager::AllocatePage(const void *)
+   */
+  Page *NewPage(page_id_t &page_id, const void *owner = nullptr);
+
+  /**
+   * Give back the pages of an owner's run that it did not use, called when the owner is dropped.
+   */
+  void ReleaseExtent(const void *owner) { disk_manager_->ReleaseExtent(owner); }
 
+  /**
+   * @return false if the page is pinned or the database is read-only
+   */
   bool DeletePage(page_id_t page_id);
 
+  /**
+   * Delete a batch of pages, e.g. when a table or an index is dropped. The pages are taken out of the pool one by one,
+   * then de-allocated together with DiskManager::DeAllocatePages(). A page that is still pinned is skipped, nothing is
+   * deleted from a read-only database.
+   * @return the number of pages deleted
+   */
+  size_t DeletePages(const vector<page_id_t> &page_ids);
+
   bool IsPageFree(page_id_t page_id);
 
+  /**
+   * Ask the I/O thread to read pages ahead of a reader. The pages are loaded unpinned, so that the reader's FetchPage()
+   * calls are hits. Read-ahead is only a hint: requests are dropped while the queue is full and pages are skipped when
+   * no frame is available. All the pages of the list are read as one batch on the AsyncIoEngine.
+   * @param strategy access strategy of the reader, if set the pages are loaded into its rings
+   */
+  void PrefetchPages(const vector<page_id_t> &page_ids, shared_ptr<BufferAccessStrategy> strategy = nullptr);
+
+  /**
+   * Like PrefetchPages() for a chain of pages, e.g. the pages of a table heap or the leaves of a B+ tree, where the
+   * id of a page is only known once the page before it was read. The I/O thread follows the chain from
+   * first_page_id, pages that are already resident are only used to read the link.
+   * @param num_pages number of pages of the chain to load, including the first one
+   * @param next_page reads the id of the following page out of a page of the chain
+   */
+  void PrefetchChain(page_id_t first_page_id, size_t num_pages, NextPageFunc next_page,
+                     shared_ptr<BufferAccessStrategy> strategy = nullptr);
+
+  /** @return number of pages read from disk by the I/O thread of the pool */
+  inline uint64_t GetPrefetchedPages() const { return pool_->GetPrefetchedPages(); }
+
+  /**
+   * Give the frames of a strategy back to the shared pool, called when the strategy is destroyed.
+   */
+  void ReleaseStrategy(BufferAccessStrategy *strategy);
+
+  /**
+   * Write back every dirty page of the database and fsync the file, this is the durability point of the database.
+   */
+  void FlushAllPages();
+
+  /**
+   * Write back every dirty page of the database, then cut the free pages at the end of its file off.
+   * @return the number of pages the file shrank by
+   */
+  size_t Truncate();
+
+  /**
+   * Start the background page cleaner of the pool, if it is not running yet. Every interval it writes back dirty
+   * frames that are next in line for eviction, in page id order, so that every instance keeps clean_target clean
+   * frames for the fetching threads to take.
+   */
+  void StartCleaner(size_t clean_target = DEFAULT_CLEANER_CLEAN_TARGET,
+                    uint32_t interval_ms = DEFAULT_CLEANER_INTERVAL_MS);
+
+  /**
+   * Stop the background page cleaner of the pool and wait for its current round.
+   */
+  void StopCleaner();
+
+  CleanerStats GetCleanerStats();
+
+  /**
+   * @return the counters of the pool, summed over its instances. A shared pool counts the accesses of every database
+   * using it.
+   */
+  BufferPoolStats GetStats();
+
+  /** @return false if a page of the database is still pinned */
   bool CheckAllUnpinned();
 
+  /**
+   * Grow or shrink the pool, see BufferPool::Resize(). A shared pool changes for every database using it.
+   * @return the number of frames of the pool after the resize
+   */
+  size_t Resize(size_t pool_size);
+
+  /** @return number of frames of the pool, shared with the other databases using it */
+  inline size_t GetPoolSize() const { return pool_->GetPoolSize(); }
+
+  inline size_t GetNumInstances() const { return pool_->GetNumInstances(); }
+
+  /**
+   * @return whether the database was opened read-only. Its pages point into a mapping that cannot be written, so
+   * callers have to refuse a change before they touch a page, see DBStorageEngine::OpenReadOnly()
+   */
+  inline bool IsReadOnly() const { return disk_manager_->IsReadOnly(); }
+
+  /** @return id of the database inside the pool */
+  inline db_id_t GetDatabaseId() const { return db_id_; }
+
  private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(const void *owner = nullptr);
 
   /**
    * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
    */
   void DeallocatePage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
-
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  BufferPool *pool_;           // frames of the pool, private or shared
+  bool owns_pool_;             // whether pool_ is private and destroyed with the manager
+  DiskManager *disk_manager_;  // pointer to the disk manager.
+  db_id_t db_id_;              // id of the database inside pool_
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
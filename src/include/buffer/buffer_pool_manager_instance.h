@@ -0,0 +1,343 @@
+#ifndef MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+#define MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "buffer/access_log.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/lock_free_page_table.h"
+#include "buffer/replacer.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * Reads the id of the page following a page in a chain (table heap pages, B+ tree leaves) out of the page.
+ * @return the next page id, INVALID_PAGE_ID at the end of the chain
+ */
+using NextPageFunc = function<page_id_t(Page *page)>;
+
+/**
+ * A dirty page handed out by BufferPoolManagerInstance::BeginFlush(), written by the caller.
+ */
+struct PageFlush {
+  page_id_t page_id_;
+  Page *page_;
+};
+
+/**
+ * BufferPoolManagerInstance is one shard of the buffer pool. It owns an array of frames together with its own page
+ * table, free list and replacer. Page ids are never allocated here, the owning BufferPoolManager allocates them
+ * on disk and the BufferPool routes every page to exactly one instance. Frames are shared by all the databases of the
+ * pool, so pages are identified by their database id and page id, and each database has its own disk manager.
+ *
+ * Buffer hits and unpins do not take the instance latch: the page table supports lock-free lookups and pin counts are
+ * atomic. A frame is pinned with a CAS that fails while its pin count is negative, which is how the latched miss path
+ * (eviction, loading, deletion) keeps readers away from a frame it is changing. Since pins do not reach the replacer,
+ * it keeps every resident frame and the eviction scan skips pinned frames. Hits are appended to a lock-free AccessLog
+ * instead, which the latch holder replays into the replacer before it looks for a victim, so that every policy orders
+ * frames by their real accesses. Only a hit the log had to drop is left to the reference bit of its frame, which gets
+ * the frame a second chance.
+ *
+ * The instance can be resized online. Frames are allocated in blocks and reached through a directory that is replaced
+ * when the instance grows, so lock-free readers never see a frame move. Shrinking retires frames instead of freeing
+ * them: a retired frame is locked and holds no page, and the data of a block is released once all of its frames are
+ * retired.
+ *
+ * Pages of a read-only database are not copied into their frame: the frame's data points into the mapping of the
+ * file for as long as it holds the page, and is pointed back at the frame's own block when the frame is reused.
+ */
+class BufferPoolManagerInstance {
+ public:
+  /**
+   * @param disk_managers disk manager of every database, indexed by database id and owned by the BufferPool
+   */
+  explicit BufferPoolManagerInstance(size_t pool_size, DiskManager *const *disk_managers,
+                                     ReplacerType replacer_type = ReplacerType::kLRU, size_t lru_k = DEFAULT_LRU_K);
+
+  ~BufferPoolManagerInstance();
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolManagerInstance);
+
+  /**
+   * Fetch a page and pin it.
+   * @param ring if not null, a miss loads the page into this ring instead of a frame of the shared pool and a hit
+   * does not count as a reference for the replacer
+   * @return the pinned page, nullptr if every frame is pinned
+   */
+  Page *FetchPage(db_id_t db_id, page_id_t page_id, BufferRing *ring = nullptr);
+
+  bool UnpinPage(db_id_t db_id, page_id_t page_id, bool is_dirty);
+
+  bool FlushPage(db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Start the flush of the dirty pages of a database: each page is marked clean and as being written, which keeps it
+   * in its frame, and added to flushes. The caller writes the pages and then calls EndFlush(). This lets BufferPool
+   * write the pages of all the instances as one batch, sorted and coalesced, since adjacent pages live in different
+   * instances.
+   * @param page_ids if not null, only the pages of this list, otherwise all the pages of the database
+   * @return number of those pages that are resident
+   */
+  size_t BeginFlush(db_id_t db_id, const vector<page_id_t> *page_ids, vector<PageFlush> &flushes);
+
+  /**
+   * The pages handed out by BeginFlush() are on disk, they can be evicted again.
+   * @param start when the writes were submitted
+   */
+  void EndFlush(const vector<PageFlush> &flushes, LatencyRecorder::Clock::time_point start);
+
+  /**
+   * Write back and drop every page of a database, called before its disk manager goes away. Pages still pinned are
+   * dropped as well.
+   */
+  void DropDatabase(db_id_t db_id);
+
+  /**
+   * One round of the page cleaner: write back dirty frames that are unpinned and unreferenced, i.e. next in line for
+   * eviction, in page id order until clean_target of them are clean. Free frames count as clean. The pages are copied
+   * under the latch and written without it, so foreground misses are not held up by the writes.
+   * @return number of pages written
+   */
+  size_t CleanFrames(size_t clean_target);
+
+  /** @return number of victims that were dirty and had to be written back by the fetching thread */
+  inline uint64_t GetDirtyEvictions() const { return dirty_evictions_; }
+
+  /**
+   * @return a snapshot of the counters of the instance, read without the latch so that monitoring never holds up
+   * the fetching threads; counters updated while the snapshot is taken may or may not be included
+   */
+  BufferPoolStats GetStats() const;
+
+  /**
+   * Read-ahead: load a page and leave it unpinned, so that a later FetchPage() is a hit. Nothing is read if the page
+   * is already resident. Unlike FetchPage() the page is never pinned, so read-ahead cannot make DeletePage() fail. The
+   * read runs without the latch through StartPrefetch() and FinishPrefetch(), and next_page is called with the page
+   * read latch held; a page whose latch is taken by a writer ends the chain.
+   * @param ring if not null, the page is loaded into this ring like FetchPage() would
+   * @param next_page if set, used to read the id of the page following this one in its chain
+   * @param[out] loaded whether the page was read from disk
+   * @return the page id returned by next_page, INVALID_PAGE_ID if there is none or no frame was available
+   */
+  page_id_t PrefetchPage(db_id_t db_id, page_id_t page_id, BufferRing *ring, const NextPageFunc &next_page,
+                         bool *loaded);
+
+  /**
+   * First half of a batched read-ahead: reserve a frame for each page of page_ids that is not resident and add the
+   * read of the page to reads. Dirty victims are written back as one batch before this returns. The reserved frames
+   * stay locked and hold no page, so the reads can run without the latch; FinishPrefetch() maps them once reads
+   * has completed.
+   * @param ring if not null, the pages are loaded into this ring like FetchPage() would
+   * @return the reserved frames together with the page each one is loading
+   */
+  vector<pair<frame_id_t, page_id_t>> StartPrefetch(db_id_t db_id, const vector<page_id_t> &page_ids,
+                                                    BufferRing *ring, IoBatch &reads);
+
+  /**
+   * Second half of a batched read-ahead: map the pages read into the frames reserved by StartPrefetch() and leave them
+   * unpinned. A page that another thread loaded in the meantime keeps its frame, the reserved one is freed.
+   * @return number of pages that were mapped
+   */
+  size_t FinishPrefetch(db_id_t db_id, const vector<pair<frame_id_t, page_id_t>> &frames, BufferRing *ring);
+
+  /**
+   * Bring a freshly allocated page into the pool.
+   * @param page_id page id already allocated on disk by the caller
+   * @return the zeroed and pinned page, nullptr if every frame is pinned
+   */
+  Page *NewPage(db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Drop a page from the pool, the caller is responsible for de-allocating it on disk.
+   * @return false if the page is still pinned
+   */
+  bool DeletePage(db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Hand the frames of a ring over to the shared pool.
+   */
+  void ReleaseRing(BufferRing *ring);
+
+  /** @return false if a page of the database is still pinned */
+  bool CheckAllUnpinned(db_id_t db_id);
+
+  /**
+   * Grow or shrink the instance to pool_size frames. Shrinking writes back and drops unpinned pages, free frames go
+   * first; pinned frames keep their page and stay in place, so a shrink can stop short of pool_size.
+   * @return the number of frames of the instance after the resize
+   */
+  size_t Resize(size_t pool_size);
+
+  inline size_t GetPoolSize() const { return pool_size_; }
+
+ private:
+  /**
+   * Frames allocated together by the constructor or a resize. Their data is one allocation, which is released once
+   * every frame of the block is retired.
+   */
+  struct FrameBlock {
+    frame_id_t first_frame_;   // id of the first frame of the block
+    size_t num_frames_;        // number of frames of the block
+    size_t active_;            // frames of the block that are not retired
+    unique_ptr<char[]> data_;  // page data of the frames, null while every frame is retired
+  };
+
+  /** @return the frame with the given id, safe without the latch since frames never move */
+  inline Page *GetFrame(frame_id_t frame_id) const { return pages_.load(std::memory_order_acquire)[frame_id]; }
+
+  /**
+   * @return the memory of the block set aside for a frame. Must be called with latch_ held.
+   */
+  inline char *GetFrameData(frame_id_t frame_id) const {
+    const FrameBlock &block = blocks_[frame_blocks_[frame_id]];
+    return &block.data_[(frame_id - block.first_frame_) * PAGE_SIZE];
+  }
+
+  /**
+   * Point the data of a frame locked by the caller at the page it is about to hold: into the mapping of the file if
+   * the database is read-only and the page is mapped, into its own block otherwise. Must be called with latch_ held.
+   * @return false if the page is mapped and needs no read
+   */
+  bool SetFrameData(frame_id_t frame_id, db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Add num_frames new frames in a new block. Must be called with latch_ held.
+   */
+  void AddFrames(size_t num_frames);
+
+  /**
+   * Take a frame out of service, its page must already be dropped. Must be called with latch_ held.
+   */
+  void RetireFrame(frame_id_t frame_id);
+
+  /**
+   * Put a retired frame back into the free list. Must be called with latch_ held.
+   */
+  void ReviveFrame(frame_id_t frame_id);
+
+  /**
+   * Pick a frame from the free list first, then from the replacer. A dirty victim is written back and removed from
+   * the page table. Must be called with latch_ held.
+   * @param write_backs if not null, the write of a dirty victim is added to this batch instead, and the caller must
+   * complete the batch before it releases the latch or reuses the frame
+   * @return frame id, INVALID_FRAME_ID if every frame is pinned
+   */
+  frame_id_t TryToFindFreePage(IoBatch *write_backs = nullptr);
+
+  /**
+   * Pick the frame a ring loads its next page into: a frame of the ring that nobody else used since the ring loaded
+   * it, otherwise a frame from TryToFindFreePage() that joins the ring. Must be called with latch_ held.
+   * @param write_backs see TryToFindFreePage()
+   * @return frame id, INVALID_FRAME_ID if every frame is pinned
+   */
+  frame_id_t TryToFindRingFrame(BufferRing *ring, page_id_t page_id, IoBatch *write_backs = nullptr);
+
+  /**
+   * Replay the hits logged by the lock-free hit path into the replacer. Hits on frames that hold another page by now
+   * are dropped. Must be called with latch_ held.
+   */
+  void DrainAccessLog();
+
+  /**
+   * Pin a frame found by a lock-free page table lookup without taking the latch.
+   * @param mark_referenced whether the access should count as a reference for the replacer
+   * @return false if the frame is locked by the pool or no longer holds the page
+   */
+  bool TryPin(Page *page, db_id_t db_id, page_id_t page_id, bool mark_referenced);
+
+  /** @return whether a frame holds the given page */
+  static inline bool Holds(Page *page, db_id_t db_id, page_id_t page_id) {
+    return page->GetPageId() == page_id && page->db_id_ == db_id;
+  }
+
+  /**
+   * Read a page into a frame locked by the caller and map it. Must be called with latch_ held.
+   */
+  void LoadPage(frame_id_t frame_id, db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Write a frame back to the disk of its database and mark it clean.
+   * @param batch if not null, the write is only added to this batch
+   */
+  void WriteBack(Page *page, IoBatch *batch = nullptr);
+
+  /**
+   * Submit a batch of writes added by WriteBack() and wait for it.
+   */
+  void WriteBatch(IoBatch &batch);
+
+  /**
+   * Write back the dirty frames of a list and mark them clean, sorted by their place in the file with adjacent pages
+   * merged (DiskManager::AddWrites()). Clean frames are not written. Called with latch_ held and none of the frames
+   * being written, see WaitForWrites().
+   * @return number of pages written
+   */
+  size_t WriteBackFrames(const vector<frame_id_t> &frame_ids);
+
+  /**
+   * Wait until the page cleaner or a flush has finished writing a frame. Called with latch_ held through lock, which
+   * keeps a new write of the frame from starting once it returns. latch_ is released while waiting, so unless the
+   * caller locked the frame, the frame may hold another page afterwards.
+   * @return whether it had to wait
+   */
+  inline bool WaitForWrite(unique_lock<mutex> &lock, Page *page) {
+    if (!page->is_writing_) {
+      return false;
+    }
+    pin_waits_.fetch_add(1, std::memory_order_relaxed);
+    write_cv_.wait(lock, [page] { return !page->is_writing_; });
+    return true;
+  }
+
+  /**
+   * WaitForWrite() for every frame of a list. The frames may hold other pages afterwards, callers collect them again
+   * until it returns false.
+   * @return whether it had to wait
+   */
+  bool WaitForWrites(unique_lock<mutex> &lock, const vector<frame_id_t> &frame_ids);
+
+  /**
+   * Clear the writing flag of frames whose write is done, and wake up the threads waiting in WaitForWrite().
+   */
+  void FinishWrites(const vector<Page *> &pages);
+
+ private:
+  atomic<size_t> pool_size_;                         // number of frames in service in this instance
+  size_t capacity_{0};                               // number of frame ids, including retired frames
+  atomic<Page **> pages_{nullptr};                   // directory of the frames, indexed by frame id
+  vector<unique_ptr<Page *[]>> directories_;         // current and replaced directories, readers may still use one
+  vector<unique_ptr<Page>> frames_;                  // every frame ever allocated, indexed by frame id
+  vector<FrameBlock> blocks_;                        // blocks the frames were allocated in
+  vector<size_t> frame_blocks_;                      // index in blocks_ of the block of each frame
+  vector<bool> retired_;                             // whether each frame is out of service
+  DiskManager *const *disk_managers_;                // disk manager of each database, indexed by database id
+  LockFreePageTable page_table_;                     // to keep track of pages
+  ReplacerType replacer_type_;                       // policy of replacer_, kept to rebuild it when growing
+  size_t lru_k_;
+  Replacer *replacer_;                               // to find an unpinned page for replacement
+  list<frame_id_t> free_list_;                       // to find a free page for replacement
+  vector<frame_id_t> rejected_;                      // frames skipped by the current eviction scan
+  AccessLog access_log_;                             // hits the replacer has not been told about yet
+  vector<char> cleaner_buffer_;                      // page copies written by the page cleaner
+  atomic<uint64_t> dirty_evictions_{0};              // dirty victims written back by a fetching thread
+  atomic<uint64_t> hits_{0};                         // see BufferPoolStats for the counters
+  atomic<uint64_t> misses_{0};
+  atomic<uint64_t> evictions_{0};
+  atomic<uint64_t> write_backs_{0};
+  atomic<uint64_t> pin_waits_{0};
+  LatencyRecorder read_latency_;
+  LatencyRecorder write_latency_;
+  mutex latch_;                                      // to protect shared data structure
+  condition_variable write_cv_;                      // signals under latch_ that frames are no longer being written
+};
+
+#endif  // MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
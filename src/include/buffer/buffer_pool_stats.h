@@ -0,0 +1,118 @@
+#ifndef MINISQL_BUFFER_POOL_STATS_H
+#define MINISQL_BUFFER_POOL_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Distribution of I/O latencies over power-of-two buckets of microseconds: bucket 0 counts the requests that took less
+ * than 1us, bucket i > 0 those that took [2^(i-1), 2^i) us, and the last bucket everything slower.
+ */
+struct LatencyHistogram {
+  static constexpr size_t NUM_BUCKETS = 24;  // the last bucket starts at about 4 seconds
+
+  /** @return the bucket of a latency */
+  static inline size_t BucketOf(uint64_t micros) {
+    return micros == 0 ? 0 : std::min<size_t>(NUM_BUCKETS - 1, 64 - __builtin_clzll(micros));
+  }
+
+  /** @return the upper bound in microseconds of the bucket holding the given fraction of the requests */
+  uint64_t Percentile(double fraction) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * count_ + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        return 1ULL << i;
+      }
+    }
+    return 1ULL << (NUM_BUCKETS - 1);
+  }
+
+  /** @return the mean latency in microseconds */
+  inline double Mean() const { return count_ == 0 ? 0 : static_cast<double>(total_micros_) / count_; }
+
+  void Add(const LatencyHistogram &other) {
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    total_micros_ += other.total_micros_;
+  }
+
+  std::array<uint64_t, NUM_BUCKETS> buckets_{};  // requests per bucket
+  uint64_t count_{0};                            // number of requests
+  uint64_t total_micros_{0};                     // sum of the latencies
+};
+
+/**
+ * The live side of a LatencyHistogram, updated concurrently by the threads doing I/O. Every update is a relaxed
+ * atomic increment, so recording costs about as much as reading the clock.
+ */
+class LatencyRecorder {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /** Record count requests that started at start and just finished, e.g. the pages of one batch. */
+  inline void Record(Clock::time_point start, uint64_t count = 1) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    uint64_t latency = micros < 0 ? 0 : static_cast<uint64_t>(micros);
+    buckets_[LatencyHistogram::BucketOf(latency)].fetch_add(count, std::memory_order_relaxed);
+    count_.fetch_add(count, std::memory_order_relaxed);
+    total_micros_.fetch_add(latency * count, std::memory_order_relaxed);
+  }
+
+  /** @return a copy of the histogram, the buckets are read one by one so they may be off by in-flight requests */
+  LatencyHistogram Snapshot() const {
+    LatencyHistogram histogram;
+    for (size_t i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+      histogram.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    histogram.count_ = count_.load(std::memory_order_relaxed);
+    histogram.total_micros_ = total_micros_.load(std::memory_order_relaxed);
+    return histogram;
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_micros_{0};
+};
+
+/**
+ * Snapshot of the counters of a buffer pool instance, or the sum over the instances of a pool.
+ */
+struct BufferPoolStats {
+  size_t pool_size_{0};             // frames in service
+  uint64_t hits_{0};                // fetches that found the page resident
+  uint64_t misses_{0};              // fetches that had to read the page from disk
+  uint64_t evictions_{0};           // resident pages dropped to make room for another page
+  uint64_t dirty_write_backs_{0};   // pages written back to disk, by eviction, flush or the page cleaner
+  uint64_t pin_waits_{0};           // pins that had to wait for a frame locked by the pool or written by the cleaner
+  LatencyHistogram read_latency_;   // page reads, including read-ahead
+  LatencyHistogram write_latency_;  // page writes
+
+  /** @return the fraction of fetches that were hits, 0 if there was none */
+  inline double HitRatio() const {
+    return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+  }
+
+  void Add(const BufferPoolStats &other) {
+    pool_size_ += other.pool_size_;
+    hits_ += other.hits_;
+    misses_ += other.misses_;
+    evictions_ += other.evictions_;
+    dirty_write_backs_ += other.dirty_write_backs_;
+    pin_waits_ += other.pin_waits_;
+    read_latency_.Add(other.read_latency_);
+    write_latency_.Add(other.write_latency_);
+  }
+};
+
+#endif  // MINISQL_BUFFER_POOL_STATS_H
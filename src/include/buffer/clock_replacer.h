@@ -1,12 +1,6 @@
 #ifndef MINISQL_CLOCK_REPLACER_H
 #define MINISQL_CLOCK_REPLACER_H
 
-#include <algorithm>
-#include <list>
-#include <map>
-#include <mutex>
-#include <queue>
-#include <unordered_set>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -16,6 +10,9 @@ using namespace std;
 
 /**
  * CLOCKReplacer implements the clock replacement.
+ *
+ * Frames sit on a circular buffer indexed by frame id. The clock hand sweeps over the unpinned frames, clearing
+ * reference bits, and picks the first frame whose bit is already clear.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -38,10 +35,14 @@ class CLOCKReplacer : public Replacer {
 
   size_t Size() override;
 
+  void RecordAccess(frame_id_t frame_id) override;
+
  private:
   size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  size_t hand_{0};         // next frame the clock hand looks at
+  size_t size_{0};         // number of frames in the clock
+  vector<bool> in_clock_;  // the frame can be victimized
+  vector<bool> ref_;       // reference bit of every frame
 };
 
-#endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
+#endif  // MINISQL_CLOCK_REPLACER_H
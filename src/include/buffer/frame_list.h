@@ -0,0 +1,76 @@
+#ifndef MINISQL_FRAME_LIST_H
+#define MINISQL_FRAME_LIST_H
+
+#include <vector>
+
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * FrameList is an intrusive doubly linked list of frame ids. The links live in arrays indexed by frame id that are
+ * allocated once, so adding, moving and removing frames never allocates. Every frame is in the list at most once.
+ */
+class FrameList {
+ public:
+  explicit FrameList(size_t num_frames)
+      : prev_(num_frames, INVALID_FRAME_ID), next_(num_frames, INVALID_FRAME_ID), linked_(num_frames, false) {}
+
+  inline bool Contains(frame_id_t frame_id) const { return linked_[frame_id]; }
+
+  inline bool Empty() const { return size_ == 0; }
+
+  inline size_t Size() const { return size_; }
+
+  /** @return the most recently pushed frame, INVALID_FRAME_ID if the list is empty */
+  inline frame_id_t Front() const { return head_; }
+
+  /** @return the least recently pushed frame, INVALID_FRAME_ID if the list is empty */
+  inline frame_id_t Back() const { return tail_; }
+
+  /** Link a frame that is not in the list yet at the front. */
+  void PushFront(frame_id_t frame_id) {
+    prev_[frame_id] = INVALID_FRAME_ID;
+    next_[frame_id] = head_;
+    if (head_ != INVALID_FRAME_ID) {
+      prev_[head_] = frame_id;
+    } else {
+      tail_ = frame_id;
+    }
+    head_ = frame_id;
+    linked_[frame_id] = true;
+    size_++;
+  }
+
+  /** Unlink a frame that is in the list. */
+  void Remove(frame_id_t frame_id) {
+    if (prev_[frame_id] != INVALID_FRAME_ID) {
+      next_[prev_[frame_id]] = next_[frame_id];
+    } else {
+      head_ = next_[frame_id];
+    }
+    if (next_[frame_id] != INVALID_FRAME_ID) {
+      prev_[next_[frame_id]] = prev_[frame_id];
+    } else {
+      tail_ = prev_[frame_id];
+    }
+    linked_[frame_id] = false;
+    size_--;
+  }
+
+  /** Move a frame that is in the list to the front. */
+  inline void MoveToFront(frame_id_t frame_id) {
+    Remove(frame_id);
+    PushFront(frame_id);
+  }
+
+ private:
+  vector<frame_id_t> prev_;
+  vector<frame_id_t> next_;
+  vector<bool> linked_;
+  frame_id_t head_{INVALID_FRAME_ID};
+  frame_id_t tail_{INVALID_FRAME_ID};
+  size_t size_{0};
+};
+
+#endif  // MINISQL_FRAME_LIST_H
@@ -0,0 +1,114 @@
+#ifndef MINISQL_LOCK_FREE_PAGE_TABLE_H
+#define MINISQL_LOCK_FREE_PAGE_TABLE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * LockFreePageTable maps (database, page id) pairs to frame ids for one buffer pool instance.
+ *
+ * It is a fixed-capacity open-addressing table with linear probing. Each slot packs the database id (8 bits), the
+ * page id (32 bits) and the frame id (24 bits) into a single 64-bit atomic word, so a reader always observes a
+ * complete mapping. Find() never blocks; Insert(),
+ * Erase() and Grow() must be serialized by the caller (the instance latch). A concurrent Find() may miss an entry
+ * that is being moved around by a writer, so callers treat a miss as "look again under the latch", and must verify a
+ * hit against the frame itself because the mapping may be removed right after it was read.
+ */
+class LockFreePageTable {
+ public:
+  /**
+   * @param num_frames number of frames of the owning instance, the table never holds more entries than that
+   */
+  explicit LockFreePageTable(size_t num_frames);
+
+  static_assert(MAX_OPEN_DATABASES <= 256, "Database ids must fit in 8 bits.");
+
+  ~LockFreePageTable() = default;
+
+  DISALLOW_COPY_AND_MOVE(LockFreePageTable);
+
+  /**
+   * Lock-free lookup.
+   * @return the frame holding the page, INVALID_FRAME_ID if it was not found
+   */
+  frame_id_t Find(db_id_t db_id, page_id_t page_id) const;
+
+  /**
+   * Add a mapping for a page that is not in the table yet. Caller must hold the writer latch.
+   */
+  void Insert(db_id_t db_id, page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove the mapping of a page. Caller must hold the writer latch.
+   * @return true if the page was found
+   */
+  bool Erase(db_id_t db_id, page_id_t page_id);
+
+  /**
+   * Make room for the entries of num_frames frames. The entries move to a larger slot array; the old one is kept
+   * until the table is destroyed because lock-free readers may still be probing it.
+   */
+  void Grow(size_t num_frames);
+
+  /** @return number of live entries */
+  inline size_t Size() const { return size_; }
+
+  /** @return number of slots */
+  inline size_t Capacity() const { return table_.load()->capacity_; }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = UINT64_MAX;
+  static constexpr uint64_t TOMBSTONE_SLOT = UINT64_MAX - 1;
+
+  static constexpr uint64_t FRAME_BITS = 24;
+  static constexpr uint64_t FRAME_MASK = (1ULL << FRAME_BITS) - 1;
+  static constexpr uint64_t KEY_MASK = ~FRAME_MASK;
+
+  /** @return the database and page id in the upper 40 bits of a slot */
+  static inline uint64_t Key(db_id_t db_id, page_id_t page_id) {
+    return (static_cast<uint64_t>(db_id) << 56) | (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << FRAME_BITS);
+  }
+
+  static inline uint64_t Pack(uint64_t key, frame_id_t frame_id) { return key | static_cast<uint64_t>(frame_id); }
+
+  static inline frame_id_t UnpackFrameId(uint64_t slot) { return static_cast<frame_id_t>(slot & FRAME_MASK); }
+
+  /**
+   * An array of slots, replaced by a larger one when the instance grows.
+   */
+  struct Slots {
+    explicit Slots(size_t num_frames);
+
+    size_t capacity_;                             // power of two, at least twice the number of frames
+    size_t mask_;                                 // capacity_ - 1
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  };
+
+  static inline size_t Hash(const Slots *table, uint64_t key) {
+    // fibonacci hashing spreads the sequential page ids a single shard sees
+    return ((key >> FRAME_BITS) * 0x9E3779B97F4A7C15ULL >> 32) & table->mask_;
+  }
+
+  /** Insert a key that is not in the table yet. */
+  void InsertKey(Slots *table, uint64_t key, frame_id_t frame_id);
+
+  /** @return every live slot of the current table */
+  std::vector<uint64_t> LiveSlots() const;
+
+  /**
+   * Re-insert every live entry so that the probe chains no longer go through tombstones.
+   */
+  void Rebuild();
+
+ private:
+  std::atomic<Slots *> table_;                  // slots used by new lookups
+  std::vector<std::unique_ptr<Slots>> tables_;  // current and replaced slot arrays, only touched by writers
+  size_t size_{0};                              // live entries, only touched by writers
+  size_t tombstones_{0};                        // erased slots, only touched by writers
+};
+
+#endif  // MINISQL_LOCK_FREE_PAGE_TABLE_H
@@ -0,0 +1,54 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the unpinned frame whose K-th most recent access is the oldest. Frames with fewer than K recorded
+ * accesses have an infinite backward K-distance and are evicted first, the one with the oldest first access going
+ * first, so a single sequential scan cannot push out pages that have been referenced K times.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+ private:
+  size_t num_pages_;
+  size_t k_;
+  size_t size_{0};                   // number of evictable frames
+  uint64_t current_timestamp_{0};    // logical clock, advanced on every access
+  vector<uint64_t> history_;         // last k access timestamps of every frame, a ring of k slots per frame
+  vector<uint64_t> access_count_;    // number of accesses recorded for every frame
+  vector<bool> evictable_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
@@ -1,11 +1,7 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_set>
-#include <vector>
-
+#include "buffer/frame_list.h"
 #include "buffer/replacer.h"
 #include "common/config.h"
 
@@ -35,11 +31,12 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
-private:
-  // add your own private member variables here
-  list<frame_id_t> v_list;
-  vector<list<frame_id_t>::iterator> cache;
-  size_t num;
+  /** A hit moves an unpinned frame back to the front. */
+  void RecordAccess(frame_id_t frame_id) override;
+
+ private:
+  FrameList lru_list_;  // unpinned frames, most recently used at the front
+  size_t num_pages_;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
@@ -0,0 +1,182 @@
+#ifndef MINISQL_PAGE_GUARD_H
+#define MINISQL_PAGE_GUARD_H
+
+#include "page/page.h"
+
+class BufferPoolManager;
+
+/**
+ * BasicPageGuard owns one pin of a page and gives it back when it goes out of scope, so that no path out of a function
+ * can leak the pin. Guards are movable and not copyable: moving a guard hands the pin over, e.g. out of a function
+ * that fetched the page. The page is not latched, which suits code that holds several pins of the same page at once,
+ * such as the restructuring of a B+ tree.
+ *
+ * A guard remembers whether the page was modified through it and unpins the page as dirty if so. A default
+ * constructed guard, or a guard for a page that could not be fetched, holds nothing and tests false.
+ */
+class BasicPageGuard {
+ public:
+  BasicPageGuard() = default;
+
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  BasicPageGuard(const BasicPageGuard &) = delete;
+  BasicPageGuard &operator=(const BasicPageGuard &) = delete;
+
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+
+  /** Release the pin this guard holds, then take over the pin of that. */
+  BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+  ~BasicPageGuard() { Drop(); }
+
+  /**
+   * Unpin the page now, the guard holds nothing afterwards. Dropping an empty guard does nothing.
+   */
+  void Drop();
+
+  /** @return whether the guard holds a page */
+  explicit operator bool() const { return page_ != nullptr; }
+
+  inline page_id_t PageId() const { return page_->GetPageId(); }
+
+  inline const char *GetData() const { return page_->GetData(); }
+
+  /** @return the page data to be modified, the page is unpinned as dirty */
+  inline char *GetDataMut() {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /** @return the page data viewed as a page layout, e.g. a B+ tree node */
+  template <class T>
+  const T *As() const {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+  /** @return the page data viewed as a page layout to be modified, the page is unpinned as dirty */
+  template <class T>
+  T *AsMut() {
+    return reinterpret_cast<T *>(GetDataMut());
+  }
+
+  /**
+   * @return the page itself, for the page layouts that derive from Page such as TablePage; the page is unpinned as
+   * dirty
+   */
+  inline Page *GetPageMut() {
+    is_dirty_ = true;
+    return page_;
+  }
+
+  /** @return the page itself, which must not be modified */
+  inline Page *GetPage() const { return page_; }
+
+  /** Have the page unpinned as dirty. */
+  inline void SetDirty() { is_dirty_ = true; }
+
+ private:
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard holds a pin and the read latch of a page, both are released when the guard goes out of scope.
+ */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+
+  /** Take over a pinned page whose read latch is held by the caller. */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  ReadPageGuard(const ReadPageGuard &) = delete;
+  ReadPageGuard &operator=(const ReadPageGuard &) = delete;
+
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+  ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+  ~ReadPageGuard() { Drop(); }
+
+  /**
+   * Release the latch and the pin now.
+   */
+  void Drop();
+
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  inline page_id_t PageId() const { return guard_.PageId(); }
+
+  inline const char *GetData() const { return guard_.GetData(); }
+
+  template <class T>
+  const T *As() const {
+    return guard_.As<T>();
+  }
+
+  /** @return the page itself, which must not be modified */
+  inline Page *GetPage() const { return guard_.GetPage(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard holds a pin and the write latch of a page, both are released when the guard goes out of scope. The
+ * page is unpinned as dirty if it was accessed through one of the mutable accessors.
+ */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+
+  /** Take over a pinned page whose write latch is held by the caller. */
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  WritePageGuard(const WritePageGuard &) = delete;
+  WritePageGuard &operator=(const WritePageGuard &) = delete;
+
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+  WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+  ~WritePageGuard() { Drop(); }
+
+  /**
+   * Release the latch and the pin now.
+   */
+  void Drop();
+
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  inline page_id_t PageId() const { return guard_.PageId(); }
+
+  inline const char *GetData() const { return guard_.GetData(); }
+
+  inline char *GetDataMut() { return guard_.GetDataMut(); }
+
+  template <class T>
+  const T *As() const {
+    return guard_.As<T>();
+  }
+
+  template <class T>
+  T *AsMut() {
+    return guard_.AsMut<T>();
+  }
+
+  inline Page *GetPageMut() { return guard_.GetPageMut(); }
+
+  inline Page *GetPage() const { return guard_.GetPage(); }
+
+  inline void SetDirty() { guard_.SetDirty(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+#endif  // MINISQL_PAGE_GUARD_H
@@ -0,0 +1,47 @@
+#ifndef MINISQL_READ_AHEAD_WINDOW_H
+#define MINISQL_READ_AHEAD_WINDOW_H
+
+#include <algorithm>
+
+#include "common/config.h"
+
+/**
+ * ReadAheadWindow decides how far a reader following a chain of pages asks the buffer pool to read ahead. The window
+ * starts small, so short scans do not load pages they never reach, and doubles every time the reader catches up with
+ * half of it, up to max_pages. A reader calls Advance() each time it moves on to the next page of the chain.
+ */
+class ReadAheadWindow {
+ public:
+  explicit ReadAheadWindow(size_t max_pages = DEFAULT_READ_AHEAD_MAX_PAGES)
+      : max_pages_(max_pages), window_(std::min<size_t>(DEFAULT_READ_AHEAD_MIN_PAGES, max_pages)) {}
+
+  /**
+   * The reader moved on to the next page of the chain.
+   * @return number of pages following the current one to prefetch, 0 if enough of them are requested already
+   */
+  inline size_t Advance() {
+    if (ahead_ > 0) {
+      ahead_--;
+    }
+    if (window_ == 0 || ahead_ > window_ / 2) {
+      return 0;
+    }
+    if (requested_) {
+      window_ = std::min(window_ * 2, max_pages_);
+    }
+    requested_ = true;
+    ahead_ = window_;
+    return window_;
+  }
+
+  /** @return current size of the window */
+  inline size_t GetWindow() const { return window_; }
+
+ private:
+  size_t max_pages_;       // upper bound of the window
+  size_t window_;          // pages requested ahead of the reader by the next request
+  size_t ahead_{0};        // requested pages the reader has not reached yet
+  bool requested_{false};  // whether a request was made, the first one keeps the initial window
+};
+
+#endif  // MINISQL_READ_AHEAD_WINDOW_H
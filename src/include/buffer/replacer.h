@@ -5,6 +5,11 @@
 
 #include "common/config.h"
 
+/**
+ * Replacement policies a buffer pool can be built with.
+ */
+enum class ReplacerType { kLRU, kClock, kLRUK, k2Q };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -14,6 +19,13 @@ class Replacer {
 
   virtual ~Replacer() = default;
 
+  /**
+   * Create a replacer of the given policy.
+   * @param num_pages the maximum number of pages the replacer will be required to store
+   * @param lru_k number of accesses remembered per frame, only used by ReplacerType::kLRUK
+   */
+  static Replacer *Create(ReplacerType type, size_t num_pages, size_t lru_k = DEFAULT_LRU_K);
+
   /**
    * Remove the victim frame as defined by the replacement policy.
    * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
@@ -35,6 +47,19 @@ class Replacer {
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Record an access to a frame, including buffer hits on a frame the replacer is tracking. The access history of a
+   * frame survives Pin/Unpin and Victim until the frame is removed.
+   * @param frame_id the id of the accessed frame
+   */
+  virtual void RecordAccess(__attribute__((unused)) frame_id_t frame_id) {}
+
+  /**
+   * Forget a frame together with its access history, the page it held has left the buffer pool.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
 };
 
 #endif  // MINISQL_REPLACER_H
@@ -0,0 +1,55 @@
+#ifndef MINISQL_TWO_QUEUE_REPLACER_H
+#define MINISQL_TWO_QUEUE_REPLACER_H
+
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * TwoQueueReplacer implements the simplified 2Q replacement policy.
+ *
+ * A frame accessed once lives in the FIFO queue A1, a frame accessed again is promoted to the LRU queue Am. Victims
+ * come from A1 while it holds more than a quarter of the frames, so pages touched by a scan leave the pool before
+ * the hot pages in Am do.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_pages);
+
+  /**
+   * Destroys the TwoQueueReplacer.
+   */
+  ~TwoQueueReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+ private:
+  enum class QueueType : uint8_t { kNone, kA1, kAm };
+
+  inline FrameList &ListOf(frame_id_t frame_id) { return queue_[frame_id] == QueueType::kAm ? am_list_ : a1_list_; }
+
+  size_t a1_threshold_;      // A1 is preferred for eviction while it holds more frames than this
+  FrameList a1_list_;        // unpinned frames accessed once, newest at the front
+  FrameList am_list_;        // unpinned frames accessed more than once, most recent at the front
+  vector<QueueType> queue_;  // queue of every frame, kept while the frame is pinned
+};
+
+#endif  // MINISQL_TWO_QUEUE_REPLACER_H
@@ -1,9 +1,14 @@
 #ifndef MINISQL_CATALOG_H
 #define MINISQL_CATALOG_H
 
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/indexes.h"
@@ -68,6 +73,7 @@ class CatalogMeta {
 /**
  * Catalog manager
  *
+ * The catalog of a read-only database can only be read: creating, dropping and vacuuming return DB_READ_ONLY.
  */
 class CatalogManager {
  public:
@@ -90,10 +96,25 @@ class CatalogManager {
 
   dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const;
 
-  dberr_t DropTable(const std::string &table_name);
+  /**
+   * Drop a table and its indexes. The catalog entry goes right away, the pages of the heap are freed with
+   * TableHeap::DeleteTable(), by a background thread unless wait is set. One thread serves all the drops in order.
+   */
+  dberr_t DropTable(const std::string &table_name, bool wait = true);
+
+  /**
+   * Wait for the background thread of DropTable() to free the pages of the tables dropped so far.
+   */
+  void WaitForDrops();
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Compact the heap of a table with TableHeap::Vacuum(), re-pointing the entries of its indexes at the tuples that
+   * moved.
+   */
+  dberr_t VacuumTable(const std::string &table_name, Txn *txn, VacuumStats &stats);
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
@@ -105,6 +126,11 @@ class CatalogManager {
 
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
+  /**
+   * Body of the drop thread, frees the heaps in drop_queue_ until it is stopped and the queue is empty.
+   */
+  void RunDrops();
+
  private:
   [[maybe_unused]] BufferPoolManager *buffer_pool_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -118,6 +144,14 @@ class CatalogManager {
   // map for indexes: table_name->index_name->indexes
   std::unordered_map<std::string, std::unordered_map<std::string, index_id_t>> index_names_;
   std::unordered_map<index_id_t, IndexInfo *> indexes_;
+  // background freeing of the heaps of dropped tables
+  std::thread drop_thread_;                 // frees the heaps, started by the first DropTable() without wait
+  std::mutex drop_latch_;                   // protects the drop state below
+  std::condition_variable drop_cv_;         // wakes the drop thread up for a new table or to stop
+  std::condition_variable drop_done_cv_;    // signals that the drop thread finished a table
+  std::deque<TableInfo *> drop_queue_;      // dropped tables whose heaps are not freed yet
+  bool drop_busy_{false};                   // whether the drop thread is freeing a heap
+  bool drop_stop_{false};
 };
 
 #endif  // MINISQL_CATALOG_H
@@ -13,16 +13,40 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
+// size of a data page in byte, chosen at build time with the MINISQL_PAGE_SIZE cmake option; every database of a
+// build uses it, and a file written with another page size is refused when it is opened
+#ifndef MINISQL_PAGE_SIZE
+#define MINISQL_PAGE_SIZE 4096
+#endif
+static constexpr int PAGE_SIZE = MINISQL_PAGE_SIZE;
+static_assert(PAGE_SIZE == 4096 || PAGE_SIZE == 8192 || PAGE_SIZE == 16384 || PAGE_SIZE == 32768,
+              "page size must be 4, 8, 16 or 32 KB");
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 8;  // default number of buffer pool shards
+static constexpr int DEFAULT_LRU_K = 2;                  // default K of the LRU-K replacer
+static constexpr int DEFAULT_ACCESS_LOG_SIZE = 128;      // buffer hits a shard logs before the replacer learns them
+static constexpr int DEFAULT_BUFFER_RING_SIZE = 32;      // default number of frames a bulk reader recycles
+static constexpr int DEFAULT_CLEANER_CLEAN_TARGET = 64;  // clean frames the page cleaner keeps ready per shard
+static constexpr int DEFAULT_CLEANER_INTERVAL_MS = 50;   // time between two rounds of the page cleaner
+static constexpr int DEFAULT_READ_AHEAD_MIN_PAGES = 2;   // initial read-ahead window of a chain scan
+static constexpr int DEFAULT_READ_AHEAD_MAX_PAGES = 16;  // largest read-ahead window, at most half a buffer ring
+static constexpr int DEFAULT_PREFETCH_QUEUE_SIZE = 64;   // pending read-ahead requests, newer ones are dropped
+static constexpr int DEFAULT_IO_QUEUE_DEPTH = 64;        // page reads and writes the I/O engine keeps in flight
+static constexpr int DEFAULT_IO_THREADS = 8;             // threads of the I/O engine when io_uring is not available
+static constexpr int MAX_OPEN_DATABASES = 256;           // databases sharing one buffer pool at the same time
+static constexpr int DEFAULT_DELETE_BATCH_PAGES = 1024;  // pages a drop frees at a time
+static constexpr int DEFAULT_ARENA_BLOCK_SIZE = 65536;   // size of the blocks a query arena carves rows from
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
+static constexpr uint32_t CHAR_OVERFLOW_THRESHOLD = PAGE_SIZE / 16;  // longer CHAR values are kept out of line
+static constexpr uint32_t CHAR_OVERFLOW_PREFIX_LEN = 16;  // head of an out of line value kept in the row
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
 using page_id_t = int32_t;
 using frame_id_t = int32_t;
+using db_id_t = uint32_t;
 using txn_id_t = int32_t;
 using lsn_t = int32_t;
 using column_id_t = uint32_t;
@@ -14,12 +14,46 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                           ReplacerType replacer_type = ReplacerType::kLRU, uint32_t lru_k = DEFAULT_LRU_K);
+
+  /**
+   * Open a database whose pages are cached in a buffer pool shared with other databases.
+   */
+  explicit DBStorageEngine(std::string db_name, bool init, BufferPool *buffer_pool);
+
+  /**
+   * Open an existing database for queries only. Its file is mapped into memory and the buffer pool serves its pages
+   * straight from the mapping, without copying them into frames. The mapping cannot be written: new pages cannot be
+   * allocated, and the table heaps, the B+ trees and the catalog refuse every change before it touches a page.
+   * @throw std::runtime_error if the file does not exist or cannot be mapped
+   */
+  static std::unique_ptr<DBStorageEngine> OpenReadOnly(std::string db_name,
+                                                       uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                                                       uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES);
+
+  /**
+   * Open an existing database read-only like above, with its pages cached in a buffer pool shared with other
+   * databases, see USE ... READONLY.
+   */
+  static std::unique_ptr<DBStorageEngine> OpenReadOnly(std::string db_name, BufferPool *buffer_pool);
 
   ~DBStorageEngine();
 
   std::unique_ptr<ExecuteContext> MakeExecuteContext(Txn *txn);
 
+ private:
+  DBStorageEngine(std::string db_file_name, DiskManager *disk_mgr, uint32_t buffer_pool_size,
+                  uint32_t buffer_pool_instances);
+
+  DBStorageEngine(std::string db_file_name, DiskManager *disk_mgr, BufferPool *buffer_pool);
+
+  /**
+   * Allocate or check the static pages of the database, then load its catalog.
+   */
+  void Open();
+
  public:
   DiskManager *disk_mgr_;
   BufferPoolManager *bpm_;
@@ -0,0 +1,90 @@
+#ifndef MINISQL_MEMORY_ARENA_H
+#define MINISQL_MEMORY_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * MemoryArena hands out memory carved from large blocks, and frees all of it at once when it is destroyed or reset.
+ * Objects built in it are never destroyed one by one, so they must not own anything outside the arena.
+ *
+ * The arena of a query lives in its ExecuteContext and holds the rows the query returns: their fields and their CHAR
+ * data are allocated here instead of one by one on the heap. A scan whose rows are consumed one at a time keeps an
+ * arena of its own and resets it for every row instead. It is not thread safe.
+ */
+class MemoryArena {
+ public:
+  explicit MemoryArena(size_t block_size = DEFAULT_ARENA_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~MemoryArena() = default;
+
+  DISALLOW_COPY_AND_MOVE(MemoryArena);
+
+  /**
+   * @return size bytes aligned to align, which must be a power of two
+   */
+  void *Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    auto begin = (reinterpret_cast<uintptr_t>(ptr_) + align - 1) & ~(align - 1);
+    if (ptr_ == nullptr || begin + size > reinterpret_cast<uintptr_t>(end_)) {
+      return AllocateSlow(size, align);
+    }
+    ptr_ = reinterpret_cast<char *>(begin + size);
+    allocated_bytes_ += size;
+    return reinterpret_cast<void *>(begin);
+  }
+
+  /**
+   * Construct an object in the arena.
+   */
+  template <class T, class... Args>
+  T *New(Args &&...args) {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @return a copy of len bytes of data in the arena
+   */
+  char *CopyBytes(const char *data, size_t len) {
+    auto copy = static_cast<char *>(Allocate(len, 1));
+    memcpy(copy, data, len);
+    return copy;
+  }
+
+  /**
+   * Free everything allocated so far. The first block is kept to be carved again, so an arena reset for every row
+   * does not go back to the heap.
+   */
+  void Reset();
+
+  /** @return the number of bytes handed out since the arena was created or reset */
+  inline size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  /** @return the number of blocks held */
+  inline size_t GetBlockCount() const { return blocks_.size() + large_blocks_.size(); }
+
+ private:
+  /**
+   * Allocate from a new block. A request larger than a quarter of a block gets a block of its own, and the current
+   * block stays in use.
+   */
+  void *AllocateSlow(size_t size, size_t align);
+
+  size_t block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // blocks of a single large request
+  std::vector<std::unique_ptr<char[]>> large_blocks_;
+  // free part of the current block
+  char *ptr_{nullptr};
+  char *end_{nullptr};
+  size_t allocated_bytes_{0};
+};
+
+#endif  // MINISQL_MEMORY_ARENA_H
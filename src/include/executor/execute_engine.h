@@ -22,7 +22,13 @@ extern "C" {
  */
 class ExecuteEngine {
  public:
-  ExecuteEngine();
+  /**
+   * @param buffer_pool_size memory budget in pages of the buffer pool shared by all the databases
+   * @param replacer_type replacement policy of every shard of the buffer pool
+   * @param lru_k number of accesses remembered per frame, only used by ReplacerType::kLRUK
+   */
+  explicit ExecuteEngine(size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                         ReplacerType replacer_type = ReplacerType::kLRU, size_t lru_k = DEFAULT_LRU_K);
 
   ~ExecuteEngine() {
     for (auto it : dbs_) {
@@ -35,13 +41,21 @@ class ExecuteEngine {
    */
   dberr_t Execute(pSyntaxNode ast);
 
+  /**
+   * Run a plan. The rows of the result set may be allocated in the arena of exec_ctx, which must outlive them.
+   */
   dberr_t ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<Row> *result_set, Txn *txn,
                       ExecuteContext *exec_ctx);
 
   void ExecuteInformation(dberr_t result);
 
  private:
-  static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
+  /**
+   * @param keep_rows false if the consumer drops every row before asking for the next one, so that a scan can reuse the
+   * memory of its rows instead of keeping them all in the arena of exec_ctx
+   */
+  static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                                                          bool keep_rows = true);
 
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
@@ -73,8 +87,15 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteShowStatus(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
  private:
-  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
+  std::unique_ptr<BufferPool> buffer_pool_;                /** buffer pool shared by all databases */
+  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all databases, nullptr until first used */
   std::string current_db_;                                 /** current database */
 };
 
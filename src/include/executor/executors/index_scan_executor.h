@@ -17,8 +17,10 @@ class IndexScanExecutor : public AbstractExecutor {
    * Construct a new SeqScanExecutor instance.
    * @param exec_ctx The executor context
    * @param plan The sequential scan plan to be executed
+   * @param keep_rows false if a row is dropped before the next one is asked for, then the rows share one arena of the
+   * executor that is reset for every row; otherwise they are kept in the arena of exec_ctx
    */
-  IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan);
+  IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan, bool keep_rows = true);
 
   /** Initialize the sequential scan */
   void Init() override;
@@ -36,8 +38,6 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
-
  private:
   vector<RowId> IndexScan(AbstractExpressionRef predicate);
 
@@ -47,4 +47,7 @@ class IndexScanExecutor : public AbstractExecutor {
   vector<RowId> result_;
   size_t cursor_ = 0;
   bool is_schema_same_;
+  /** Memory of the last row, used instead of the arena of the context if the rows are not kept */
+  MemoryArena row_arena_;
+  MemoryArena *arena_;
 };
\ No newline at end of file
@@ -20,8 +20,10 @@ class SeqScanExecutor : public AbstractExecutor {
    * Construct a new SeqScanExecutor instance.
    * @param exec_ctx The executor context
    * @param plan The sequential scan plan to be executed
+   * @param keep_rows false if a row is dropped before the next one is asked for, then the rows share one arena of the
+   * executor that is reset for every row; otherwise they are kept in the arena of exec_ctx
    */
-  SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
+  SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan, bool keep_rows = true);
 
   /** Initialize the sequential scan */
   void Init() override;
@@ -39,8 +41,6 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
-
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
@@ -48,6 +48,9 @@ class SeqScanExecutor : public AbstractExecutor {
   TableIterator iterator_;
   const Schema *schema_{};
   bool is_schema_same_;
+  /** Memory of the last row, used instead of the arena of the context if the rows are not kept */
+  MemoryArena row_arena_;
+  MemoryArena *arena_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +33,12 @@ class BPlusTree {
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
+  // Returns the number of levels of this B+ tree, 0 if it is empty.
+  int GetHeight();
+
+  // Returns true if the pages of the tree cannot be changed, Insert(), Remove() and Destroy() do nothing then.
+  bool IsReadOnly() const { return buffer_pool_manager_->IsReadOnly(); }
+
   // Insert a key-value pair into this B+ tree.
   bool Insert(GenericKey *key, const RowId &value, Txn *transaction = nullptr);
 
@@ -48,21 +55,21 @@ class BPlusTree {
   IndexIterator End();
 
   // expose for test purpose
-  Page *FindLeafPage(const GenericKey *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
+  BasicPageGuard FindLeafPage(const GenericKey *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
 
   // used to check whether all pages are unpinned
   bool Check();
 
-  // destroy the b plus tree
-  void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
+  // destroy the b plus tree: free all its pages in batches, without reading the leaves, and forget its root
+  void Destroy();
 
   void PrintTree(std::ofstream &out, Schema *schema) {
     if (IsEmpty()) {
       return;
     }
     out << "digraph G {" << std::endl;
-    Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    auto *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
+    BasicPageGuard root_guard = buffer_pool_manager_->FetchPageBasic(root_page_id_);
+    auto *node = reinterpret_cast<BPlusTreePage *>(root_guard.GetPage()->GetData());
     ToGraph(node, buffer_pool_manager_, out, schema);
     out << "}" << std::endl;
   }
@@ -74,9 +81,9 @@ class BPlusTree {
 
   void InsertIntoParent(GenericKey *old_key, BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction = nullptr);
 
-  LeafPage *Split(LeafPage *node, Txn *transaction);
+  BasicPageGuard Split(LeafPage *node, Txn *transaction);
 
-  InternalPage *Split(InternalPage *node, Txn *transaction);
+  BasicPageGuard Split(InternalPage *node, Txn *transaction);
 
   template <typename N>
   bool CoalesceOrRedistribute(N *&node, Txn *transaction = nullptr);
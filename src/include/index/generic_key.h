@@ -5,6 +5,7 @@
 
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class GenericKey {
   friend class KeyManager;
@@ -18,38 +19,35 @@ class KeyManager {
   }
 
   inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
-    // initialize to 0
-    [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema);
+    // keys keep the tagged row format, which the index pages of existing files hold
+    [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema, RowFormat::kTagged);
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
     ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
     memset(key_buf->data, 0, key_size_);
-    key.SerializeTo(key_buf->data, schema);
+    key.SerializeTo(key_buf->data, schema, RowFormat::kTagged);
   }
 
   inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-    [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
+    [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema, RowFormat::kTagged);
     ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
   }
 
-  // compare
+  // compare, the keys are read in place and each column is compared with the kernel of its type; a null is equal to
+  // anything
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-    //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
     uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
+    RowView lhs_key(lhs->data, key_schema_, RowFormat::kTagged, INVALID_ROWID);
+    RowView rhs_key(rhs->data, key_schema_, RowFormat::kTagged, INVALID_ROWID);
 
     for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
+      Field lhs_value = lhs_key.GetField(i);
+      Field rhs_value = rhs_key.GetField(i);
+      if (lhs_value.IsNull() || rhs_value.IsNull()) {
+        continue;
       }
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
+      int cmp = key_schema_->GetCompareFn(i)(lhs_value, rhs_value);
+      if (cmp != 0) {
+        return cmp < 0 ? -1 : 1;
       }
     }
     // equals
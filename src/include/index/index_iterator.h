@@ -1,6 +1,8 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include "buffer/page_guard.h"
+#include "buffer/read_ahead_window.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 class IndexIterator {
@@ -12,6 +14,9 @@ class IndexIterator {
 
   explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0);
 
+  /** The iterator owns the pin of its leaf, so it can be moved but not copied. */
+  IndexIterator(IndexIterator &&that) noexcept;
+
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
@@ -28,10 +33,12 @@ class IndexIterator {
 
  private:
   page_id_t current_page_id{INVALID_PAGE_ID};
+  BasicPageGuard guard_;  // pin of the current leaf, the tree does not latch its pages
   LeafPage *page{nullptr};
   int item_index{0};
   BufferPoolManager *buffer_pool_manager{nullptr};
   // add your own private member variables here
+  ReadAheadWindow read_ahead_;  // how far ahead of a range scan the leaf chain is prefetched
 };
 
 #endif  // MINISQL_INDEX_ITERATOR_H
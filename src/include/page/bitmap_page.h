@@ -2,10 +2,16 @@
 #define MINISQL_BITMAP_PAGE_H
 
 #include <bitset>
+#include <cstring>
 
 #include "common/config.h"
 #include "common/macros.h"
 
+/**
+ * BitmapPage records which pages of an extent are allocated, one bit per page. Pages are allocated lowest offset
+ * first: the bitmap is scanned 64 bits at a time from next_free_page_, a hint below which every page is allocated, and
+ * the free bit within a word is found with a count-trailing-zeros instruction.
+ */
 template <size_t PageSize>
 class BitmapPage {
  public:
@@ -14,17 +20,33 @@ class BitmapPage {
    */
   static constexpr size_t GetMaxSupportedSize() { return 8 * MAX_CHARS; }
 
+  /** @return number of allocated pages in the extent */
+  inline uint32_t GetAllocatedPages() const { return page_allocated_; }
+
   /**
    * @param page_offset Index in extent of the page allocated.
    * @return true if successfully allocate a page.
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate 64 contiguous pages, the lowest whole word of the bitmap that is free.
+   * @param page_offset Index in extent of the first page of the run.
+   * @return true if a free run was found.
+   */
+  bool AllocateRun(uint32_t &page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
   bool DeAllocatePage(uint32_t page_offset);
 
+  /**
+   * @param page_offset Index in extent of the allocated page with the highest index.
+   * @return false if no page of the extent is allocated.
+   */
+  bool GetLastAllocatedPage(uint32_t &page_offset) const;
+
   /**
    * @return whether a page in the extent is free
    */
@@ -40,8 +62,17 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /** @return the 64 bits of the bitmap starting at page word_index * 64 */
+  inline uint64_t LoadWord(uint32_t word_index) const {
+    uint64_t word;
+    memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(word));
+    return word;
+  }
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
+  static constexpr size_t NUM_WORDS = MAX_CHARS / sizeof(uint64_t);
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "bitmap must be a whole number of words");
 
  private:
   /** The space occupied by all members of the class should be equal to the PageSize */
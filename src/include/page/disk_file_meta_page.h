@@ -5,25 +5,51 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-
+/**
+ * The first page of a database file: the number of allocated pages and extents, the used page count of the first
+ * META_EXTENTS extents and the page size of the file. The counts of later extents are only kept in their bitmap pages,
+ * so the size of the file is not limited by the meta page.
+ *
+ * The meta information takes the first 4 KB of the meta page whatever the page size, so that a build can read the page
+ * size of a file created by a build with another one and refuse to open it. Files of builds that did not record the
+ * page size have no magic number and always use 4 KB pages.
+ */
 class DiskFileMetaPage {
  public:
+  static constexpr uint32_t META_SIZE = 4096;
+  // number of extents whose used page count fits into the meta page
+  static constexpr uint32_t META_EXTENTS = (META_SIZE - 4 * sizeof(uint32_t)) / sizeof(uint32_t);
+  static constexpr uint32_t MAGIC = 0x4c51534d;
+  // page size of the files written before the page size was recorded
+  static constexpr uint32_t LEGACY_PAGE_SIZE = 4096;
+
   uint32_t GetExtentNums() { return num_extents_; }
 
   uint32_t GetAllocatedPages() { return num_allocated_pages_; }
 
   uint32_t GetExtentUsedPage(uint32_t extent_id) {
-    if (extent_id >= num_extents_) {
+    if (extent_id >= num_extents_ || extent_id >= META_EXTENTS) {
       return 0;
     }
     return extent_used_page_[extent_id];
   }
 
+  /** @return page size of the file, LEGACY_PAGE_SIZE if it was not recorded */
+  uint32_t GetPageSize() const { return magic_ == MAGIC ? page_size_ : LEGACY_PAGE_SIZE; }
+
+  void SetPageSize(uint32_t page_size) {
+    magic_ = MAGIC;
+    page_size_ = page_size;
+  }
+
  public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
-  uint32_t extent_used_page_[0];
+  uint32_t extent_used_page_[META_EXTENTS];
+  uint32_t magic_;      // MAGIC once the page size is recorded, an extent count in older files
+  uint32_t page_size_;  // size of the pages of the file in bytes
 };
 
+static_assert(sizeof(DiskFileMetaPage) == DiskFileMetaPage::META_SIZE, "meta information must fill 4 KB");
+
 #endif  // MINISQL_DISK_FILE_META_PAGE_H
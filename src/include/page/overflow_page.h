@@ -0,0 +1,66 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+
+#include <cstring>
+
+#include "page/page.h"
+
+class BufferPoolManager;
+
+/**
+ * Overflow page, one link of the chain holding a CHAR value that is kept out of line, see Row.
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | DataSize (4) | Data |
+ *  -------------------------------------------------------------
+ */
+class OverflowPage : public Page {
+ public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+  char *GetPayload() { return GetData() + SIZE_OVERFLOW_PAGE_HEADER; }
+
+  /**
+   * Write data to a new chain of overflow pages.
+   * @param owner the pages are allocated in the extent of owner, see BufferPoolManager::NewPageGuarded()
+   * @return the id of the first page, INVALID_PAGE_ID if no page could be allocated
+   */
+  static page_id_t WriteChain(BufferPoolManager *buffer_pool_manager, const char *data, uint32_t len,
+                              const void *owner = nullptr);
+
+  /**
+   * Read len bytes from a chain into buf.
+   * @return false if a page of the chain could not be fetched
+   */
+  static bool ReadChain(BufferPoolManager *buffer_pool_manager, page_id_t page_id, char *buf, uint32_t len);
+
+  /**
+   * De-allocate every page of a chain.
+   * @return the number of pages freed
+   */
+  static size_t FreeChain(BufferPoolManager *buffer_pool_manager, page_id_t page_id);
+
+  static constexpr size_t SIZE_OVERFLOW_PAGE_HEADER = 16;
+  static constexpr size_t SIZE_MAX_DATA = PAGE_SIZE - SIZE_OVERFLOW_PAGE_HEADER;
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+};
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
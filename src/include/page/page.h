@@ -1,6 +1,7 @@
 #ifndef MINISQL_PAGE_H
 #define MINISQL_PAGE_H
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <shared_mutex>
@@ -15,28 +16,35 @@
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
 
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. Allocates the page data and zeros it out. */
+  Page() : data_(new char[PAGE_SIZE]), owns_data_(true) { ResetMemory(); }
 
-  /** Default destructor. */
-  ~Page() = default;
+  /** Destructor. Frees the page data unless it belongs to the buffer pool. */
+  ~Page() {
+    if (owns_data_) {
+      delete[] data_;
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
 
   /** @return the page id of this page */
-  inline page_id_t GetPageId() { return page_id_; }
+  inline page_id_t GetPageId() { return page_id_.load(); }
 
-  /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  /** @return the pin count of this page, frames being loaded or sitting in the free list count as unpinned */
+  inline int GetPinCount() {
+    int pin_count = pin_count_.load();
+    return pin_count < 0 ? 0 : pin_count;
+  }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
-  inline bool IsDirty() { return is_dirty_; }
+  inline bool IsDirty() { return is_dirty_.load(); }
 
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
@@ -47,6 +55,9 @@ class Page {
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Acquire the page read latch without waiting, @return false if a writer holds or waits for it. */
+  inline bool TryRLatch() { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
@@ -65,17 +76,38 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Pin count of a frame that is owned by the buffer pool, see pin_count_. */
+  static constexpr int LOCKED_PIN_COUNT = -1;
+
+  /**
+   * Constructor of a buffer pool frame. The data lives in a block of frames allocated by the pool, which may free it
+   * while the frame is retired, so the frame itself has to stay valid for lock-free readers.
+   */
+  explicit Page(char *data) : data_(data) {}
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The actual data that is stored within a page, for a read-only database it may point into the mapped file. */
+  char *data_;
+  /** Whether data_ was allocated by the page itself. */
+  bool owns_data_{false};
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /** The database the page belongs to, frames are shared by every database using the buffer pool. */
+  std::atomic<db_id_t> db_id_{0};
+  /**
+   * The pin count of this page. It is updated without holding any latch; -1 means that the frame is owned by the
+   * buffer pool (free, being evicted or being loaded) and cannot be pinned.
+   */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
+  /** Set on every buffer hit, cleared once the replacer knows about the hit. Still set at eviction time if the hit was
+   * dropped by the access log, and then gives the page a second chance. */
+  std::atomic<bool> is_referenced_{false};
+  /** True while the page cleaner or a flush writes the page, the frame must not be evicted or written meanwhile. */
+  std::atomic<bool> is_writing_{false};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
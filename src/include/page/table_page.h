@@ -12,12 +12,17 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  -----------------------------------------------------------------------------
+ *  | TupleCount (3) | RowFormat (1) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  -----------------------------------------------------------------------------
+ *
+ *  All the tuples of a page are in the row format of its header. Pages written before the compact format existed have
+ *  a zero there, which reads as RowFormat::kTagged, and keep their tagged rows; new pages are compact. Only a compact
+ *  tuple keeps long CHAR values out of line, their overflow pages belong to it and go when its delete is applied.
  **/
 
 #include <cstring>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/rowid.h"
@@ -25,6 +30,7 @@
 #include "concurrency/txn.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "recovery/log_manager.h"
 
 
@@ -36,7 +42,8 @@ enum class TABLE_PAGE_UPDATE {
 
 class TablePage : public Page {
  public:
-  void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Txn *txn);
+  void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Txn *txn,
+            RowFormat format = RowFormat::kCompact);
 
   page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
@@ -44,6 +51,13 @@ class TablePage : public Page {
 
   page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
 
+  /** Link of a table heap page to the next one, used to read the heap ahead of a scan. */
+  static page_id_t NextPageOf(Page *page) { return reinterpret_cast<TablePage *>(page)->GetNextPageId(); }
+
+  RowFormat GetRowFormat() {
+    return static_cast<RowFormat>(*reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT) >> ROW_FORMAT_SHIFT);
+  }
+
   void SetPrevPageId(page_id_t prev_page_id) {
     memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
   }
@@ -52,23 +66,72 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
   }
 
-  bool InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *lock_manager, LogManager *log_manager);
+  /**
+   * @param overflow_pages first overflow page of each value of the row kept out of line, see Row::SerializeTo(); a
+   * tagged page keeps every value in the row
+   */
+  bool InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *lock_manager, LogManager *log_manager,
+                   const page_id_t *overflow_pages = nullptr);
+
+  /**
+   * Copy a tuple of a page of the same row format as it is, with the stubs of the values it keeps out of line, which
+   * then belong to the copy.
+   * @param[out] rid row id of the copy
+   * @return false if the page has no room for it
+   */
+  bool CopyTuple(TablePage *from_page, const RowId &from_rid, RowId *rid);
 
   bool MarkDelete(const RowId &rid, Txn *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * @param overflow_pages first overflow page of each value of the new row kept out of line
+   * @param buffer_pool_manager reads the values of the old row kept out of line
+   */
   TABLE_PAGE_UPDATE UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Txn *txn, LockManager *lock_manager,
-                   LogManager *log_manager);
+                                LogManager *log_manager, const page_id_t *overflow_pages = nullptr,
+                                BufferPoolManager *buffer_pool_manager = nullptr);
 
   void ApplyDelete(const RowId &rid, Txn *txn, LogManager *log_manager);
 
   void RollbackDelete(const RowId &rid, Txn *txn, LogManager *log_manager);
 
-  bool GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager);
+  /**
+   * @param buffer_pool_manager reads the values kept out of line, a tuple that has some cannot be read without it
+   */
+  bool GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager,
+                BufferPoolManager *buffer_pool_manager = nullptr);
+
+  /**
+   * Point a view at a tuple in place, the view is valid while the page stays pinned and latched.
+   * @return false if the tuple does not exist
+   */
+  bool GetTupleView(const RowId &rid, const Schema *schema, RowView *view,
+                    BufferPoolManager *buffer_pool_manager = nullptr);
+
+  /**
+   * Add the first overflow page of every value of a tuple kept out of line, the tuple may be marked as deleted.
+   */
+  void GetOverflowPages(const RowId &rid, const Schema *schema, std::vector<page_id_t> *overflow_pages);
+
+  /**
+   * Add the first overflow page of every value kept out of line by the tuples of the page, deleted ones included.
+   */
+  void GetOverflowPages(const Schema *schema, std::vector<page_id_t> *overflow_pages);
 
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /**
+   * Apply the delete of every tuple that is marked as deleted, and give the empty slots at the end of the slot array
+   * back to the free space.
+   * @param[out] overflow_pages if not nullptr, gets the first overflow page of every value the deleted tuples kept out
+   * of line, for the caller to free
+   * @return the number of tuples deleted
+   */
+  uint32_t PurgeDeleted(Txn *txn, LogManager *log_manager, const Schema *schema = nullptr,
+                        std::vector<page_id_t> *overflow_pages = nullptr);
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -76,9 +139,12 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
   }
 
-  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT) & TUPLE_COUNT_MASK; }
 
-  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+  void SetTupleCount(uint32_t tuple_count) {
+    uint32_t word = tuple_count | static_cast<uint32_t>(GetRowFormat()) << ROW_FORMAT_SHIFT;
+    memcpy(GetData() + OFFSET_TUPLE_COUNT, &word, sizeof(uint32_t));
+  }
 
   uint32_t GetFreeSpaceRemaining() {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
@@ -100,6 +166,9 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
+  /** @return the first empty slot, the tuple count if every slot is in use */
+  uint32_t FindFreeSlot();
+
   static bool IsDeleted(uint32_t tuple_size) { return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0; }
 
   static uint32_t SetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size | DELETE_MASK); }
@@ -117,6 +186,8 @@ class TablePage : public Page {
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
   static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr uint32_t ROW_FORMAT_SHIFT = 24;
+  static constexpr uint32_t TUPLE_COUNT_MASK = (1U << ROW_FORMAT_SHIFT) - 1;
 
  public:
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
@@ -43,7 +43,10 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin recovery command */
   kNodeTrxCommit,            /** commit recovery command */
-  kNodeTrxRollback           /** rollback recovery command */
+  kNodeTrxRollback,          /** rollback recovery command */
+  kNodeSetVariable,          /** set a system variable, e.g. buffer_pool_size */
+  kNodeShowStatus,           /** show status command, the counters of the buffer pool */
+  kNodeVacuum                /** vacuum command, compacts one table or all of them and truncates the file */
 } SyntaxNodeType;
 
 /**
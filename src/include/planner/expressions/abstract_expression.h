@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 class AbstractExpression;
@@ -36,6 +37,22 @@ class AbstractExpression {
   /** @return The field obtained by evaluating the row */
   virtual Field Evaluate(const Row *row) const = 0;
 
+  /** @return The field obtained by evaluating a row read in place, the fields it is made of are not copied */
+  virtual Field Evaluate(const RowView &row) const = 0;
+
+  /**
+   * Evaluate a predicate on a row read in place. Comparisons and logic expressions answer directly, instead of
+   * building a boolean field that the caller has to compare again.
+   * @return kTrue if the row satisfies the predicate
+   */
+  virtual CmpBool EvaluatePredicate(const RowView &row) const {
+    Field value = Evaluate(row);
+    if (value.IsNull()) {
+      return CmpBool::kNull;
+    }
+    return value.CompareEquals(Field(kTypeInt, 1));
+  }
+
   /**
    * Returns the field obtained by evaluating a JOIN.
    * @param left_row The left row
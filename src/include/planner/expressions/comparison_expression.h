@@ -8,8 +8,21 @@
 #include <utility>
 
 #include "abstract_expression.h"
+#include "record/field_kernels.h"
 #include "record/schema.h"
 
+/** ComparisonType represents the type of comparison that we want to perform. */
+enum class ComparisonType {
+  Equal,
+  NotEqual,
+  LessThan,
+  LessThanOrEqual,
+  GreaterThan,
+  GreaterThanOrEqual,
+  IsNull,
+  NotNull
+};
+
 /**
  * ComparisonExpression represents two expressions being compared.
  */
@@ -18,7 +31,14 @@ class ComparisonExpression : public AbstractExpression {
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, string comp_type)
       : AbstractExpression({std::move(left), std::move(right)}, TypeId::kTypeInt, ExpressionType::ComparisonExpression),
-        comp_type_{std::move(comp_type)} {}
+        comp_type_{std::move(comp_type)},
+        type_(Str2Type(comp_type_)) {
+    // both sides of a column = constant predicate have the type of the column, and are compared with its kernel
+    TypeId lhs_type = GetChildAt(0)->GetReturnType();
+    if (lhs_type != TypeId::kTypeInvalid && lhs_type == GetChildAt(1)->GetReturnType()) {
+      compare_fn_ = GetFieldCompareFn(lhs_type);
+    }
+  }
 
   /** e.g. evaluate the result of id = 1 */
   Field Evaluate(const Row *row) const override {
@@ -27,6 +47,16 @@ class ComparisonExpression : public AbstractExpression {
     return Field(kTypeInt, PerformComparison(lhs, rhs));
   }
 
+  Field Evaluate(const RowView &row) const override {
+    Field lhs = GetChildAt(0)->Evaluate(row);
+    Field rhs = GetChildAt(1)->Evaluate(row);
+    return Field(kTypeInt, PerformComparison(lhs, rhs));
+  }
+
+  CmpBool EvaluatePredicate(const RowView &row) const override {
+    return PerformComparison(GetChildAt(0)->Evaluate(row), GetChildAt(1)->Evaluate(row));
+  }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     Field lhs = GetChildAt(0)->EvaluateJoin(left_row, right_row);
     Field rhs = GetChildAt(1)->EvaluateJoin(left_row, right_row);
@@ -36,28 +66,83 @@ class ComparisonExpression : public AbstractExpression {
   std::string GetComparisonType() { return comp_type_; }
 
  private:
+  static ComparisonType Str2Type(const std::string &comp_type) {
+    if (comp_type == "=")
+      return ComparisonType::Equal;
+    else if (comp_type == "<>")
+      return ComparisonType::NotEqual;
+    else if (comp_type == "<")
+      return ComparisonType::LessThan;
+    else if (comp_type == "<=")
+      return ComparisonType::LessThanOrEqual;
+    else if (comp_type == ">")
+      return ComparisonType::GreaterThan;
+    else if (comp_type == ">=")
+      return ComparisonType::GreaterThanOrEqual;
+    else if (comp_type == "is")
+      return ComparisonType::IsNull;
+    else if (comp_type == "not")
+      return ComparisonType::NotNull;
+    else
+      throw std::logic_error("Unsupported comparison type");
+  }
+
   CmpBool PerformComparison(const Field &lhs, const Field &rhs) const {
-    if (comp_type_ == "=")
-      return lhs.CompareEquals(rhs);
-    else if (comp_type_ == "<>")
-      return lhs.CompareNotEquals(rhs);
-    else if (comp_type_ == "<")
-      return lhs.CompareLessThan(rhs);
-    else if (comp_type_ == "<=")
-      return lhs.CompareLessThanEquals(rhs);
-    else if (comp_type_ == ">")
-      return lhs.CompareGreaterThan(rhs);
-    else if (comp_type_ == ">=")
-      return lhs.CompareGreaterThanEquals(rhs);
-    else if (comp_type_ == "is")
+    if (type_ == ComparisonType::IsNull) {
       return GetCmpBool(lhs.IsNull());
-    else if (comp_type_ == "not")
+    }
+    if (type_ == ComparisonType::NotNull) {
       return GetCmpBool(!lhs.IsNull());
-    else
-      throw std::logic_error("Unsupported comparison type");
+    }
+    if (compare_fn_ == nullptr) {
+      return PerformVirtualComparison(lhs, rhs);
+    }
+    if (lhs.IsNull() || rhs.IsNull()) {
+      return CmpBool::kNull;
+    }
+    int cmp = compare_fn_(lhs, rhs);
+    switch (type_) {
+      case ComparisonType::Equal:
+        return GetCmpBool(cmp == 0);
+      case ComparisonType::NotEqual:
+        return GetCmpBool(cmp != 0);
+      case ComparisonType::LessThan:
+        return GetCmpBool(cmp < 0);
+      case ComparisonType::LessThanOrEqual:
+        return GetCmpBool(cmp <= 0);
+      case ComparisonType::GreaterThan:
+        return GetCmpBool(cmp > 0);
+      case ComparisonType::GreaterThanOrEqual:
+        return GetCmpBool(cmp >= 0);
+      default:
+        throw std::logic_error("Unsupported comparison type");
+    }
+  }
+
+  /** Compare through the type of the left side, for sides whose type is not known ahead. */
+  CmpBool PerformVirtualComparison(const Field &lhs, const Field &rhs) const {
+    switch (type_) {
+      case ComparisonType::Equal:
+        return lhs.CompareEquals(rhs);
+      case ComparisonType::NotEqual:
+        return lhs.CompareNotEquals(rhs);
+      case ComparisonType::LessThan:
+        return lhs.CompareLessThan(rhs);
+      case ComparisonType::LessThanOrEqual:
+        return lhs.CompareLessThanEquals(rhs);
+      case ComparisonType::GreaterThan:
+        return lhs.CompareGreaterThan(rhs);
+      case ComparisonType::GreaterThanOrEqual:
+        return lhs.CompareGreaterThanEquals(rhs);
+      default:
+        throw std::logic_error("Unsupported comparison type");
+    }
   }
 
   std::string comp_type_;
+  ComparisonType type_;
+  /** Kernel of the type of both sides, nullptr if they differ. */
+  FieldCompareFn compare_fn_{nullptr};
 };
 
 #endif  // MINISQL_COMPARISON_EXPRESSION_H
@@ -31,6 +31,22 @@ class LogicExpression : public AbstractExpression {
     return Field(kTypeInt, PerformComputation(lhs, rhs));
   }
 
+  Field Evaluate(const RowView &row) const override {
+    Field lhs = GetChildAt(0)->Evaluate(row);
+    Field rhs = GetChildAt(1)->Evaluate(row);
+    return Field(kTypeInt, PerformComputation(lhs, rhs));
+  }
+
+  CmpBool EvaluatePredicate(const RowView &row) const override {
+    // the right side is not evaluated when the left one decides
+    auto l = GetChildAt(0)->EvaluatePredicate(row);
+    if ((logic_type_ == LogicType::And && l == CmpBool::kFalse) ||
+        (logic_type_ == LogicType::Or && l == CmpBool::kTrue)) {
+      return l;
+    }
+    return Combine(l, GetChildAt(1)->EvaluatePredicate(row));
+  }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     Field lhs = GetChildAt(0)->EvaluateJoin(left_row, right_row);
     Field rhs = GetChildAt(1)->EvaluateJoin(left_row, right_row);
@@ -60,8 +76,10 @@ class LogicExpression : public AbstractExpression {
   }
 
   CmpBool PerformComputation(const Field &lhs, const Field &rhs) const {
-    auto l = GetFieldAsCmpBool(lhs);
-    auto r = GetFieldAsCmpBool(rhs);
+    return Combine(GetFieldAsCmpBool(lhs), GetFieldAsCmpBool(rhs));
+  }
+
+  CmpBool Combine(CmpBool l, CmpBool r) const {
     switch (logic_type_) {
       case LogicType::And:
         if (l == CmpBool::kFalse || r == CmpBool::kFalse) {
@@ -0,0 +1,77 @@
+#ifndef MINISQL_FIELD_KERNELS_H
+#define MINISQL_FIELD_KERNELS_H
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "record/field.h"
+
+/**
+ * Compare two non-null fields of the same type.
+ * @return a negative number, zero or a positive number as lhs is less than, equal to or greater than rhs
+ */
+using FieldCompareFn = int (*)(const Field &lhs, const Field &rhs);
+
+/**
+ * Hash a non-null field, fields that compare equal hash to the same value.
+ */
+using FieldHashFn = size_t (*)(const Field &field);
+
+/**
+ * FieldKernel holds the comparison and hash of one type, specialized at compile time. Where Field::CompareLessThan and
+ * the like go through Type::type_singletons_ and return a CmpBool for every call, a kernel is picked once per column
+ * (see Schema::GetCompareFn) and called directly. Nulls are left to the caller.
+ */
+template <TypeId type>
+struct FieldKernel;
+
+template <>
+struct FieldKernel<TypeId::kTypeInt> {
+  static int Compare(const Field &lhs, const Field &rhs) {
+    return (lhs.value_.integer_ > rhs.value_.integer_) - (lhs.value_.integer_ < rhs.value_.integer_);
+  }
+
+  static size_t Hash(const Field &field) { return std::hash<int32_t>()(field.value_.integer_); }
+};
+
+template <>
+struct FieldKernel<TypeId::kTypeFloat> {
+  static int Compare(const Field &lhs, const Field &rhs) {
+    return (lhs.value_.float_ > rhs.value_.float_) - (lhs.value_.float_ < rhs.value_.float_);
+  }
+
+  static size_t Hash(const Field &field) {
+    // 0.0 and -0.0 are equal, and have to hash alike
+    float value = field.value_.float_ == 0 ? 0 : field.value_.float_;
+    return std::hash<float>()(value);
+  }
+};
+
+template <>
+struct FieldKernel<TypeId::kTypeChar> {
+  static int Compare(const Field &lhs, const Field &rhs) {
+    int ret = memcmp(lhs.value_.chars_, rhs.value_.chars_, std::min(lhs.len_, rhs.len_));
+    if (ret == 0) {
+      return (lhs.len_ > rhs.len_) - (lhs.len_ < rhs.len_);
+    }
+    return ret;
+  }
+
+  static size_t Hash(const Field &field) {
+    return std::hash<std::string_view>()(std::string_view(field.value_.chars_, field.len_));
+  }
+};
+
+/**
+ * @return the compare kernel of a type
+ */
+FieldCompareFn GetFieldCompareFn(TypeId type_id);
+
+/**
+ * @return the hash kernel of a type
+ */
+FieldHashFn GetFieldHashFn(TypeId type_id);
+
+#endif  // MINISQL_FIELD_KERNELS_H
@@ -5,21 +5,41 @@
 #include <vector>
 
 #include "common/macros.h"
+#include "common/memory_arena.h"
 #include "common/rowid.h"
 #include "record/field.h"
 #include "record/schema.h"
 
+class BufferPoolManager;
+
+/**
+ * On-page format of a row. Pages written before the compact format existed hold tagged rows, and keep them.
+ */
+enum class RowFormat : uint8_t {
+  kTagged = 0,
+  kCompact = 1,
+};
+
 /**
- *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
+ *  Compact row format (sizes in bytes, offsets are fixed by the schema, see Schema::GetFieldOffset()):
+ * ------------------------------------------------------------------------------------
+ * | Null bitmap | Fixed-width values (4 each) | CHAR end offsets (2 each) | CHAR data |
+ * ------------------------------------------------------------------------------------
+ *  Fixed-width columns come first in column order, a null one keeps its place and is zeroed. The data of a CHAR
+ *  column ends at its end offset and starts at the end of the previous CHAR column, or at Schema::GetFixedLength()
+ *  for the first one. The row id is not stored, it is given by the place of the row.
  *
+ *  A CHAR value longer than CHAR_OVERFLOW_THRESHOLD may be kept out of line, in a chain of overflow pages (see
+ *  OverflowPage). Its end offset then has OVERFLOW_FLAG set and its data is a stub:
+ *  --------------------------------------------------------------------------------
+ *  | Length (4) | First overflow page (4) | Prefix (CHAR_OVERFLOW_PREFIX_LEN) |
+ *  --------------------------------------------------------------------------------
+ *  The chain holds the rest of the value, after the prefix. Reading the other columns never touches it.
  *
+ *  Tagged row format:
+ * ------------------------------------------------------------------------------------------
+ * | RowId (8) | Field Nums (4) | Null bitmap | Type (4) | Field-1 | ... | Type (4) | Field-N |
+ * ------------------------------------------------------------------------------------------
  */
 class Row {
  public:
@@ -36,8 +56,11 @@ class Row {
 
   void destroy() {
     if (!fields_.empty()) {
-      for (auto field : fields_) {
-        delete field;
+      // fields carved from an arena own nothing, and are freed with it
+      if (arena_ == nullptr) {
+        for (auto field : fields_) {
+          delete field;
+        }
       }
       fields_.clear();
     }
@@ -58,39 +81,95 @@ class Row {
   /**
    * Row copy function, deep copy
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
-    for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
-    }
+  Row(const Row &other) : rid_(other.rid_) { CopyFields(other); }
+
+  /**
+   * Row move function, the fields are handed over
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), arena_(other.arena_) {
+    other.fields_.clear();
   }
 
   /**
    * Assign operator, deep copy
    */
   Row &operator=(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
-    for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+    if (this != &other) {
+      destroy();
+      arena_ = nullptr;
+      rid_ = other.rid_;
+      CopyFields(other);
+    }
+    return *this;
+  }
+
+  /**
+   * Move assign operator, the fields are handed over
+   */
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      destroy();
+      rid_ = other.rid_;
+      fields_ = std::move(other.fields_);
+      other.fields_.clear();
+      arena_ = other.arena_;
     }
     return *this;
   }
 
+  /**
+   * Drop the fields of the row. Fields added from now on are carved from an arena, which must outlive the row, or
+   * allocated on the heap if arena is nullptr.
+   */
+  void Reset(MemoryArena *arena) {
+    destroy();
+    arena_ = arena;
+  }
+
+  /** @return the arena the fields of the row are carved from, nullptr if they are on the heap */
+  inline MemoryArena *GetArena() const { return arena_; }
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
+   * @param overflow_pages first overflow page of the value of each column, INVALID_PAGE_ID for a value kept in the
+   * row; nullptr if every value is kept in the row. Only a compact row keeps values out of line.
    */
-  uint32_t SerializeTo(char *buf, Schema *schema) const;
+  uint32_t SerializeTo(char *buf, Schema *schema, RowFormat format = RowFormat::kCompact,
+                       const page_id_t *overflow_pages = nullptr) const;
 
-  uint32_t DeserializeFrom(char *buf, Schema *schema);
+  /**
+   * A tagged row also sets the row id to the one it was serialized with, a compact row leaves it as it is.
+   * @param buffer_pool_manager reads the values kept out of line, a row that has some cannot be read without it
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, RowFormat format = RowFormat::kCompact,
+                           BufferPoolManager *buffer_pool_manager = nullptr);
 
   /**
    * For empty row, return 0
    * For non-empty row with null fields, eg: |null|null|null|, return header size only
    * @return
    */
-  uint32_t GetSerializedSize(Schema *schema) const;
+  uint32_t GetSerializedSize(Schema *schema, RowFormat format = RowFormat::kCompact,
+                             const page_id_t *overflow_pages = nullptr) const;
+
+  /**
+   * Read a value kept out of line from its stub into buf, which has room for the length given by the stub.
+   * @return false if a page of the chain could not be fetched
+   */
+  static bool ReadOverflowValue(const char *stub, char *buf, BufferPoolManager *buffer_pool_manager);
+
+  /** @return the length of a value kept out of line */
+  static inline uint32_t GetOverflowLength(const char *stub) { return MACH_READ_UINT32(stub); }
+
+  /** @return the first overflow page of a value kept out of line */
+  static inline page_id_t GetOverflowPageId(const char *stub) {
+    return MACH_READ_FROM(page_id_t, stub + sizeof(uint32_t));
+  }
+
+  /** Set in the end offset of a CHAR column whose value is kept out of line. */
+  static constexpr uint16_t OVERFLOW_FLAG = 0x8000;
+  /** Size of the stub a value kept out of line leaves in a compact row. */
+  static constexpr uint32_t OVERFLOW_STUB_SIZE = sizeof(uint32_t) + sizeof(page_id_t) + CHAR_OVERFLOW_PREFIX_LEN;
 
   void GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row);
 
@@ -110,8 +189,27 @@ class Row {
   bool CompareEqualTo(const Row *other);
 
  private:
+  /**
+   * Copy the fields of another row onto the heap, together with the CHAR data of an arena row.
+   */
+  void CopyFields(const Row &other) {
+    fields_.reserve(other.fields_.size());
+    for (auto field : other.fields_) {
+      if (other.arena_ != nullptr && field->GetTypeId() == TypeId::kTypeChar && !field->IsNull()) {
+        fields_.push_back(new Field(TypeId::kTypeChar, field->value_.chars_, field->len_, true));
+      } else {
+        fields_.push_back(new Field(*field));
+      }
+    }
+  }
+
+  uint32_t SerializeCompact(char *buf, Schema *schema, const page_id_t *overflow_pages) const;
+
+  uint32_t DeserializeCompact(char *buf, Schema *schema, BufferPoolManager *buffer_pool_manager);
+
   RowId rid_{};
   std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  MemoryArena *arena_{nullptr};
 };
 
 #endif  // MINISQL_ROW_H
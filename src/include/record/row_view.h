@@ -0,0 +1,78 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * RowView reads a row in place, from its serialized bytes in a page, without owning them. A field is decoded only when
+ * it is asked for, and nothing is allocated but the CHAR data of a materialized row. The view is valid as long as the
+ * page stays pinned and latched, rows that outlive it are copied out with Materialize(). A value kept out of line is
+ * read from its overflow pages only when its column is asked for.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  /**
+   * @param buffer_pool_manager reads the values kept out of line, if the row may have some
+   */
+  RowView(const char *data, const Schema *schema, RowFormat format, RowId rid,
+          BufferPoolManager *buffer_pool_manager = nullptr)
+      : data_(data), schema_(schema), format_(format), rid_(rid), buffer_pool_manager_(buffer_pool_manager) {}
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return schema_->GetColumnCount(); }
+
+  bool IsNull(uint32_t idx) const;
+
+  /**
+   * @return the field of a column, a CHAR field points into the page instead of holding a copy unless its value is
+   * kept out of line; such a value comes back null if its chain cannot be read
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * @return the first overflow page of the value of a column, INVALID_PAGE_ID if the value is kept in the row
+   */
+  page_id_t GetOverflowPageId(uint32_t idx) const;
+
+  /**
+   * Copy all the fields into a row that owns them, with the row id of the view.
+   * @param arena where the fields and their CHAR data are allocated, nullptr for the heap
+   */
+  void Materialize(Row *row, MemoryArena *arena = nullptr) const;
+
+  /**
+   * Copy the columns of an output schema into a row, each column is taken from the field at its table index.
+   */
+  void Materialize(Row *row, const Schema *output_schema, MemoryArena *arena = nullptr) const;
+
+ private:
+  /**
+   * Find the value of a field. A compact row has it at the offset of its column, a tagged row is walked up to it.
+   * @param[out] value address of the value, or of the CHAR data, or of the stub of a value kept out of line
+   * @param[out] len length of the CHAR data or of the stub
+   * @return false if the field is null
+   */
+  bool Locate(uint32_t idx, const char **value, uint32_t *len) const;
+
+  /** @return whether the value of a column is kept out of line */
+  bool IsOverflow(uint32_t idx) const;
+
+  /**
+   * @return a new field with the value of a column and a copy of its CHAR data, in the arena if there is one
+   */
+  Field *CopyField(uint32_t idx, MemoryArena *arena) const;
+
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowFormat format_{RowFormat::kCompact};
+  RowId rid_{};
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+};
+
+#endif  // MINISQL_ROW_VIEW_H
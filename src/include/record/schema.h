@@ -6,6 +6,7 @@
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/column.h"
+#include "record/field_kernels.h"
 
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
@@ -13,7 +14,9 @@
 class Schema {
  public:
   explicit Schema(const std::vector<Column *> columns, bool is_manage_ = true)
-      : columns_(std::move(columns)), is_manage_(is_manage_) {}
+      : columns_(std::move(columns)), is_manage_(is_manage_) {
+    ComputeLayout();
+  }
 
   ~Schema() {
     if (is_manage_) {
@@ -39,6 +42,30 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /** @return size of the null bitmap of a compact row */
+  inline uint32_t GetNullBitmapSize() const { return null_bitmap_size_; }
+
+  /**
+   * @return offset of a field in a compact row: the value of a fixed-width column, or the entry of a CHAR column in
+   * the offset array
+   */
+  inline uint32_t GetFieldOffset(const uint32_t column_index) const { return field_offsets_[column_index]; }
+
+  /** @return offset of the end offset of the first CHAR column in a compact row */
+  inline uint32_t GetCharOffsetsBegin() const { return char_offsets_begin_; }
+
+  /** @return size of the part of a compact row before the CHAR data, which is the same for every row */
+  inline uint32_t GetFixedLength() const { return fixed_length_; }
+
+  /** @return whether a row may keep values out of line, i.e. a CHAR column is longer than CHAR_OVERFLOW_THRESHOLD */
+  inline bool MayOverflow() const { return may_overflow_; }
+
+  /** @return the compare kernel of a column, picked for its type when the schema is built */
+  inline FieldCompareFn GetCompareFn(const uint32_t column_index) const { return compare_fns_[column_index]; }
+
+  /** @return the hash kernel of a column */
+  inline FieldHashFn GetHashFn(const uint32_t column_index) const { return hash_fns_[column_index]; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -83,9 +110,23 @@ class Schema {
   bool CompareEqualTo(const Schema *other);
 
  private:
+  /**
+   * Place the columns in the compact row format, see Row, and pick the kernels of each column.
+   */
+  void ComputeLayout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  // layout of a compact row, computed once from the columns
+  std::vector<uint32_t> field_offsets_;
+  uint32_t null_bitmap_size_{0};
+  uint32_t char_offsets_begin_{0};
+  uint32_t fixed_length_{0};
+  bool may_overflow_{false};
+  // per-column kernels, see FieldKernel
+  std::vector<FieldCompareFn> compare_fns_;
+  std::vector<FieldHashFn> hash_fns_;
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,131 @@
+#ifndef MINISQL_ASYNC_IO_ENGINE_H
+#define MINISQL_ASYNC_IO_ENGINE_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+
+class IoBatch;
+
+/**
+ * One read or write of a contiguous range of a file, owned by an IoBatch.
+ */
+struct IoRequest {
+  bool is_write_{false};
+  int fd_{-1};
+  char *buf_{nullptr};
+  // buffers of a vectored write, which fills the range from several places in memory; buf_ is not used then
+  std::vector<iovec> iov_;
+  size_t len_{0};
+  size_t offset_{0};
+  // 0 if the request succeeded, otherwise the errno of the failure
+  int error_{0};
+  IoBatch *batch_{nullptr};
+};
+
+/**
+ * IoBatch collects page reads and writes that are submitted to an AsyncIoEngine together and waited for together.
+ * Requests are added before the batch is submitted, a submitted batch must not be changed until Wait() returns.
+ * A read that hits the end of the file fills the rest of its buffer with zeros, like DiskManager::ReadPage.
+ */
+class IoBatch {
+  friend class AsyncIoEngine;
+
+ public:
+  IoBatch() = default;
+
+  /** A batch that was submitted is waited for before it goes away, its requests point into it. */
+  ~IoBatch() { Wait(); }
+
+  DISALLOW_COPY_AND_MOVE(IoBatch);
+
+  void AddRead(int fd, char *buf, size_t len, size_t offset);
+
+  void AddWrite(int fd, const char *buf, size_t len, size_t offset);
+
+  /** Add one write of the buffers of iov, one after the other, to the file range starting at offset. */
+  void AddWritev(int fd, std::vector<iovec> iov, size_t offset);
+
+  inline size_t Size() const { return requests_.size(); }
+
+  inline bool Empty() const { return requests_.empty(); }
+
+  /** Block until every request of a submitted batch has completed, returns at once if nothing is in flight. */
+  void Wait();
+
+  /** Number of requests that failed, valid after Wait(). */
+  size_t GetErrorCount() const;
+
+  std::vector<IoRequest> &GetRequests() { return requests_; }
+
+ private:
+  void Complete(size_t num_requests);
+
+  std::vector<IoRequest> requests_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  size_t pending_{0};
+};
+
+/**
+ * AsyncIoEngine keeps many page reads and writes in flight at once. Submit() only queues the requests of a batch and
+ * returns, IoBatch::Wait() blocks until they are done, so a caller can hand the engine all the pages it needs and
+ * overlap their I/O instead of paying one device round trip per page.
+ *
+ * On Linux the engine is built on io_uring: requests go straight into the submission ring and one thread reaps the
+ * completion ring. Where io_uring is not available (older kernels, seccomp sandboxes, other systems) the engine falls
+ * back to a pool of threads doing pread/pwrite, which gives the same interface with less depth per thread.
+ */
+class AsyncIoEngine {
+ public:
+  enum class Type { IO_URING, THREAD_POOL };
+
+  virtual ~AsyncIoEngine() = default;
+
+  /**
+   * Create an engine of the given type that keeps at most queue_depth requests in flight.
+   * @return an io_uring engine, or a thread pool engine if io_uring was not asked for or cannot be set up
+   */
+  static std::unique_ptr<AsyncIoEngine> Create(Type type, size_t queue_depth);
+
+  /**
+   * The engine shared by all disk managers, created on first use: io_uring if the kernel allows it, unless the
+   * MINISQL_IO_ENGINE environment variable is set to "threads".
+   */
+  static AsyncIoEngine *Default();
+
+  /**
+   * Start all the requests of a batch. Submit may block while the engine is at its queue depth.
+   */
+  void Submit(IoBatch &batch);
+
+  virtual Type GetType() const = 0;
+
+  std::string GetName() const { return GetType() == Type::IO_URING ? "io_uring" : "thread_pool"; }
+
+ protected:
+  /** Queue the requests, which are not empty. */
+  virtual void SubmitRequests(std::vector<IoRequest> &requests) = 0;
+
+  /**
+   * Finish a request synchronously, starting after the first done bytes. Reads that hit the end of the file are
+   * zero-filled, errors are logged and recorded in the request.
+   */
+  static void FinishSync(IoRequest *request, size_t done);
+
+  /** FinishSync() of a vectored write. */
+  static void FinishVectoredSync(IoRequest *request, size_t done);
+
+  /** Mark a request as completed and wake up the waiter of its batch if it was the last one. */
+  static void Complete(IoRequest *request) { request->batch_->Complete(1); }
+};
+
+#endif  // MINISQL_ASYNC_IO_ENGINE_H
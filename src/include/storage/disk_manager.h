@@ -2,15 +2,20 @@
 #define DISK_MGR_H
 
 #include <atomic>
-#include <fstream>
+#include <climits>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/async_io_engine.h"
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +24,35 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages are read and written with pread/pwrite on a plain file descriptor, so there is no shared seek cursor and page
+ * I/O from different threads runs in parallel; only the meta page and the bitmap pages are serialized. Writes are not
+ * flushed one by one: they are made durable by Sync(), which FlushAllPages() and Close() call.
+ *
+ * The bitmaps of all extents are loaded when the file is opened and kept in memory, so allocating or freeing a page
+ * does no I/O. A bitmap that changed is written back by the next Sync(), together with the meta page.
+ *
+ * Objects that grow page by page (table heaps, B+ trees) allocate with an owner: each owner reserves a run of RUN_SIZE
+ * contiguous pages and is handed its pages in order, so that its page chain stays sequential on disk instead of being
+ * interleaved with the pages of other objects. Runs live in memory only: the pages of a run that were not handed out
+ * are written as free by Sync(), and they go back to the bitmap when the owner releases its run.
+ *
+ * Pages can also be read and written in batches through the shared AsyncIoEngine: AddRead()/AddWrite() put pages
+ * into an IoBatch, SubmitBatch() starts all of them at once and IoBatch::Wait() waits for them. AddWrites() turns a
+ * set of pages into as few writes as possible, so that a flush writes the file front to back in large requests.
+ *
+ * A file opened read-only is mapped into memory instead. GetMappedPage() returns the address of a page in the mapping,
+ * which the buffer pool uses as the data of the frame holding the page, so a miss copies nothing. Nothing is ever
+ * written to a read-only file: pages cannot be allocated or freed, and page writes and Sync() do nothing.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * Open or create a database file.
+   * @param read_only open an existing file without ever writing to it, and map it into memory
+   * @throw std::runtime_error if the file cannot be opened or mapped, or was created with another page size
+   */
+  explicit DiskManager(const std::string &db_file, bool read_only = false);
 
   ~DiskManager() {
     if (!closed) {
@@ -42,22 +72,94 @@ class DiskManager {
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Add the read of a page to a batch. A page past the end of the file is zeroed right away and not queued.
+   */
+  void AddRead(IoBatch &batch, page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Add the write of a page to a batch, page_data must stay untouched until the batch completes.
+   */
+  void AddWrite(IoBatch &batch, page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Add the writes of many pages to a batch, sorted by their place in the file. Pages that are next to each other in
+   * the file are merged into one vectored write of up to MAX_COALESCED_PAGES pages. The data of the pages must stay
+   * untouched until the batch completes.
+   * @param pages logical page id and data of each page, sorted in place
+   * @return the number of writes added
+   */
+  size_t AddWrites(IoBatch &batch, std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * Start the I/O of a batch, which may hold pages of several disk managers; IoBatch::Wait() waits for it.
+   */
+  static void SubmitBatch(IoBatch &batch) { AsyncIoEngine::Default()->Submit(batch); }
+
+  /**
+   * Address of a page in the mapping of a read-only file. The mapping is not writable, a write through it faults.
+   * @return nullptr if the file is not mapped or the page lies past its end
+   */
+  char *GetMappedPage(page_id_t logical_page_id);
+
+  inline bool IsReadOnly() const { return read_only_; }
+
   /**
    * Get next free page from disk
-   * @return logical page id of allocated page
+   * @return logical page id of allocated page, INVALID_PAGE_ID if the file is full or read-only
    */
   page_id_t AllocatePage();
 
+  /**
+   * Get next free page for an owner, from the run it reserved with AllocateExtent(). A new run is reserved when the
+   * current one is used up, and if no extent has a whole run free the page is allocated like AllocatePage().
+   * @param owner any address that identifies the owner while it lives, e.g. the TableHeap; nullptr for no owner
+   * @return logical page id of allocated page
+   */
+  page_id_t AllocatePage(const void *owner);
+
+  /**
+   * Reserve a run of RUN_SIZE contiguous free pages for an owner, replacing its current run. The pages it did not
+   * use of the old run are freed.
+   * @return false if no extent has RUN_SIZE contiguous free pages left
+   */
+  bool AllocateExtent(const void *owner);
+
+  /**
+   * Free the pages of an owner's run that were not handed out, e.g. when the owner is dropped.
+   */
+  void ReleaseExtent(const void *owner);
+
   /**
    * Free this page and reset bit map
    */
   void DeAllocatePage(page_id_t logical_page_id);
 
+  /**
+   * Free a batch of pages, e.g. the pages of a dropped table. The pages are grouped by extent, and the meta page
+   * counters of each extent are updated once for its whole group.
+   */
+  void DeAllocatePages(std::vector<page_id_t> page_ids);
+
   /**
    * Return whether specific logical_page_id is free
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * Write the meta page and the bitmaps that changed, then fsync the file, so that every page written so far
+   * survives a crash.
+   */
+  void Sync();
+
+  /**
+   * Cut the free pages at the end of the file off, down to the last allocated page, and Sync(). The runs of all owners
+   * are released first, so that pages reserved but not handed out do not hold the end of the file. Pages past the new
+   * end must not be in use anywhere, e.g. dirty in the buffer pool.
+   * @return the number of pages the file shrank by
+   */
+  size_t Truncate();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -71,11 +173,20 @@ class DiskManager {
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+  // number of extents a file can have, so that every physical page id fits in a page_id_t (about 8 TB of pages)
+  static constexpr uint32_t MAX_EXTENTS = (INT32_MAX - 1) / (BITMAP_SIZE + 1);
+
+  // number of pages an owner reserves at a time, one word of a bitmap
+  static constexpr size_t RUN_SIZE = 64;
+
+  // largest number of adjacent pages AddWrites() merges into one write
+  static constexpr size_t MAX_COALESCED_PAGES = 64;
+
  private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  static size_t GetFileSize(int fd);
 
   /**
    * Read physical page from disk
@@ -92,13 +203,49 @@ class DiskManager {
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * Free the pages of a run from page_id on, which were never handed out. Must be called with db_io_latch_ held.
+   */
+  void FreeRun(page_id_t page_id, page_id_t end);
+
+  /**
+   * Count a page of an extent as allocated or freed in the meta page. Must be called with db_io_latch_ held.
+   */
+  void CountPage(uint32_t extent_id, bool allocated);
+
+  /**
+   * Add an extent past the last one, with an empty bitmap. Must be called with db_io_latch_ held.
+   */
+  void AddExtent();
+
+  /** @return physical page id of the bitmap page of an extent */
+  static inline page_id_t BitmapPageId(uint32_t extent_id) { return extent_id * (BITMAP_SIZE + 1) + 1; }
+
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  bool read_only_{false};
+  // private mapping of a read-only file and its length, the file cannot grow while it is mapped
+  char *mapping_{nullptr};
+  size_t mapping_size_{0};
+  // size of the file, kept here so that reads need no stat() to tell a page past the end of the file
+  std::atomic<size_t> file_size_{0};
+  // protects the meta page and the bitmap pages, page reads and writes do not take it
   std::recursive_mutex db_io_latch_;
   bool closed{false};
+  // bitmap of every extent of the file, protected by db_io_latch_
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  // whether each bitmap changed since it was last written
+  std::vector<bool> dirty_bitmaps_;
+  // pages of each extent handed out, the meta page only has room for the first META_EXTENTS of them
+  std::vector<uint32_t> extent_used_;
+  // no extent below this one has a free page
+  uint32_t free_extent_hint_{0};
+  // no extent below this one has a free run
+  uint32_t run_extent_hint_{0};
+  // pages [first, second) of the current run of each owner were reserved and not handed out yet
+  std::unordered_map<const void *, std::pair<page_id_t, page_id_t>> runs_;
   char meta_data_[PAGE_SIZE];
 };
 
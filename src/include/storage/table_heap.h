@@ -1,13 +1,32 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
 #include "page/header_page.h"
+#include "page/overflow_page.h"
 #include "page/table_page.h"
 #include "recovery/log_manager.h"
 #include "storage/table_iterator.h"
 
+/**
+ * Called by TableHeap::Vacuum() for every tuple it moves, with a view of the tuple at its new place and its old row id.
+ * The values the tuple keeps out of line are only read if the view is asked for them.
+ */
+using TupleMoveFunc = std::function<void(const RowView &view, const RowId &old_rid)>;
+
+/**
+ * What a vacuum of a table heap did.
+ */
+struct VacuumStats {
+  size_t purged_tuples_{0};     // tuples marked as deleted whose space was given back
+  size_t moved_tuples_{0};      // tuples moved to another page, each one got a new row id
+  size_t freed_pages_{0};       // pages that were emptied and left the heap
+  size_t relocated_pages_{0};   // pages moved to a free page lower in the file
+};
+
 class TableHeap {
   friend class TableIterator;
 
@@ -28,7 +47,7 @@ class TableHeap {
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The recovery performing the insert
-   * @return true iff the insert is successful
+   * @return true iff the insert is successful, false if the database is read-only
    */
   bool InsertTuple(Row &row, Txn *txn);
 
@@ -67,29 +86,56 @@ class TableHeap {
    * Read a tuple from the table.
    * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
    * @param[in] txn recovery performing the read
+   * @param[in] strategy buffer access strategy of a bulk reader, nullptr for a single read
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  bool GetTuple(Row *row, Txn *txn);
+  bool GetTuple(Row *row, Txn *txn, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Point a view at a tuple in its page, without copying it.
+   * @param[in/out] guard holds the page of the tuple on return, and is reused if it already holds it; the view is
+   * valid as long as the guard is
+   * @return true if the tuple exists
+   */
+  bool GetTupleView(const RowId &rid, ReadPageGuard &guard, RowView *view, BufferAccessStrategy *strategy = nullptr);
 
   void FreeTableHeap() {
+    BufferAccessStrategy strategy(buffer_pool_manager_);
+    std::vector<page_id_t> overflow_pages;
     auto next_page_id = first_page_id_;
     while (next_page_id != INVALID_PAGE_ID) {
       auto old_page_id = next_page_id;
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
-      assert(page != nullptr);
-      next_page_id = page->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(old_page_id, false);
+      {
+        ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(old_page_id, &strategy);
+        assert(guard);
+        auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+        page->GetOverflowPages(schema_, &overflow_pages);
+        next_page_id = page->GetNextPageId();
+      }
       buffer_pool_manager_->DeletePage(old_page_id);
     }
+    FreeOverflowPages(overflow_pages);
   }
 
   /**
-   * Free table heap and release storage in disk file
+   * Free table heap and release storage in disk file. The page chain is walked iteratively, reading ahead of the walk,
+   * and its pages are freed in batches of DEFAULT_DELETE_BATCH_PAGES. The heap cannot be used afterwards.
+   * Nothing is freed in a read-only database.
+   * @return the number of pages freed
    */
-  void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
+  size_t DeleteTable();
 
   /**
-   * @return the begin iterator of this table
+   * Compact the table: apply the deletes of the tuples marked as deleted, move tuples out of the pages with the
+   * highest ids into the free space of the pages with the lowest ids, de-allocate the pages that end up empty, and
+   * move the remaining pages to the lowest free pages of the file. Afterwards the pages at the end of the file are
+   * free as far as this table is concerned. The first page of the table never moves.
+   * @param on_move told about every tuple that moved, so that the caller can update the indexes of the table
+   */
+  VacuumStats Vacuum(Txn *txn, const TupleMoveFunc &on_move);
+
+  /**
+   * @return the begin iterator of this table, the iterator walks the table through its own buffer access strategy
    */
   TableIterator Begin(Txn *txn);
 
@@ -114,9 +160,9 @@ class TableHeap {
         log_manager_(log_manager),
         lock_manager_(lock_manager) {
     page_id_t page_id;
-    TablePage* page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(page_id));
+    BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(page_id, this);
     this->first_page_id_ = page_id;
-    page->Init(page_id, INVALID_PAGE_ID, log_manager, txn);
+    reinterpret_cast<TablePage *>(guard.GetPageMut())->Init(page_id, INVALID_PAGE_ID, log_manager, txn);
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
@@ -127,6 +173,39 @@ class TableHeap {
         log_manager_(log_manager),
         lock_manager_(lock_manager) {}
 
+  /**
+   * Move tuples from one page to another until the other page is full.
+   * @return true if the page moved from is left without tuples
+   */
+  bool MoveTuples(page_id_t from_page_id, page_id_t to_page_id, Txn *txn, const TupleMoveFunc &on_move,
+                  VacuumStats &stats);
+
+  /**
+   * Take a page that is not the first one out of the page chain and de-allocate it.
+   */
+  void UnlinkPage(page_id_t page_id);
+
+  /**
+   * Put a tuple in the first page with room for it, chaining a new page if none has.
+   * @param overflow_pages first overflow page of each value of the row kept out of line, empty if there is none
+   */
+  bool PlaceTuple(Row &row, Txn *txn, const std::vector<page_id_t> &overflow_pages);
+
+  /**
+   * Write the CHAR values of a row longer than CHAR_OVERFLOW_THRESHOLD to new overflow chains, so that the tuple keeps
+   * only their stubs.
+   * @param[out] overflow_pages first overflow page of the value of each column, INVALID_PAGE_ID for a value kept in
+   * the row; left empty if every value is kept in the row
+   * @return false if a chain could not be written, nothing is left allocated then
+   */
+  bool SpillValues(const Row &row, std::vector<page_id_t> *overflow_pages);
+
+  /**
+   * Free overflow chains, INVALID_PAGE_ID entries are skipped.
+   * @return the number of pages freed
+   */
+  size_t FreeOverflowPages(const std::vector<page_id_t> &overflow_pages);
+
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
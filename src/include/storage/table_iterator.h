@@ -1,9 +1,15 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <memory>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/page_guard.h"
+#include "buffer/read_ahead_window.h"
 #include "common/rowid.h"
 #include "concurrency/txn.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class TableHeap;
 
@@ -11,7 +17,8 @@ class TableIterator {
 public:
  // you may define your own constructor based on your member variables
  explicit TableIterator();
- explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn);
+ explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn,
+                        std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
 
  TableIterator(const TableIterator &other);
 
@@ -25,6 +32,17 @@ public:
 
   Row *operator->();
 
+  /**
+   * View the current row in its page, which stays pinned and read latched while the iterator moves on inside it, until
+   * Release(). Nothing must write the page meanwhile.
+   */
+  const RowView &View();
+
+  /**
+   * Let go of the page held for View().
+   */
+  void Release() { guard_.Drop(); }
+
   TableIterator &operator=(const TableIterator &itr) noexcept;
 
   TableIterator &operator++();
@@ -37,6 +55,10 @@ private:
   RowId rid;
   Txn *txn;
   Row row;
+  std::shared_ptr<BufferAccessStrategy> strategy_;  // shared by the copies of an iterator, keeps scans out of the LRU
+  ReadAheadWindow read_ahead_;                      // how far ahead of the scan the page chain is prefetched
+  ReadPageGuard guard_;                             // page of the current row while it is viewed, not copied
+  RowView view_;
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
@@ -17,38 +17,56 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
       processor_(KM),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {
-  auto page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
+  // By default a node holds as many entries as fit into a page.
+  if (leaf_max_size_ == UNDEFINED_SIZE) {
+    leaf_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId)) - 1;
+  }
+  if (internal_max_size_ == UNDEFINED_SIZE) {
+    internal_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId)) - 1;
+  }
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(INDEX_ROOTS_PAGE_ID);
+  auto page = reinterpret_cast<IndexRootsPage *>(guard.GetPage()->GetData());
   if (!page->GetRootId(index_id_, &root_page_id_)) {
     root_page_id_ = INVALID_PAGE_ID;
   }
-  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
-  buffer_pool_manager_->UnpinPage(root_page_id_, true);
 }
 
-void BPlusTree::Destroy(page_id_t current_page_id) {
-    if (IsEmpty())
-      return;
-    if (current_page_id == INVALID_PAGE_ID)
-      return;
-    auto page = buffer_pool_manager_->FetchPage(current_page_id);
-    auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-    if (node->IsLeafPage()) {
-      auto *leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
-      leaf_node->SetSize(0);
-      buffer_pool_manager_->UnpinPage(current_page_id, true);
-      buffer_pool_manager_->DeletePage(current_page_id);
-      return;
-    }
-    auto *internal_node = reinterpret_cast<InternalPage *>(page->GetData());
-    for (int i = 0; i < internal_node->GetSize(); ++i) {
-      Destroy(internal_node->ValueAt(i));
+void BPlusTree::Destroy() {
+  if (IsEmpty() || IsReadOnly()) {
+    return;
+  }
+  // Every leaf is on the last level, so only the internal pages have to be read to find all the pages of the tree.
+  int height = GetHeight();
+  vector<std::pair<page_id_t, int>> pending{{root_page_id_, 1}};
+  vector<page_id_t> batch;
+  batch.reserve(DEFAULT_DELETE_BATCH_PAGES);
+  while (!pending.empty()) {
+    auto [page_id, level] = pending.back();
+    pending.pop_back();
+    if (level < height) {
+      BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(page_id);
+      if (!guard) {
+        throw std::runtime_error("Out of memory");
+      }
+      auto *internal_node = guard.As<InternalPage>();
+      for (int i = 0; i < internal_node->GetSize(); ++i) {
+        pending.emplace_back(internal_node->ValueAt(i), level + 1);
+      }
     }
-    internal_node->SetSize(0);
-    buffer_pool_manager_->UnpinPage(current_page_id, true);
-    buffer_pool_manager_->DeletePage(current_page_id);
-    if (current_page_id == root_page_id_) {
-      root_page_id_ = INVALID_PAGE_ID;
+    batch.push_back(page_id);
+    if (batch.size() == DEFAULT_DELETE_BATCH_PAGES) {
+      buffer_pool_manager_->DeletePages(batch);
+      batch.clear();
     }
+  }
+  buffer_pool_manager_->DeletePages(batch);
+  buffer_pool_manager_->ReleaseExtent(this);
+  root_page_id_ = INVALID_PAGE_ID;
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(INDEX_ROOTS_PAGE_ID);
+  if (!guard) {
+    throw std::runtime_error("Out of memory");
+  }
+  guard.AsMut<IndexRootsPage>()->Delete(index_id_);
 }
 
 /*
@@ -59,6 +77,21 @@ bool BPlusTree::IsEmpty() const {
   return root_page_id_ == INVALID_PAGE_ID;
 }
 
+int BPlusTree::GetHeight() {
+  int height = 0;
+  page_id_t page_id = root_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    if (!guard) {
+      break;
+    }
+    height++;
+    auto *node = guard.As<BPlusTreePage>();
+    page_id = node->IsLeafPage() ? INVALID_PAGE_ID : guard.As<InternalPage>()->ValueAt(0);
+  }
+  return height;
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -67,41 +100,20 @@ bool BPlusTree::IsEmpty() const {
  * This method is used for point query
  * @return : true means key exists
  */
-
- /**
- * SHIT
- **/
 bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-
   // Find the leaf page that contains the input key
   if (IsEmpty()) return false;
-  Page *page = FindLeafPage(key,root_page_id_);
-  auto *leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
-
-  // Lock the page for read
-  page->RLatch();
-  // transaction->GetSharedLockSet().insert(RowId(leaf_node->GetPageId()));
+  BasicPageGuard guard = FindLeafPage(key, root_page_id_);
+  auto *leaf_node = reinterpret_cast<LeafPage *>(guard.GetPage()->GetData());
 
   RowId rid;
   // If the key is found in the leaf page
   if (leaf_node->Lookup(key, rid, processor_)) {
     // Add the value associated with the key to the result vector
-    page->RUnlatch();
-    // transaction->GetSharedLockSet().erase(RowId(leaf_node->GetPageId()));
     result.push_back(rid);
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
     return true;
-  } else {
-    // If the key is not found in the leaf page
-    page->RUnlatch();
-    // transaction->GetSharedLockSet().erase(RowId(leaf_node->GetPageId()));
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
-    return false;
   }
+  return false;
 }
 
 /*****************************************************************************
@@ -115,6 +127,9 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
  * keys return false, otherwise return true.
  */
 bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
+  if (IsReadOnly()) {
+    return false;
+  }
   if (IsEmpty()) {
     StartNewTree(key, value);
     return true;
@@ -128,24 +143,19 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
  * tree's root page id and insert entry directly into leaf page.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-  // Caculate Size for new page
-  leaf_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId)) - 1;
-  internal_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId)) - 1;
   // Request a new page from the buffer pool manager
-  Page *page = buffer_pool_manager_->NewPage(root_page_id_);
+  BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(root_page_id_, this);
   // Check if the returned page is nullptr
-  if (page == nullptr) {
+  if (!guard) {
     throw std::runtime_error("Out of memory");
   }
   // Cast the page data to a leaf page
-  LeafPage *root = reinterpret_cast<LeafPage *>(page->GetData());
+  auto *root = guard.AsMut<LeafPage>();
   // Initialize the root page
   root->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
   // Insert the key-value pair into the root page
   root->Insert(key, value, processor_);
-  // Unpin the root page
   UpdateRootPageId(1);
-  buffer_pool_manager_->UnpinPage(root_page_id_, true);
 }
 
 /*
@@ -156,51 +166,28 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-
- /**
- * SHIT
- **/
 bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-
   // Find the leaf page that should contain the input key
-  Page *page = FindLeafPage(key, root_page_id_);
-  auto *leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
-
-  // Lock the page for write
-  page->WLatch();
-  // transaction->GetExclusiveLockSet().insert(RowId(leaf_node->GetPageId()));
+  BasicPageGuard guard = FindLeafPage(key, root_page_id_);
+  auto *leaf_node = reinterpret_cast<LeafPage *>(guard.GetPage()->GetData());
 
   // Check if the key already exists in the leaf page
   RowId rid;
   if (leaf_node->Lookup(key, rid, processor_)) {
-    // If the key exists, unlock the page and return false
-    page->WUnlatch();
-    // transaction->GetExclusiveLockSet().erase(RowId(leaf_node->GetPageId()));
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
     return false;
   }
 
   // Insert the key-value pair into the leaf page
+  guard.SetDirty();
   int new_size = leaf_node->Insert(key, value, processor_);
 
   // If the leaf page is full after the insertion, split it
   if (new_size >= leaf_max_size_) {
-    page->WUnlatch();
-    LeafPage *new_leaf_node = Split(leaf_node, transaction);
-    GenericKey *new_leaf_node_key =  new_leaf_node->KeyAt(0);
+    BasicPageGuard new_guard = Split(leaf_node, transaction);
+    auto *new_leaf_node = new_guard.AsMut<LeafPage>();
+    GenericKey *new_leaf_node_key = new_leaf_node->KeyAt(0);
     GenericKey *old_leaf_node_key = leaf_node->KeyAt(0);
-    InsertIntoParent(old_leaf_node_key ,leaf_node, new_leaf_node_key, new_leaf_node, transaction);
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(new_leaf_node->GetPageId(), true);
-  } else {
-    // Unlock the page and unpin it
-    page->WUnlatch();
-    // transaction->GetExclusiveLockSet().erase(RowId(leaf_node->GetPageId()));
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
+    InsertIntoParent(old_leaf_node_key, leaf_node, new_leaf_node_key, new_leaf_node, transaction);
   }
   return true;
 }
@@ -211,62 +198,44 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transac
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * @return : the guard of the new page, which keeps it pinned until the caller is done with it
  */
-BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-
+BasicPageGuard BPlusTree::Split(InternalPage *node, Txn *transaction) {
   // Request a new page from the buffer pool manager
   page_id_t new_page_id;
-  auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+  BasicPageGuard new_guard = buffer_pool_manager_->NewPageGuarded(new_page_id, this);
   // Check if the returned page is nullptr
-  if (new_page == nullptr) {
+  if (!new_guard) {
     throw std::runtime_error("Out of memory");
   }
   // Cast the page data to an internal page
-  auto *new_node = reinterpret_cast<InternalPage *>(new_page->GetData());
+  auto *new_node = new_guard.AsMut<InternalPage>();
   // Initialize the new page
-  new_node->Init(new_page->GetPageId(), node->GetParentPageId(), node->GetKeySize(), internal_max_size_);
+  new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), internal_max_size_);
   // Move half of the key-value pairs from the input page to the new page
-  node->MoveHalfTo(new_node,buffer_pool_manager_);
-
-  // Unpin the new page
-  buffer_pool_manager_->UnpinPage(new_page_id,true);
-  buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
-  return new_node;
+  node->MoveHalfTo(new_node, buffer_pool_manager_);
+  return new_guard;
 }
 
-BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-
+BasicPageGuard BPlusTree::Split(LeafPage *node, Txn *transaction) {
   // Request a new page from the buffer pool manager
   page_id_t new_page_id;
-  auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+  BasicPageGuard new_guard = buffer_pool_manager_->NewPageGuarded(new_page_id, this);
   // Check if the returned page is nullptr
-  if (new_page == nullptr) {
+  if (!new_guard) {
     throw std::runtime_error("Out of memory");
   }
   // Cast the page data to a leaf page
-  auto *new_node = reinterpret_cast<LeafPage *>(new_page->GetData());
+  auto *new_node = new_guard.AsMut<LeafPage>();
   // Initialize the new page
   new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), node->GetMaxSize());
   // Move half of the key-value pairs from the input page to the new page
   node->MoveHalfTo(new_node);
 
-  // Add the new page to the transaction's write set
-  // transaction->GetWriteSet().emplace_back(Operation::Type::INSERT, new_page_id, *new_node);
   new_node->SetParentPageId(node->GetParentPageId());
   new_node->SetNextPageId(node->GetNextPageId());
   node->SetNextPageId(new_node->GetPageId());
-  // Unpin the new page
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
-  buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
-  return new_node;
+  return new_guard;
 }
 
 /*
@@ -279,33 +248,27 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
  * recursively if necessary.
  */
 void BPlusTree::InsertIntoParent(GenericKey *old_key,BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-
   // If the old node is the root
   if (old_node->IsRootPage()) {
     // Create a new root
-    Page *page = buffer_pool_manager_->NewPage(root_page_id_);
-    if (page == nullptr) {
+    BasicPageGuard root_guard = buffer_pool_manager_->NewPageGuarded(root_page_id_, this);
+    if (!root_guard) {
       throw std::runtime_error("Out of memory");
     }
-    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    auto *root = root_guard.AsMut<InternalPage>();
     root->Init(root_page_id_, INVALID_PAGE_ID, old_node->GetKeySize(), internal_max_size_);
     root->PopulateNewRoot(old_key,old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(root->GetPageId());
     new_node->SetParentPageId(root->GetPageId());
     UpdateRootPageId(0);
-    buffer_pool_manager_->UnpinPage(root->GetPageId(), true);
   } else {
     // If the old node is not the root
     page_id_t parent_page_id = old_node->GetParentPageId();
-    Page *page = buffer_pool_manager_->FetchPage(parent_page_id);
-    if (page == nullptr) {
+    BasicPageGuard parent_guard = buffer_pool_manager_->FetchPageBasic(parent_page_id);
+    if (!parent_guard) {
       throw std::runtime_error("Out of memory");
     }
-    auto *parent = reinterpret_cast<InternalPage *>(page->GetData());
+    auto *parent = parent_guard.AsMut<InternalPage>();
 
     // Insert the new key-value pair into the parent
     int new_size = parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
@@ -313,26 +276,21 @@ void BPlusTree::InsertIntoParent(GenericKey *old_key,BPlusTreePage *old_node, Ge
 
     // If the parent is full after the insertion, split it
     if (new_size >= parent->GetMaxSize()) {
-      InternalPage *new_internal = Split(parent, transaction);
+      BasicPageGuard new_internal_guard = Split(parent, transaction);
+      auto *new_internal = new_internal_guard.AsMut<InternalPage>();
       for (int i = 0; i < parent->GetSize(); ++i) {
-        auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(parent->ValueAt(i))->GetData());
-        child->SetParentPageId(parent->GetPageId());
-        buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
+        BasicPageGuard child_guard = buffer_pool_manager_->FetchPageBasic(parent->ValueAt(i));
+        child_guard.AsMut<BPlusTreePage>()->SetParentPageId(parent->GetPageId());
       }
       for (int i = 0; i < new_internal->GetSize(); ++i) {
-        auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(new_internal->ValueAt(i))->GetData());
-        child->SetParentPageId(new_internal->GetPageId());
-        buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
+        BasicPageGuard child_guard = buffer_pool_manager_->FetchPageBasic(new_internal->ValueAt(i));
+        child_guard.AsMut<BPlusTreePage>()->SetParentPageId(new_internal->GetPageId());
       }
       InsertIntoParent(parent->KeyAt(0),parent, new_internal->KeyAt(0), new_internal, transaction);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(new_internal->GetPageId(), true);
     } else {
       old_node->SetParentPageId(parent->GetPageId());
       new_node->SetParentPageId(parent->GetPageId());
-      page->WUnlatch();
     }
-    buffer_pool_manager_->UnpinPage(parent_page_id, true);
   }
 }
 
@@ -347,29 +305,26 @@ void BPlusTree::InsertIntoParent(GenericKey *old_key,BPlusTreePage *old_node, Ge
  * necessary.
  */
 void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
-  // Check the transaction state
-  // if (transaction->GetState() == TxnState::kAborted) {
-  //   throw TxnAbortException(transaction->GetTxnId(), AbortReason::kDeadlock);
-  // }
-  // If the tree is empty, return immediately
-  if (IsEmpty()) {
+  // If the tree is empty or cannot be changed, return immediately
+  if (IsEmpty() || IsReadOnly()) {
     return;
   }
   // Find the leaf page that should contain the input key
-  Page *page = FindLeafPage(key, root_page_id_);
-  auto *leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
+  BasicPageGuard guard = FindLeafPage(key, root_page_id_);
+  auto *leaf_node = reinterpret_cast<LeafPage *>(guard.GetPage()->GetData());
   int old_size = leaf_node->GetSize();
   int new_size = leaf_node->RemoveAndDeleteRecord(key, processor_);
-  // Unlock the page and unpin it
-  page->WUnlatch();
-  // If the leaf page is less than half full after the removal, coalesce or redistribute it
   if (old_size == new_size) {
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
-  } else {
-    if (!leaf_node->IsRootPage() && new_size < leaf_node->GetMinSize()) {
-      CoalesceOrRedistribute(leaf_node, transaction);
+    return;
+  }
+  guard.SetDirty();
+  // If the leaf page is less than half full after the removal, coalesce or redistribute it
+  if (!leaf_node->IsRootPage() && new_size < leaf_node->GetMinSize()) {
+    page_id_t leaf_page_id = leaf_node->GetPageId();
+    if (CoalesceOrRedistribute(leaf_node, transaction)) {
+      guard.Drop();
+      buffer_pool_manager_->DeletePage(leaf_page_id);
     }
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
   }
 }
 
@@ -377,6 +332,8 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * The caller holds the pin of node and deletes the page if asked to, the pages this method fetches itself are
+ * unpinned, and deleted if merged away, before it returns.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
@@ -384,44 +341,45 @@ template <typename N>
 bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
   if (IsEmpty()) return false;
   if (node->IsRootPage()) {
-    if (node->GetSize() == 1 && AdjustRoot(node)) {
-      buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
-      buffer_pool_manager_->DeletePage(node->GetPageId());
-    }
-    return false;
+    return node->GetSize() == 1 && AdjustRoot(node);
   }
   if (node->GetSize() >= node->GetMinSize()) {
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
     return false;
   }
 
-  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
+  page_id_t parent_id = node->GetParentPageId();
+  BasicPageGuard parent_guard = buffer_pool_manager_->FetchPageBasic(parent_id);
+  auto parent = parent_guard.AsMut<InternalPage>();
   int index = parent->ValueIndex(node->GetPageId()), sibling_index;
 
-  bool is_Tail = index == parent->GetSize() - 1, flag;
+  bool is_Tail = index == parent->GetSize() - 1;
   sibling_index = is_Tail ? index - 1 : index + 1;
   page_id_t sibling_id = parent->ValueAt(sibling_index);
-  auto sibling_page = buffer_pool_manager_->FetchPage(sibling_id);
-  auto sibling = reinterpret_cast<N *>(sibling_page->GetData());
+  BasicPageGuard sibling_guard = buffer_pool_manager_->FetchPageBasic(sibling_id);
+  auto sibling = sibling_guard.AsMut<N>();
   if (sibling->GetSize() + node->GetSize() >= node->GetMaxSize()) {
     if (is_Tail)
       Redistribute(sibling, node, sibling_index);
     else
       Redistribute(sibling, node, 0);
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(sibling_id, true);
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
     return false;
+  }
+  bool parent_deleted;
+  bool node_deleted = is_Tail;
+  if (is_Tail) {
+    // node is merged into its left sibling
+    parent_deleted = Coalesce(sibling, node, parent, index, transaction);
   } else {
-    if (is_Tail)
-      flag = Coalesce(sibling, node, parent, index, transaction);
-    else
-      flag = Coalesce(node, sibling, parent, sibling_index, transaction);
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(sibling_id, true);
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
-    return flag;
+    // the right sibling is merged into node
+    parent_deleted = Coalesce(node, sibling, parent, sibling_index, transaction);
+    sibling_guard.Drop();
+    buffer_pool_manager_->DeletePage(sibling_id);
+  }
+  if (parent_deleted) {
+    parent_guard.Drop();
+    buffer_pool_manager_->DeletePage(parent_id);
   }
+  return node_deleted;
 }
 
 /*
@@ -438,8 +396,6 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
 bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index, Txn *transaction) {
   // Move all key-value pairs from node to neighbor_node
   node->MoveAllTo(neighbor_node);
-  // Notify buffer pool manager to delete node
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
   // Remove the key pointing to node from parent
   parent->Remove(index);
   // If parent is less than half full after removal, coalesce or redistribute it
@@ -453,12 +409,9 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
 bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index, Txn *transaction) {
   auto middle_key = parent->KeyAt(index);
   node->MoveAllTo(neighbor_node, middle_key, buffer_pool_manager_);
-  buffer_pool_manager_->UnpinPage(neighbor_node->GetPageId(), true);
   for (int i = 0; i < neighbor_node->GetSize(); i++) {
-    auto child_page = buffer_pool_manager_->FetchPage(neighbor_node->ValueAt(i));
-    auto child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-    child->SetParentPageId(neighbor_node->GetPageId());
-    buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
+    BasicPageGuard child_guard = buffer_pool_manager_->FetchPageBasic(neighbor_node->ValueAt(i));
+    child_guard.AsMut<BPlusTreePage>()->SetParentPageId(neighbor_node->GetPageId());
   }
   parent->Remove(index);
   if (parent->GetSize() < parent->GetMinSize()) {
@@ -482,45 +435,40 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
     // Move the first key-value pair from neighbor_node to the end of node
     neighbor_node->MoveFirstToEndOf(node);
     if (neighbor_node->GetParentPageId() != INVALID_PAGE_ID) {
-      auto parent_page = buffer_pool_manager_->FetchPage(neighbor_node->GetParentPageId());
-      auto parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+      BasicPageGuard parent_guard = buffer_pool_manager_->FetchPageBasic(neighbor_node->GetParentPageId());
+      auto parent = parent_guard.AsMut<InternalPage>();
       parent->SetKeyAt(parent->ValueIndex(neighbor_node->GetPageId()), neighbor_node->KeyAt(0));
-      buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
     }
   } else {
     // Move the last key-value pair from neighbor_node to the beginning of node
     neighbor_node->MoveLastToFrontOf(node);
     if (node->GetParentPageId() != INVALID_PAGE_ID) {
-      auto parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-      auto parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+      BasicPageGuard parent_guard = buffer_pool_manager_->FetchPageBasic(node->GetParentPageId());
+      auto parent = parent_guard.AsMut<InternalPage>();
       parent->SetKeyAt(parent->ValueIndex(node->GetPageId()), node->KeyAt(0));
-      buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
     }
   }
 }
 void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
-  auto parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  auto parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  BasicPageGuard parent_guard = buffer_pool_manager_->FetchPageBasic(node->GetParentPageId());
+  auto parent = parent_guard.AsMut<InternalPage>();
   if (index == 0) {
     auto middle_key = parent->KeyAt(parent->ValueIndex(neighbor_node->GetPageId()));
     neighbor_node->MoveFirstToEndOf(node, middle_key, buffer_pool_manager_);
     if (neighbor_node->GetParentPageId() != INVALID_PAGE_ID) {
-      auto grand_parent_page = buffer_pool_manager_->FetchPage(neighbor_node->GetParentPageId());
-      auto grand_parent = reinterpret_cast<InternalPage *>(grand_parent_page->GetData());
+      BasicPageGuard grand_parent_guard = buffer_pool_manager_->FetchPageBasic(neighbor_node->GetParentPageId());
+      auto grand_parent = grand_parent_guard.AsMut<InternalPage>();
       grand_parent->SetKeyAt(grand_parent->ValueIndex(neighbor_node->GetPageId()), neighbor_node->KeyAt(0));
-      buffer_pool_manager_->UnpinPage(grand_parent->GetPageId(), true);
     }
   } else {
     auto middle_key = parent->KeyAt(parent->ValueIndex(node->GetPageId()));
     neighbor_node->MoveLastToFrontOf(node, middle_key, buffer_pool_manager_);
     if (node->GetParentPageId() != INVALID_PAGE_ID) {
-      auto grand_parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-      auto grand_parent = reinterpret_cast<InternalPage *>(grand_parent_page->GetData());
+      BasicPageGuard grand_parent_guard = buffer_pool_manager_->FetchPageBasic(node->GetParentPageId());
+      auto grand_parent = grand_parent_guard.AsMut<InternalPage>();
       grand_parent->SetKeyAt(grand_parent->ValueIndex(node->GetPageId()), node->KeyAt(0));
-      buffer_pool_manager_->UnpinPage(grand_parent->GetPageId(), true);
     }
   }
-  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
 }
 /*
  * Update root page if necessary
@@ -536,13 +484,11 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
   if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
     auto root_node = reinterpret_cast<InternalPage *>(old_root_node);
     page_id_t root_page_id = root_node->RemoveAndReturnOnlyChild();
-    auto child_page = buffer_pool_manager_->FetchPage(root_page_id);
-    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    BasicPageGuard child_guard = buffer_pool_manager_->FetchPageBasic(root_page_id);
+    auto child_node = child_guard.AsMut<BPlusTreePage>();
 
     child_node->SetParentPageId(INVALID_PAGE_ID);
-    root_page_id_ = root_page_id;
     root_page_id_ = child_node->GetPageId();
-    buffer_pool_manager_->UnpinPage(root_page_id_, true);
     UpdateRootPageId(0);
     return true;
   } else {
@@ -561,10 +507,11 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin() {
-  auto leaf_page = FindLeafPage(nullptr, root_page_id_, true);
-  auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-  return IndexIterator(leaf->GetPageId(), buffer_pool_manager_);
+  if (IsEmpty()) {
+    return End();
+  }
+  BasicPageGuard guard = FindLeafPage(nullptr, root_page_id_, true);
+  return IndexIterator(guard.PageId(), buffer_pool_manager_);
 }
 
 /*
@@ -573,10 +520,12 @@ IndexIterator BPlusTree::Begin() {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin(const GenericKey *key) {
-  auto leaf_page = FindLeafPage(key, root_page_id_, false);
-  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
-  return IndexIterator(leaf_node->GetPageId(), buffer_pool_manager_, leaf_node->KeyIndex(key, processor_));
+  if (IsEmpty()) {
+    return End();
+  }
+  BasicPageGuard guard = FindLeafPage(key, root_page_id_, false);
+  auto leaf_node = reinterpret_cast<LeafPage *>(guard.GetPage()->GetData());
+  return IndexIterator(guard.PageId(), buffer_pool_manager_, leaf_node->KeyIndex(key, processor_));
 }
 
 /*
@@ -594,36 +543,28 @@ IndexIterator BPlusTree::End() {
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
- * Note: the leaf page is pinned, you need to unpin it after use.
+ * Note: the leaf page stays pinned as long as the returned guard lives.
  */
-Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
+BasicPageGuard BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
   // Fetch the page from the buffer pool manager
-  Page *page = buffer_pool_manager_->FetchPage(page_id);
-
-  if (page == nullptr) {
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(page_id);
+  if (!guard) {
     throw std::runtime_error("Out of memory");
   }
-//  page->RLatch();
-  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  // If the node is a leaf page, return it
-  if (node->IsLeafPage()) {
-    return page;
-  }
-  // If the node is an internal page
-  InternalPage *internal = reinterpret_cast<InternalPage *>(node);
-  page_id_t child_page_id;
-  // If leftMost is true, get the first child
-  if (leftMost) {
-    child_page_id = internal->ValueAt(0);
-  } else {
-    // Otherwise, find the appropriate child to descend into
-    child_page_id = internal->Lookup(key, processor_);
-  }
-//  page->RUnlatch();
-  // Unpin the current page
-  buffer_pool_manager_->UnpinPage(page_id, false);
-  // Recursively find the leaf page
-  return FindLeafPage(key, child_page_id, leftMost);
+  auto *node = reinterpret_cast<BPlusTreePage *>(guard.GetPage()->GetData());
+  // Descend until the node is a leaf page
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    // If leftMost is true, take the first child, otherwise the child covering the key
+    page_id_t child_page_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, processor_);
+    // Assigning the guard unpins the current page
+    guard = buffer_pool_manager_->FetchPageBasic(child_page_id);
+    if (!guard) {
+      throw std::runtime_error("Out of memory");
+    }
+    node = reinterpret_cast<BPlusTreePage *>(guard.GetPage()->GetData());
+  }
+  return guard;
 }
 
 /*
@@ -636,13 +577,13 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
   // Fetch the header page from the buffer pool manager
-  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(INDEX_ROOTS_PAGE_ID);
   // Check if the returned page is nullptr
-  if (page == nullptr) {
+  if (!guard) {
     throw std::runtime_error("Out of memory");
   }
   // Cast the page data to a header page
-  auto *header = reinterpret_cast<IndexRootsPage*>(page->GetData());
+  auto *header = guard.AsMut<IndexRootsPage>();
   // If insert_record is true, insert a record into the header page
   if (insert_record) {
     header->Insert(index_id_, root_page_id_);
@@ -650,8 +591,6 @@ void BPlusTree::UpdateRootPageId(int insert_record) {
     // Otherwise, update the current page ID in the header page
     header->Update(index_id_, root_page_id_);
   }
-  // Unpin the header page
-  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
 
 /**
@@ -730,19 +669,19 @@ void BPlusTree::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstre
     }
     // Print leaves
     for (int i = 0; i < inner->GetSize(); i++) {
-      auto child_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i))->GetData());
+      BasicPageGuard child_guard = bpm->FetchPageBasic(inner->ValueAt(i));
+      auto child_page = reinterpret_cast<BPlusTreePage *>(child_guard.GetPage()->GetData());
       ToGraph(child_page, bpm, out, schema);
       if (i > 0) {
-        auto sibling_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i - 1))->GetData());
+        BasicPageGuard sibling_guard = bpm->FetchPageBasic(inner->ValueAt(i - 1));
+        auto sibling_page = sibling_guard.As<BPlusTreePage>();
         if (!sibling_page->IsLeafPage() && !child_page->IsLeafPage()) {
           out << "{rank=same " << internal_prefix << sibling_page->GetPageId() << " " << internal_prefix
               << child_page->GetPageId() << "};\n";
         }
-        bpm->UnpinPage(sibling_page->GetPageId(), false);
       }
     }
   }
-  bpm->UnpinPage(page->GetPageId(), false);
 }
 
 /**
@@ -767,8 +706,8 @@ void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
     std::cout << std::endl;
     std::cout << std::endl;
     for (int i = 0; i < internal->GetSize(); i++) {
-      ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(internal->ValueAt(i))->GetData()), bpm);
-      bpm->UnpinPage(internal->ValueAt(i), false);
+      BasicPageGuard child_guard = bpm->FetchPageBasic(internal->ValueAt(i));
+      ToString(reinterpret_cast<BPlusTreePage *>(child_guard.GetPage()->GetData()), bpm);
     }
   }
 }
@@ -10,6 +10,9 @@ BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, siz
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  if (container_.IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
 
@@ -27,6 +30,9 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
 }
 
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Txn *txn) {
+  if (container_.IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
 
@@ -79,6 +85,9 @@ dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Txn *txn,
 }
 
 dberr_t BPlusTreeIndex::Destroy() {
+  if (container_.IsReadOnly()) {
+    return DB_READ_ONLY;
+  }
   container_.Destroy();
   return DB_SUCCESS;
 }
@@ -3,17 +3,26 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
 
+/**
+ * Link of a leaf to its right sibling, used to read the leaf chain ahead of a range scan.
+ */
+static page_id_t NextLeafPage(Page *page) {
+  return reinterpret_cast<BPlusTreeLeafPage *>(page->GetData())->GetNextPageId();
+}
+
 IndexIterator::IndexIterator() = default;
 
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+  if (current_page_id != INVALID_PAGE_ID) {
+    guard_ = buffer_pool_manager->FetchPageBasic(current_page_id);
+    page = reinterpret_cast<LeafPage *>(guard_.GetPage()->GetData());
+  }
 }
 
-IndexIterator::~IndexIterator() {
-  if (current_page_id != INVALID_PAGE_ID)
-    buffer_pool_manager->UnpinPage(current_page_id, false);
-}
+IndexIterator::IndexIterator(IndexIterator &&that) noexcept = default;
+
+IndexIterator::~IndexIterator() = default;
 /**
  * TODO: Student Implement
  */
@@ -33,14 +42,17 @@ std::pair<GenericKey *, RowId> IndexIterator::operator*() {
  */
 IndexIterator &IndexIterator::operator++() {
   if (item_index + 1 < page->GetSize()) {
-    buffer_pool_manager->UnpinPage(item_index, false);
     ++item_index;
   } else {
-    page_id_t next_page_id = page->GetNextPageId();
-    buffer_pool_manager->UnpinPage(current_page_id, false);
-    current_page_id = next_page_id;
+    current_page_id = page->GetNextPageId();
+    guard_.Drop();
     if (current_page_id != INVALID_PAGE_ID) {
-      page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id));
+      guard_ = buffer_pool_manager->FetchPageBasic(current_page_id);
+      page = reinterpret_cast<LeafPage *>(guard_.GetPage()->GetData());
+      size_t read_ahead = read_ahead_.Advance();
+      if (read_ahead > 0 && page->GetNextPageId() != INVALID_PAGE_ID) {
+        buffer_pool_manager->PrefetchChain(page->GetNextPageId(), read_ahead, NextLeafPage);
+      }
     } else {
       page = nullptr;
     }
@@ -31,13 +31,44 @@ void InputCommand(char *input, const int len) {
   getchar();      // remove enter
 }
 
+/**
+ * Pick the replacement policy of the buffer pool from a --replacer=lru|clock|lru-k|2q argument.
+ * @return false if the argument names no policy
+ */
+bool ParseReplacer(const char *arg, ReplacerType *replacer_type) {
+  const char *prefix = "--replacer=";
+  if (strncmp(arg, prefix, strlen(prefix)) != 0) {
+    return false;
+  }
+  const char *name = arg + strlen(prefix);
+  if (strcmp(name, "lru") == 0) {
+    *replacer_type = ReplacerType::kLRU;
+  } else if (strcmp(name, "clock") == 0) {
+    *replacer_type = ReplacerType::kClock;
+  } else if (strcmp(name, "lru-k") == 0) {
+    *replacer_type = ReplacerType::kLRUK;
+  } else if (strcmp(name, "2q") == 0) {
+    *replacer_type = ReplacerType::k2Q;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 int main(int argc, char **argv) {
   InitGoogleLog(argv[0]);
+  ReplacerType replacer_type = ReplacerType::kLRU;
+  for (int i = 1; i < argc; i++) {
+    if (!ParseReplacer(argv[i], &replacer_type)) {
+      printf("Usage: %s [--replacer=lru|clock|lru-k|2q]\n", argv[0]);
+      return 1;
+    }
+  }
   // command buffer
   const int buf_size = 1024;
   char cmd[buf_size];
   // executor engine
-  ExecuteEngine engine;
+  ExecuteEngine engine(DEFAULT_BUFFER_POOL_SIZE, replacer_type);
   // for print syntax tree
   TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
   uint32_t syntax_tree_id = 0;
@@ -161,14 +161,11 @@ void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool
   IncreaseSize(size);
   // Update the parent page id of the copied entries and persist the changes
   for (int i = start_position; i < GetSize(); i++) {
-    page_id_t child_page_id = ValueAt(i);
-    Page *child_page = buffer_pool_manager->FetchPage(child_page_id);
-    if (child_page == nullptr) {
+    BasicPageGuard child_guard = buffer_pool_manager->FetchPageBasic(ValueAt(i));
+    if (!child_guard) {
       throw std::runtime_error("Fail to fetch page");
     }
-    BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-    child_tree_page->SetParentPageId(GetPageId());
-    buffer_pool_manager->UnpinPage(child_page_id, true);
+    child_guard.AsMut<BPlusTreePage>()->SetParentPageId(GetPageId());
   }
 }
 
@@ -252,13 +249,11 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
   // Update the size of the recipient page
   IncreaseSize(1);
   // Update the parent page id of the moved page and persist the change
-  Page *child_page = buffer_pool_manager->FetchPage(value);
-  if (child_page == nullptr) {
+  BasicPageGuard child_guard = buffer_pool_manager->FetchPageBasic(value);
+  if (!child_guard) {
     throw std::runtime_error("Fail to fetch page");
   }
-  BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-  child_tree_page->SetParentPageId(GetPageId());
-  buffer_pool_manager->UnpinPage(value, true);
+  child_guard.AsMut<BPlusTreePage>()->SetParentPageId(GetPageId());
 }
 
 /*
@@ -287,11 +282,9 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
   // Update the size of the current page
   IncreaseSize(1);
   // Update the parent page id of the moved page and persist the change
-  Page *child_page = buffer_pool_manager->FetchPage(value);
-  if (child_page == nullptr) {
+  BasicPageGuard child_guard = buffer_pool_manager->FetchPageBasic(value);
+  if (!child_guard) {
     throw std::runtime_error("Fail to fetch page");
   }
-  BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-  child_tree_page->SetParentPageId(GetPageId());
-  buffer_pool_manager->UnpinPage(child_page->GetPageId(), true);
+  child_guard.AsMut<BPlusTreePage>()->SetParentPageId(GetPageId());
 }
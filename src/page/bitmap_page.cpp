@@ -1,50 +1,77 @@
 #include "page/bitmap_page.h"
 
+#include <cstring>
+
 #include "glog/logging.h"
 
-/**
- * TODO: Student Implement
- */
 template <size_t PageSize>
-  //*分配一个空闲页，并通过page_offset返回所分配的空闲页位于该段中的下标（从0开始）；
-  //*如果没有空闲页，返回false；
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
-      // Iterate through the bytes to find the first unset bit (free page)
-    for (uint32_t byte_index = 0; byte_index < MAX_CHARS; ++byte_index) {
-        for (uint8_t bit_index = 0; bit_index < 8; ++bit_index) {
-            if (IsPageFreeLow(byte_index, bit_index)) {
-                // Set the bit indicating the page is now allocated
-                bytes[byte_index] |= (1 << bit_index);
-                page_offset = (byte_index * 8) + bit_index;
-                ++page_allocated_;  // Increment the count of allocated pages
-                return true;
-            }
-        }
+  // every page below the hint is allocated, so the scan starts at the word holding it
+  uint32_t hint = next_free_page_ < GetMaxSupportedSize() ? next_free_page_ : 0;
+  for (uint32_t word_index = hint / 64; word_index < NUM_WORDS; word_index++) {
+    uint64_t word = LoadWord(word_index);
+    if (word == ~0ULL) {
+      continue;
     }
-    // No free pages available
-    return false;
+    uint32_t bit_index = __builtin_ctzll(~word);
+    word |= 1ULL << bit_index;
+    memcpy(bytes + word_index * sizeof(uint64_t), &word, sizeof(word));
+    page_offset = word_index * 64 + bit_index;
+    page_allocated_++;
+    next_free_page_ = page_offset + 1;
+    return true;
+  }
+  next_free_page_ = GetMaxSupportedSize();
+  return false;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocateRun(uint32_t &page_offset) {
+  uint32_t hint = next_free_page_ < GetMaxSupportedSize() ? next_free_page_ : GetMaxSupportedSize();
+  for (uint32_t word_index = hint / 64; word_index < NUM_WORDS; word_index++) {
+    if (LoadWord(word_index) != 0) {
+      continue;
+    }
+    uint64_t word = ~0ULL;
+    memcpy(bytes + word_index * sizeof(uint64_t), &word, sizeof(word));
+    page_offset = word_index * 64;
+    page_allocated_ += 64;
+    if (next_free_page_ == page_offset) {
+      next_free_page_ = page_offset + 64;
+    }
+    return true;
+  }
+  return false;
 }
 
-/**
- * TODO: Student Implement
- */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
   uint32_t byte_index = page_offset / 8;
   uint8_t bit_index = page_offset % 8;
-  if (byte_index >= MAX_CHARS || bit_index >= 8 || IsPageFreeLow(byte_index, bit_index)) {
-      // Out of bounds or page not allocated
-      return false;
+  if (byte_index >= MAX_CHARS || IsPageFreeLow(byte_index, bit_index)) {
+    // Out of bounds or page not allocated
+    return false;
   }
-  // Clear the bit indicating the page is now free
   bytes[byte_index] &= ~(1 << bit_index);
-  --page_allocated_;  // Decrement the count of allocated pages
+  page_allocated_--;
+  if (page_offset < next_free_page_) {
+    next_free_page_ = page_offset;
+  }
   return true;
 }
 
-/**
- * TODO: Student Implement
- */
+template <size_t PageSize>
+bool BitmapPage<PageSize>::GetLastAllocatedPage(uint32_t &page_offset) const {
+  for (uint32_t word_index = NUM_WORDS; word_index-- > 0;) {
+    uint64_t word = LoadWord(word_index);
+    if (word != 0) {
+      page_offset = word_index * 64 + 63 - __builtin_clzll(word);
+      return true;
+    }
+  }
+  return false;
+}
+
 template <size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
   return IsPageFreeLow(page_offset / 8, page_offset % 8);
@@ -52,11 +79,10 @@ bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
 
 template <size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
-    if (byte_index > MAX_CHARS) {
-        return false;  // Out of bounds
-    }
-    bool is_free = (((bytes[byte_index] >> bit_index) & 1) == 0 ? true : false);
-    return is_free;
+  if (byte_index >= MAX_CHARS) {
+    return false;  // Out of bounds
+  }
+  return ((bytes[byte_index] >> bit_index) & 1) == 0;
 }
 
 template class BitmapPage<64>;
@@ -71,4 +97,10 @@ template class BitmapPage<1024>;
 
 template class BitmapPage<2048>;
 
-template class BitmapPage<4096>;
\ No newline at end of file
+template class BitmapPage<4096>;
+
+template class BitmapPage<8192>;
+
+template class BitmapPage<16384>;
+
+template class BitmapPage<32768>;
@@ -0,0 +1,67 @@
+#include "page/overflow_page.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+page_id_t OverflowPage::WriteChain(BufferPoolManager *buffer_pool_manager, const char *data, uint32_t len,
+                                   const void *owner) {
+  page_id_t first_page_id;
+  BasicPageGuard guard = buffer_pool_manager->NewPageGuarded(first_page_id, owner);
+  if (!guard) {
+    return INVALID_PAGE_ID;
+  }
+  auto page = reinterpret_cast<OverflowPage *>(guard.GetPageMut());
+  page->Init(first_page_id);
+  uint32_t offset = 0;
+  while (true) {
+    uint32_t size = std::min<uint32_t>(len - offset, SIZE_MAX_DATA);
+    memcpy(page->GetPayload(), data + offset, size);
+    page->SetDataSize(size);
+    offset += size;
+    if (offset == len) {
+      return first_page_id;
+    }
+    page_id_t next_page_id;
+    BasicPageGuard next_guard = buffer_pool_manager->NewPageGuarded(next_page_id, owner);
+    if (!next_guard) {
+      guard.Drop();
+      FreeChain(buffer_pool_manager, first_page_id);
+      return INVALID_PAGE_ID;
+    }
+    page->SetNextPageId(next_page_id);
+    guard = std::move(next_guard);
+    page = reinterpret_cast<OverflowPage *>(guard.GetPageMut());
+    page->Init(next_page_id);
+  }
+}
+
+bool OverflowPage::ReadChain(BufferPoolManager *buffer_pool_manager, page_id_t page_id, char *buf, uint32_t len) {
+  uint32_t offset = 0;
+  while (offset < len) {
+    ReadPageGuard guard = buffer_pool_manager->FetchPageRead(page_id);
+    if (!guard) {
+      return false;
+    }
+    auto page = reinterpret_cast<OverflowPage *>(guard.GetPage());
+    uint32_t size = std::min(len - offset, page->GetDataSize());
+    memcpy(buf + offset, page->GetPayload(), size);
+    offset += size;
+    page_id = page->GetNextPageId();
+  }
+  return true;
+}
+
+size_t OverflowPage::FreeChain(BufferPoolManager *buffer_pool_manager, page_id_t page_id) {
+  std::vector<page_id_t> page_ids;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = buffer_pool_manager->FetchPageRead(page_id);
+    if (!guard) {
+      break;
+    }
+    page_ids.push_back(page_id);
+    page_id = reinterpret_cast<OverflowPage *>(guard.GetPage())->GetNextPageId();
+  }
+  return buffer_pool_manager->DeletePages(page_ids);
+}
@@ -4,32 +4,28 @@
 
 
 
-void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Txn *txn) {
+void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Txn *txn, RowFormat format) {
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
-  SetTupleCount(0);
+  uint32_t tuple_count_word = static_cast<uint32_t>(format) << ROW_FORMAT_SHIFT;
+  memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count_word, sizeof(uint32_t));
 }
 
-bool TablePage::InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *lock_manager, LogManager *log_manager) {
-  uint32_t serialized_size = row.GetSerializedSize(schema);
+bool TablePage::InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *lock_manager, LogManager *log_manager,
+                            const page_id_t *overflow_pages) {
+  RowFormat format = GetRowFormat();
+  uint32_t serialized_size = row.GetSerializedSize(schema, format, overflow_pages);
   ASSERT(serialized_size > 0, "Can not have empty row.");
   if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
     return false;
   }
-  // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
-    }
-  }
+  uint32_t i = FindFreeSlot();
   // Otherwise we claim available free space..
   SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
-  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+  uint32_t __attribute__((unused)) write_bytes =
+      row.SerializeTo(GetData() + GetFreeSpacePointer(), schema, format, overflow_pages);
   ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
 
   // Set the tuple.
@@ -43,6 +39,37 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *loc
   return true;
 }
 
+bool TablePage::CopyTuple(TablePage *from_page, const RowId &from_rid, RowId *rid) {
+  ASSERT(from_page->GetRowFormat() == GetRowFormat(), "A tuple is copied between pages of one row format.");
+  uint32_t size = from_page->GetTupleSize(from_rid.GetSlotNum());
+  ASSERT(!IsDeleted(size), "Can not copy a deleted tuple.");
+  if (GetFreeSpaceRemaining() < size + SIZE_TUPLE) {
+    return false;
+  }
+  uint32_t i = FindFreeSlot();
+  SetFreeSpacePointer(GetFreeSpacePointer() - size);
+  const char *data = from_page->GetData() + from_page->GetTupleOffsetAtSlot(from_rid.GetSlotNum());
+  memcpy(GetData() + GetFreeSpacePointer(), data, size);
+  SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
+  SetTupleSize(i, size);
+  rid->Set(GetTablePageId(), i);
+  if (i == GetTupleCount()) {
+    SetTupleCount(GetTupleCount() + 1);
+  }
+  return true;
+}
+
+uint32_t TablePage::FindFreeSlot() {
+  // Try to find a free slot to reuse, i.e. one whose tuple has size 0.
+  uint32_t i;
+  for (i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) == 0) {
+      break;
+    }
+  }
+  return i;
+}
+
 bool TablePage::MarkDelete(const RowId &rid, Txn *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort.
@@ -62,9 +89,11 @@ bool TablePage::MarkDelete(const RowId &rid, Txn *txn, LockManager *lock_manager
 }
 
 TABLE_PAGE_UPDATE TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Txn *txn, LockManager *lock_manager,
-                            LogManager *log_manager) {
+                                         LogManager *log_manager, const page_id_t *overflow_pages,
+                                         BufferPoolManager *buffer_pool_manager) {
   ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "invalid old row.");
-  uint32_t serialized_size = new_row.GetSerializedSize(schema);
+  RowFormat format = GetRowFormat();
+  uint32_t serialized_size = new_row.GetSerializedSize(schema, format, overflow_pages);
   ASSERT(serialized_size > 0, "Can not have empty row.");
   uint32_t slot_num = old_row->GetRowId().GetSlotNum();
   // If the slot number is invalid, abort.
@@ -82,21 +111,22 @@ TABLE_PAGE_UPDATE TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema *sch
   }
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes =
+      old_row->DeserializeFrom(GetData() + tuple_offset, schema, format, buffer_pool_manager);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
   memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
           tuple_offset - free_space_pointer);
   SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
+  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema, format, overflow_pages);
   SetTupleSize(slot_num, serialized_size);
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
     if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - serialized_size);
     }
   }
   return TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_SUCCESS;
@@ -142,7 +172,8 @@ void TablePage::RollbackDelete(const RowId &rid, Txn *txn, LogManager *log_manag
   }
 }
 
-bool TablePage::GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager) {
+bool TablePage::GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager,
+                         BufferPoolManager *buffer_pool_manager) {
   ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
   // Get the current slot number.
   uint32_t slot_num = row->GetRowId().GetSlotNum();
@@ -153,20 +184,58 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_m
   // Otherwise get the current tuple size too.
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is deleted, abort the recovery.
-  if (IsDeleted(tuple_size)) {
+  if (tuple_size == 0 || IsDeleted(tuple_size)) {
     return false;
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes =
+      row->DeserializeFrom(GetData() + tuple_offset, schema, GetRowFormat(), buffer_pool_manager);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, const Schema *schema, RowView *view,
+                             BufferPoolManager *buffer_pool_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  *view = RowView(GetData() + GetTupleOffsetAtSlot(slot_num), schema, GetRowFormat(), rid, buffer_pool_manager);
+  return true;
+}
+
+void TablePage::GetOverflowPages(const RowId &rid, const Schema *schema, std::vector<page_id_t> *overflow_pages) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (!schema->MayOverflow() || GetRowFormat() != RowFormat::kCompact || slot_num >= GetTupleCount() ||
+      GetTupleSize(slot_num) == 0) {
+    return;
+  }
+  RowView view(GetData() + GetTupleOffsetAtSlot(slot_num), schema, RowFormat::kCompact, rid);
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    page_id_t page_id = view.GetOverflowPageId(i);
+    if (page_id != INVALID_PAGE_ID) {
+      overflow_pages->push_back(page_id);
+    }
+  }
+}
+
+void TablePage::GetOverflowPages(const Schema *schema, std::vector<page_id_t> *overflow_pages) {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    GetOverflowPages(RowId(GetTablePageId(), i), schema, overflow_pages);
+  }
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    uint32_t tuple_size = GetTupleSize(i);
+    // A slot whose delete was applied has size 0.
+    if (tuple_size != 0 && !IsDeleted(tuple_size)) {
       first_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -179,7 +248,8 @@ bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (tuple_size != 0 && !IsDeleted(tuple_size)) {
       next_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -188,3 +258,24 @@ bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+uint32_t TablePage::PurgeDeleted(Txn *txn, LogManager *log_manager, const Schema *schema,
+                                 std::vector<page_id_t> *overflow_pages) {
+  uint32_t purged = 0;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (tuple_size != 0 && IsDeleted(tuple_size)) {
+      if (overflow_pages != nullptr) {
+        GetOverflowPages(RowId(GetTablePageId(), i), schema, overflow_pages);
+      }
+      ApplyDelete(RowId(GetTablePageId(), i), txn, log_manager);
+      purged++;
+    }
+  }
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+  return purged;
+}
@@ -0,0 +1,29 @@
+#include "record/field_kernels.h"
+
+FieldCompareFn GetFieldCompareFn(TypeId type_id) {
+  switch (type_id) {
+    case kTypeInt:
+      return &FieldKernel<kTypeInt>::Compare;
+    case kTypeFloat:
+      return &FieldKernel<kTypeFloat>::Compare;
+    case kTypeChar:
+      return &FieldKernel<kTypeChar>::Compare;
+    default:
+      break;
+  }
+  throw "Unknown field type.";
+}
+
+FieldHashFn GetFieldHashFn(TypeId type_id) {
+  switch (type_id) {
+    case kTypeInt:
+      return &FieldKernel<kTypeInt>::Hash;
+    case kTypeFloat:
+      return &FieldKernel<kTypeFloat>::Hash;
+    case kTypeChar:
+      return &FieldKernel<kTypeChar>::Hash;
+    default:
+      break;
+  }
+  throw "Unknown field type.";
+}
@@ -1,13 +1,21 @@
 #include "record/row.h"
 
 #include "common/macros.h"
+#include "page/overflow_page.h"
+
+// end offsets of CHAR data are stored in 2 bytes, the top bit marks a value kept out of line
+static_assert(PAGE_SIZE <= Row::OVERFLOW_FLAG, "A compact row must be shorter than 32 KB.");
+static_assert(CHAR_OVERFLOW_THRESHOLD >= Row::OVERFLOW_STUB_SIZE, "A stub must be shorter than the value it replaces.");
 
 /**
  * TODO: Student Implement
  */
-uint32_t Row::SerializeTo(char *buf, Schema *schema) const {    // why schema??
+uint32_t Row::SerializeTo(char *buf, Schema *schema, RowFormat format, const page_id_t *overflow_pages) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  if (format == RowFormat::kCompact) {
+    return SerializeCompact(buf, schema, overflow_pages);
+  }
   // replace with your code here
   uint32_t offset = 0;
 
@@ -53,9 +61,12 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {    // why schema??
   return offset;
 }
 
-uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, RowFormat format, BufferPoolManager *buffer_pool_manager) {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(fields_.empty(), "Non empty field in row.");
+  if (format == RowFormat::kCompact) {
+    return DeserializeCompact(buf, schema, buffer_pool_manager);
+  }
   // replace with your code here
   uint32_t offset = 0;
 
@@ -124,9 +135,19 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   return offset;
 }
 
-uint32_t Row::GetSerializedSize(Schema *schema) const {
+uint32_t Row::GetSerializedSize(Schema *schema, RowFormat format, const page_id_t *overflow_pages) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  if (format == RowFormat::kCompact) {
+    uint32_t serialized_size = schema->GetFixedLength();
+    for (uint32_t i = 0; i < fields_.size(); i++) {
+      if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar && !fields_[i]->IsNull()) {
+        bool out_of_line = overflow_pages != nullptr && overflow_pages[i] != INVALID_PAGE_ID;
+        serialized_size += out_of_line ? OVERFLOW_STUB_SIZE : fields_[i]->len_;
+      }
+    }
+    return serialized_size;
+  }
   // replace with your code here
 
   uint32_t serialized_size = 0;
@@ -154,6 +175,99 @@ uint32_t Row::GetSerializedSize(Schema *schema) const {
   return serialized_size;
 }
 
+uint32_t Row::SerializeCompact(char *buf, Schema *schema, const page_id_t *overflow_pages) const {
+  uint32_t offset = schema->GetFixedLength();
+  // the null bitmap starts cleared and null fixed-width values are left zero
+  memset(buf, 0, offset);
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    const Field *field = fields_[i];
+    uint32_t field_offset = schema->GetFieldOffset(i);
+    TypeId type = schema->GetColumn(i)->GetType();
+    ASSERT(field->IsNull() || field->type_id_ == type, "Field type does not match the column type.");
+    if (field->IsNull()) {
+      buf[i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+    switch (type) {
+      case TypeId::kTypeInt:
+      case TypeId::kTypeFloat:
+        if (!field->IsNull()) {
+          memcpy(buf + field_offset, &field->value_, sizeof(int32_t));
+        }
+        break;
+      case TypeId::kTypeChar:
+        if (!field->IsNull() && overflow_pages != nullptr && overflow_pages[i] != INVALID_PAGE_ID) {
+          ASSERT(field->len_ > CHAR_OVERFLOW_PREFIX_LEN, "A value kept out of line is longer than its prefix.");
+          MACH_WRITE_UINT32(buf + offset, field->len_);
+          MACH_WRITE_TO(page_id_t, buf + offset + sizeof(uint32_t), overflow_pages[i]);
+          memcpy(buf + offset + sizeof(uint32_t) + sizeof(page_id_t), field->value_.chars_, CHAR_OVERFLOW_PREFIX_LEN);
+          offset += OVERFLOW_STUB_SIZE;
+          MACH_WRITE_TO(uint16_t, buf + field_offset, static_cast<uint16_t>(offset | OVERFLOW_FLAG));
+          break;
+        }
+        if (!field->IsNull()) {
+          memcpy(buf + offset, field->value_.chars_, field->len_);
+          offset += field->len_;
+        }
+        MACH_WRITE_TO(uint16_t, buf + field_offset, static_cast<uint16_t>(offset));
+        break;
+      default:
+        ASSERT(false, "Unsupported type for serialization");
+    }
+  }
+  return offset;
+}
+
+uint32_t Row::DeserializeCompact(char *buf, Schema *schema, BufferPoolManager *buffer_pool_manager) {
+  uint32_t column_count = schema->GetColumnCount();
+  fields_.reserve(column_count);
+  uint32_t offset = schema->GetFixedLength();
+  for (uint32_t i = 0; i < column_count; i++) {
+    bool is_null = buf[i / 8] & (1 << (i % 8));
+    uint32_t field_offset = schema->GetFieldOffset(i);
+    switch (schema->GetColumn(i)->GetType()) {
+      case TypeId::kTypeInt:
+        fields_.push_back(is_null ? new Field(TypeId::kTypeInt)
+                                  : new Field(TypeId::kTypeInt, MACH_READ_FROM(int32_t, buf + field_offset)));
+        break;
+      case TypeId::kTypeFloat:
+        fields_.push_back(is_null ? new Field(TypeId::kTypeFloat)
+                                  : new Field(TypeId::kTypeFloat, MACH_READ_FROM(float, buf + field_offset)));
+        break;
+      case TypeId::kTypeChar: {
+        uint32_t end = MACH_READ_FROM(uint16_t, buf + field_offset);
+        if (end & OVERFLOW_FLAG) {
+          ASSERT(buffer_pool_manager != nullptr, "A value kept out of line is read through the buffer pool.");
+          uint32_t len = GetOverflowLength(buf + offset);
+          auto field = new Field(TypeId::kTypeChar, new char[len], len, false);
+          field->manage_data_ = true;
+          if (!ReadOverflowValue(buf + offset, field->value_.chars_, buffer_pool_manager)) {
+            // a chain that cannot be read leaves the value null rather than uninitialized
+            LOG(WARNING) << "Failed to read the value of column " << i << " kept out of line." << std::endl;
+            delete field;
+            field = new Field(TypeId::kTypeChar);
+          }
+          fields_.push_back(field);
+          offset = end & ~OVERFLOW_FLAG;
+          break;
+        }
+        fields_.push_back(is_null ? new Field(TypeId::kTypeChar)
+                                  : new Field(TypeId::kTypeChar, buf + offset, end - offset, true));
+        offset = end;
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported type for deserialization");
+    }
+  }
+  return offset;
+}
+
+bool Row::ReadOverflowValue(const char *stub, char *buf, BufferPoolManager *buffer_pool_manager) {
+  memcpy(buf, stub + sizeof(uint32_t) + sizeof(page_id_t), CHAR_OVERFLOW_PREFIX_LEN);
+  return OverflowPage::ReadChain(buffer_pool_manager, GetOverflowPageId(stub), buf + CHAR_OVERFLOW_PREFIX_LEN,
+                                 GetOverflowLength(stub) - CHAR_OVERFLOW_PREFIX_LEN);
+}
+
 bool Row::CompareEqualTo(const Row *other) {
     if (!(rid_ == other->rid_))
         return false;
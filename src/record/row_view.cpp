@@ -0,0 +1,162 @@
+#include "record/row_view.h"
+
+#include <memory>
+
+bool RowView::IsNull(uint32_t idx) const {
+  ASSERT(idx < schema_->GetColumnCount(), "Failed to access field");
+  if (format_ == RowFormat::kCompact) {
+    return data_[idx / 8] & (1 << (idx % 8));
+  }
+  // tagged: row id, field count, then the null bitmap
+  return data_[sizeof(page_id_t) + 2 * sizeof(uint32_t) + idx / 8] & (1 << (idx % 8));
+}
+
+bool RowView::Locate(uint32_t idx, const char **value, uint32_t *len) const {
+  if (IsNull(idx)) {
+    return false;
+  }
+  if (format_ == RowFormat::kCompact) {
+    uint32_t field_offset = schema_->GetFieldOffset(idx);
+    if (schema_->GetColumn(idx)->GetType() != TypeId::kTypeChar) {
+      *value = data_ + field_offset;
+      return true;
+    }
+    uint32_t begin = field_offset == schema_->GetCharOffsetsBegin()
+                         ? schema_->GetFixedLength()
+                         : MACH_READ_FROM(uint16_t, data_ + field_offset - sizeof(uint16_t)) & ~Row::OVERFLOW_FLAG;
+    *value = data_ + begin;
+    *len = (MACH_READ_FROM(uint16_t, data_ + field_offset) & ~Row::OVERFLOW_FLAG) - begin;
+    return true;
+  }
+  uint32_t column_count = schema_->GetColumnCount();
+  const char *p = data_ + sizeof(page_id_t) + 2 * sizeof(uint32_t) + (column_count + 7) / 8;
+  for (uint32_t i = 0;; i++) {
+    auto type = static_cast<TypeId>(MACH_READ_FROM(uint32_t, p));
+    p += sizeof(uint32_t);
+    uint32_t size = 0;
+    if (!IsNull(i)) {
+      size = type == TypeId::kTypeChar ? sizeof(uint32_t) + MACH_READ_UINT32(p) : Type::GetTypeSize(type);
+    }
+    if (i == idx) {
+      break;
+    }
+    p += size;
+  }
+  if (schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar) {
+    *len = MACH_READ_UINT32(p);
+    p += sizeof(uint32_t);
+  }
+  *value = p;
+  return true;
+}
+
+bool RowView::IsOverflow(uint32_t idx) const {
+  return format_ == RowFormat::kCompact && schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar &&
+         (MACH_READ_FROM(uint16_t, data_ + schema_->GetFieldOffset(idx)) & Row::OVERFLOW_FLAG);
+}
+
+page_id_t RowView::GetOverflowPageId(uint32_t idx) const {
+  const char *value;
+  uint32_t len;
+  if (!IsOverflow(idx) || !Locate(idx, &value, &len)) {
+    return INVALID_PAGE_ID;
+  }
+  return Row::GetOverflowPageId(value);
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  const char *value;
+  uint32_t len = 0;
+  if (!Locate(idx, &value, &len)) {
+    return Field(type);
+  }
+  if (IsOverflow(idx)) {
+    ASSERT(buffer_pool_manager_ != nullptr, "A value kept out of line is read through the buffer pool.");
+    len = Row::GetOverflowLength(value);
+    std::unique_ptr<char[]> data(new char[len]);
+    if (!Row::ReadOverflowValue(value, data.get(), buffer_pool_manager_)) {
+      LOG(WARNING) << "Failed to read the value of column " << idx << " kept out of line." << std::endl;
+      return Field(type);
+    }
+    return Field(TypeId::kTypeChar, data.get(), len, true);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(TypeId::kTypeInt, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return Field(TypeId::kTypeFloat, MACH_READ_FROM(float, value));
+    case TypeId::kTypeChar:
+      return Field(TypeId::kTypeChar, const_cast<char *>(value), len, false);
+    default:
+      ASSERT(false, "Unsupported type for row view");
+  }
+  return Field(type);
+}
+
+Field *RowView::CopyField(uint32_t idx, MemoryArena *arena) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  const char *value;
+  uint32_t len = 0;
+  if (!Locate(idx, &value, &len)) {
+    return arena == nullptr ? new Field(type) : arena->New<Field>(type);
+  }
+  if (IsOverflow(idx)) {
+    ASSERT(buffer_pool_manager_ != nullptr, "A value kept out of line is read through the buffer pool.");
+    len = Row::GetOverflowLength(value);
+    if (arena == nullptr) {
+      std::unique_ptr<char[]> data(new char[len]);
+      if (!Row::ReadOverflowValue(value, data.get(), buffer_pool_manager_)) {
+        LOG(WARNING) << "Failed to read the value of column " << idx << " kept out of line." << std::endl;
+        return new Field(type);
+      }
+      return new Field(type, data.get(), len, true);
+    }
+    auto data = static_cast<char *>(arena->Allocate(len, 1));
+    if (!Row::ReadOverflowValue(value, data, buffer_pool_manager_)) {
+      // the bytes stay in the arena until it is reset
+      LOG(WARNING) << "Failed to read the value of column " << idx << " kept out of line." << std::endl;
+      return arena->New<Field>(type);
+    }
+    return arena->New<Field>(type, data, len, false);
+  }
+  switch (type) {
+    case TypeId::kTypeInt: {
+      auto integer = MACH_READ_FROM(int32_t, value);
+      return arena == nullptr ? new Field(type, integer) : arena->New<Field>(type, integer);
+    }
+    case TypeId::kTypeFloat: {
+      auto real = MACH_READ_FROM(float, value);
+      return arena == nullptr ? new Field(type, real) : arena->New<Field>(type, real);
+    }
+    case TypeId::kTypeChar:
+      if (arena == nullptr) {
+        return new Field(type, const_cast<char *>(value), len, true);
+      }
+      return arena->New<Field>(type, arena->CopyBytes(value, len), len, false);
+    default:
+      ASSERT(false, "Unsupported type for row view");
+  }
+  return nullptr;
+}
+
+void RowView::Materialize(Row *row, MemoryArena *arena) const {
+  row->Reset(arena);
+  row->SetRowId(rid_);
+  auto &fields = row->GetFields();
+  uint32_t column_count = schema_->GetColumnCount();
+  fields.reserve(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    fields.push_back(CopyField(i, arena));
+  }
+}
+
+void RowView::Materialize(Row *row, const Schema *output_schema, MemoryArena *arena) const {
+  row->Reset(arena);
+  row->SetRowId(rid_);
+  auto &fields = row->GetFields();
+  fields.reserve(output_schema->GetColumnCount());
+  for (const auto column : output_schema->GetColumns()) {
+    fields.push_back(CopyField(column->GetTableInd(), arena));
+  }
+}
@@ -77,6 +77,34 @@ uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema) {
   return offset;
 }
 
+void Schema::ComputeLayout() {
+  null_bitmap_size_ = (columns_.size() + 7) / 8;
+  field_offsets_.resize(columns_.size());
+  // fixed-width values first, then one end offset per CHAR column
+  uint32_t offset = null_bitmap_size_;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() != TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += Type::GetTypeSize(columns_[i]->GetType());
+    }
+  }
+  char_offsets_begin_ = offset;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += sizeof(uint16_t);
+      may_overflow_ |= columns_[i]->GetLength() > CHAR_OVERFLOW_THRESHOLD;
+    }
+  }
+  fixed_length_ = offset;
+  compare_fns_.resize(columns_.size());
+  hash_fns_.resize(columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    compare_fns_[i] = GetFieldCompareFn(columns_[i]->GetType());
+    hash_fns_[i] = GetFieldHashFn(columns_[i]->GetType());
+  }
+}
+
 bool Schema::CompareEqualTo(const Schema *other) {
     if (this->GetColumnCount() != other->GetColumnCount())
         return false;
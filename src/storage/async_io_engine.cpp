@@ -0,0 +1,468 @@
+#include "storage/async_io_engine.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+#include "common/config.h"
+#include "glog/logging.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && !defined(MINISQL_DISABLE_IO_URING)
+#define MINISQL_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+void IoBatch::AddRead(int fd, char *buf, size_t len, size_t offset) {
+  ASSERT(pending_ == 0, "Batch is in flight.");
+  IoRequest request;
+  request.fd_ = fd;
+  request.buf_ = buf;
+  request.len_ = len;
+  request.offset_ = offset;
+  requests_.push_back(request);
+}
+
+void IoBatch::AddWrite(int fd, const char *buf, size_t len, size_t offset) {
+  ASSERT(pending_ == 0, "Batch is in flight.");
+  IoRequest request;
+  request.is_write_ = true;
+  request.fd_ = fd;
+  // the engine never writes through the buffer of a write request
+  request.buf_ = const_cast<char *>(buf);
+  request.len_ = len;
+  request.offset_ = offset;
+  requests_.push_back(request);
+}
+
+void IoBatch::AddWritev(int fd, std::vector<iovec> iov, size_t offset) {
+  ASSERT(pending_ == 0, "Batch is in flight.");
+  IoRequest request;
+  request.is_write_ = true;
+  request.fd_ = fd;
+  for (auto &buf : iov) {
+    request.len_ += buf.iov_len;
+  }
+  request.iov_ = std::move(iov);
+  request.offset_ = offset;
+  requests_.push_back(std::move(request));
+}
+
+void IoBatch::Wait() {
+  std::unique_lock<std::mutex> lock(latch_);
+  cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+size_t IoBatch::GetErrorCount() const {
+  return std::count_if(requests_.begin(), requests_.end(), [](const IoRequest &r) { return r.error_ != 0; });
+}
+
+void IoBatch::Complete(size_t num_requests) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  pending_ -= num_requests;
+  if (pending_ == 0) {
+    cv_.notify_all();
+  }
+}
+
+void AsyncIoEngine::Submit(IoBatch &batch) {
+  if (batch.Empty()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(batch.latch_);
+    ASSERT(batch.pending_ == 0, "Batch is already in flight.");
+    batch.pending_ = batch.requests_.size();
+  }
+  for (auto &request : batch.requests_) {
+    request.batch_ = &batch;
+    request.error_ = 0;
+  }
+  SubmitRequests(batch.requests_);
+}
+
+void AsyncIoEngine::FinishSync(IoRequest *request, size_t done) {
+  if (!request->iov_.empty()) {
+    FinishVectoredSync(request, done);
+    return;
+  }
+  while (done < request->len_) {
+    ssize_t n;
+    if (request->is_write_) {
+      n = pwrite(request->fd_, request->buf_ + done, request->len_ - done, request->offset_ + done);
+    } else {
+      n = pread(request->fd_, request->buf_ + done, request->len_ - done, request->offset_ + done);
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      request->error_ = errno;
+      LOG(ERROR) << "I/O error while " << (request->is_write_ ? "writing: " : "reading: ") << strerror(errno);
+      break;
+    }
+    if (n == 0) {
+      // end of file, the rest of a read page is zeros; a write never returns 0 for a non-empty buffer
+      if (request->is_write_) {
+        request->error_ = EIO;
+      }
+      break;
+    }
+    done += n;
+  }
+  if (!request->is_write_ && done < request->len_) {
+    memset(request->buf_ + done, 0, request->len_ - done);
+  }
+}
+
+void AsyncIoEngine::FinishVectoredSync(IoRequest *request, size_t done) {
+  std::vector<iovec> iov(request->iov_);
+  size_t first = 0;
+  size_t skip = done;
+  while (done < request->len_) {
+    // drop the bytes written so far from the front of the buffers
+    while (skip >= iov[first].iov_len) {
+      skip -= iov[first].iov_len;
+      first++;
+    }
+    iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + skip;
+    iov[first].iov_len -= skip;
+    int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+    ssize_t n = pwritev(request->fd_, &iov[first], count, request->offset_ + done);
+    if (n < 0 && errno == EINTR) {
+      skip = 0;
+      continue;
+    }
+    if (n <= 0) {
+      request->error_ = n < 0 ? errno : EIO;
+      LOG(ERROR) << "I/O error while writing: " << strerror(request->error_);
+      break;
+    }
+    done += n;
+    skip = n;
+  }
+}
+
+/**
+ * Fallback engine: a fixed set of threads that take requests from a queue and do them with pread/pwrite. The
+ * threads are started on the first batch, so an engine that is never used costs nothing.
+ */
+class ThreadPoolIoEngine : public AsyncIoEngine {
+ public:
+  explicit ThreadPoolIoEngine(size_t num_threads) : num_threads_(std::max<size_t>(num_threads, 1)) {}
+
+  ~ThreadPoolIoEngine() override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  Type GetType() const override { return Type::THREAD_POOL; }
+
+ protected:
+  void SubmitRequests(std::vector<IoRequest> &requests) override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      if (workers_.empty()) {
+        for (size_t i = 0; i < num_threads_; i++) {
+          workers_.emplace_back(&ThreadPoolIoEngine::RunWorker, this);
+        }
+      }
+      for (auto &request : requests) {
+        queue_.push_back(&request);
+      }
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  void RunWorker() {
+    while (true) {
+      IoRequest *request;
+      {
+        std::unique_lock<std::mutex> lock(latch_);
+        cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        request = queue_.front();
+        queue_.pop_front();
+      }
+      FinishSync(request, 0);
+      Complete(request);
+    }
+  }
+
+  const size_t num_threads_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<IoRequest *> queue_;
+  std::vector<std::thread> workers_;
+  bool stop_{false};
+};
+
+#ifdef MINISQL_HAVE_IO_URING
+/**
+ * io_uring engine talking to the kernel through the raw system calls, so that no liburing is needed. Submitters
+ * fill the submission ring under a latch; one completion thread reaps the completion ring and finishes the
+ * requests. A short transfer or an error is finished or retried synchronously by the completion thread.
+ */
+class IoUringEngine : public AsyncIoEngine {
+ public:
+  /** @return the engine, or nullptr if the kernel refuses to set up a ring */
+  static std::unique_ptr<IoUringEngine> Create(size_t queue_depth) {
+    std::unique_ptr<IoUringEngine> engine(new IoUringEngine());
+    if (!engine->Setup(static_cast<unsigned>(std::max<size_t>(queue_depth, 1)))) {
+      return nullptr;
+    }
+    engine->completer_ = std::thread(&IoUringEngine::RunCompleter, engine.get());
+    return engine;
+  }
+
+  ~IoUringEngine() override {
+    if (completer_.joinable()) {
+      {
+        std::unique_lock<std::mutex> lock(latch_);
+        stop_ = true;
+        // a no-op with no request attached wakes up the completion thread
+        space_cv_.wait(lock, [this] { return in_flight_ < entries_; });
+        PushSqe(IORING_OP_NOP, nullptr);
+        Enter(1, 0, 0);
+      }
+      completer_.join();
+    }
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_ring_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+      munmap(sq_ptr_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  Type GetType() const override { return Type::IO_URING; }
+
+ protected:
+  void SubmitRequests(std::vector<IoRequest> &requests) override {
+    std::unique_lock<std::mutex> lock(latch_);
+    unsigned queued = 0;
+    for (auto &request : requests) {
+      if (in_flight_ >= entries_) {
+        // hand what is queued to the kernel before waiting for room
+        if (queued > 0) {
+          Enter(queued, 0, 0);
+          queued = 0;
+        }
+        space_cv_.wait(lock, [this] { return in_flight_ < entries_; });
+      }
+      uint8_t opcode = request.is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+      if (!request.iov_.empty()) {
+        opcode = IORING_OP_WRITEV;
+      }
+      PushSqe(opcode, &request);
+      in_flight_++;
+      queued++;
+    }
+    if (queued > 0) {
+      Enter(queued, 0, 0);
+    }
+  }
+
+ private:
+  IoUringEngine() = default;
+
+  static int Enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    int rc;
+    do {
+      rc = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+    } while (rc < 0 && errno == EINTR);
+    return rc;
+  }
+
+  void Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    if (Enter(ring_fd_, to_submit, min_complete, flags) < 0) {
+      LOG(ERROR) << "io_uring_enter failed: " << strerror(errno);
+    }
+  }
+
+  bool Setup(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      return false;
+    }
+    entries_ = params.sq_entries;
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    void *sq_ptr = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                        IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+      return false;
+    }
+    sq_ptr_ = sq_ptr;
+    if (single_mmap) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      void *cq_ptr = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_CQ_RING);
+      if (cq_ptr == MAP_FAILED) {
+        return false;
+      }
+      cq_ptr_ = cq_ptr;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+    auto *sq = static_cast<char *>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  /** Fill the next submission entry, the caller holds latch_ and has made sure there is room. */
+  void PushSqe(uint8_t opcode, IoRequest *request) {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = -1;
+    if (request != nullptr) {
+      sqe->fd = request->fd_;
+      sqe->addr = reinterpret_cast<uint64_t>(request->buf_);
+      sqe->len = static_cast<uint32_t>(request->len_);
+      sqe->off = request->offset_;
+      if (!request->iov_.empty()) {
+        // a vectored request passes its iovec array and the number of buffers
+        sqe->addr = reinterpret_cast<uint64_t>(request->iov_.data());
+        sqe->len = static_cast<uint32_t>(request->iov_.size());
+      }
+    }
+    sqe->user_data = reinterpret_cast<uint64_t>(request);
+    sq_array_[index] = index;
+    // the kernel must see the entry before it sees the new tail
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  void RunCompleter() {
+    while (true) {
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      if (head == tail) {
+        {
+          std::scoped_lock<std::mutex> lock(latch_);
+          if (stop_ && in_flight_ == 0 && nop_reaped_) {
+            return;
+          }
+        }
+        Enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+        continue;
+      }
+      io_uring_cqe *cqe = &cqes_[head & cq_mask_];
+      auto *request = reinterpret_cast<IoRequest *>(cqe->user_data);
+      int res = cqe->res;
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      if (request == nullptr) {
+        std::scoped_lock<std::mutex> lock(latch_);
+        nop_reaped_ = true;
+        continue;
+      }
+      // short transfers, interrupted requests and kernels without the opcode are finished synchronously
+      size_t done = res > 0 ? static_cast<size_t>(res) : 0;
+      if (res < 0 && res != -EINTR && res != -EAGAIN && res != -EINVAL && res != -EOPNOTSUPP) {
+        request->error_ = -res;
+        LOG(ERROR) << "I/O error while " << (request->is_write_ ? "writing: " : "reading: ") << strerror(-res);
+        if (!request->is_write_) {
+          memset(request->buf_, 0, request->len_);
+        }
+      } else if (done < request->len_) {
+        FinishSync(request, done);
+      }
+      {
+        std::scoped_lock<std::mutex> lock(latch_);
+        in_flight_--;
+      }
+      space_cv_.notify_all();
+      Complete(request);
+    }
+  }
+
+  int ring_fd_{-1};
+  unsigned entries_{0};
+  void *sq_ptr_{nullptr};
+  void *cq_ptr_{nullptr};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+
+  // protects the submission ring, in_flight_ and the stop flags
+  std::mutex latch_;
+  std::condition_variable space_cv_;
+  unsigned in_flight_{0};
+  bool stop_{false};
+  bool nop_reaped_{false};
+  std::thread completer_;
+};
+#endif
+
+std::unique_ptr<AsyncIoEngine> AsyncIoEngine::Create(Type type, size_t queue_depth) {
+#ifdef MINISQL_HAVE_IO_URING
+  if (type == Type::IO_URING) {
+    auto engine = IoUringEngine::Create(queue_depth);
+    if (engine != nullptr) {
+      return engine;
+    }
+    LOG(WARNING) << "io_uring is not available (" << strerror(errno) << "), falling back to a thread pool";
+  }
+#endif
+  return std::make_unique<ThreadPoolIoEngine>(std::min<size_t>(queue_depth, DEFAULT_IO_THREADS));
+}
+
+AsyncIoEngine *AsyncIoEngine::Default() {
+  static std::unique_ptr<AsyncIoEngine> engine = [] {
+    const char *name = getenv("MINISQL_IO_ENGINE");
+    Type type = name != nullptr && strcmp(name, "threads") == 0 ? Type::THREAD_POOL : Type::IO_URING;
+    return Create(type, DEFAULT_IO_QUEUE_DEPTH);
+  }();
+  return engine.get();
+}
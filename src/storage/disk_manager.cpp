@@ -1,38 +1,152 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool read_only) : file_name_(db_file), read_only_(read_only) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
+  if (read_only_) {
+    db_fd_ = open(db_file.c_str(), O_RDONLY);
+  } else {
+    // directory does not exist
     std::filesystem::path p = db_file;
     if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw std::runtime_error("failed to open db file " + db_file + ": " + strerror(errno));
+  }
+  file_size_ = GetFileSize(db_fd_);
+  if (read_only_) {
+    // A read-only mapping shares the pages with the page cache. A write through it faults, the write paths of the
+    // buffer pool, the table heap and the B+ tree refuse to change a page of a read-only database.
+    void *mapping = file_size_ > 0 ? mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, db_fd_, 0) : MAP_FAILED;
+    if (mapping == MAP_FAILED) {
+      std::string error = file_size_ > 0 ? strerror(errno) : "empty file";
+      close(db_fd_);
+      throw std::runtime_error("failed to map db file " + db_file + ": " + error);
     }
+    mapping_ = static_cast<char *>(mapping);
+    mapping_size_ = file_size_;
   }
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (file_size_ > 0 && meta_page->GetPageSize() != PAGE_SIZE) {
+    uint32_t page_size = meta_page->GetPageSize();
+    if (mapping_ != nullptr) {
+      munmap(mapping_, mapping_size_);
+    }
+    close(db_fd_);
+    throw std::runtime_error("db file " + db_file + " has " + std::to_string(page_size) + " byte pages, this build uses " +
+                             std::to_string(PAGE_SIZE) + " byte pages");
+  }
+  meta_page->SetPageSize(PAGE_SIZE);
+  for (uint32_t extent_id = 0; extent_id < MAX_EXTENTS; extent_id++) {
+    page_id_t bitmap_page_id = BitmapPageId(extent_id);
+    if (static_cast<size_t>(bitmap_page_id) * PAGE_SIZE >= file_size_) {
+      break;
+    }
+    AddExtent();
+    ReadPhysicalPage(bitmap_page_id, reinterpret_cast<char *>(bitmaps_.back().get()));
+    dirty_bitmaps_.back() = false;
+    extent_used_.back() = bitmaps_.back()->GetAllocatedPages();
+  }
 }
 
-void DiskManager::Close() {
+void DiskManager::Sync() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (closed || read_only_) {
+    return;
+  }
+  for (uint32_t extent_id = 0; extent_id < bitmaps_.size(); extent_id++) {
+    if (!dirty_bitmaps_[extent_id]) {
+      continue;
+    }
+    // Pages reserved by a run but not handed out are free on disk, a run does not survive a restart.
+    BitmapPage<PAGE_SIZE> *bitmap = bitmaps_[extent_id].get();
+    BitmapPage<PAGE_SIZE> copy;
+    for (auto &run : runs_) {
+      auto [page_id, end] = run.second;
+      if (page_id == end || page_id / BITMAP_SIZE != extent_id) {
+        continue;
+      }
+      if (bitmap != &copy) {
+        copy = *bitmap;
+        bitmap = &copy;
+      }
+      for (; page_id < end; page_id++) {
+        copy.DeAllocatePage(page_id % BITMAP_SIZE);
+      }
+    }
+    WritePhysicalPage(BitmapPageId(extent_id), reinterpret_cast<char *>(bitmap));
+    dirty_bitmaps_[extent_id] = false;
+  }
   WritePhysicalPage(META_PAGE_ID, meta_data_);
+  if (fsync(db_fd_) != 0) {
+    LOG(ERROR) << "fsync failed: " << strerror(errno);
+  }
+}
+
+size_t DiskManager::Truncate() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (read_only_ || closed) {
+    return 0;
+  }
+  for (auto &run : runs_) {
+    FreeRun(run.second.first, run.second.second);
+  }
+  runs_.clear();
+  // Extents without an allocated page at the end of the file go away with their bitmaps.
+  uint32_t num_extents = bitmaps_.size();
+  uint32_t page_offset = 0;
+  while (num_extents > 0 && !bitmaps_[num_extents - 1]->GetLastAllocatedPage(page_offset)) {
+    num_extents--;
+  }
+  bitmaps_.resize(num_extents);
+  dirty_bitmaps_.resize(num_extents);
+  extent_used_.resize(num_extents);
+  free_extent_hint_ = std::min(free_extent_hint_, num_extents);
+  run_extent_hint_ = std::min(run_extent_hint_, num_extents);
+  // Only the meta page is left if no page is allocated.
+  size_t num_pages = 1;
+  if (num_extents > 0) {
+    num_pages = MapPageId((num_extents - 1) * BITMAP_SIZE + page_offset) + 1;
+  }
+  size_t file_size = file_size_.load();
+  size_t new_file_size = num_pages * PAGE_SIZE;
+  if (new_file_size >= file_size) {
+    Sync();
+    return 0;
+  }
+  if (ftruncate(db_fd_, new_file_size) != 0) {
+    LOG(ERROR) << "ftruncate failed: " << strerror(errno);
+    return 0;
+  }
+  file_size_ = new_file_size;
+  Sync();
+  return (file_size - new_file_size) / PAGE_SIZE;
+}
+
+void DiskManager::Close() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
-    db_io_.close();
+    Sync();
+    if (mapping_ != nullptr) {
+      munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+    }
+    close(db_fd_);
     closed = true;
   }
 }
@@ -44,85 +158,258 @@ void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (read_only_) {
+    return;
+  }
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
-/**
- * TODO: Student Implement
- */
+void DiskManager::AddRead(IoBatch &batch, page_id_t logical_page_id, char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  if (offset >= file_size_.load(std::memory_order_acquire)) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  batch.AddRead(db_fd_, page_data, PAGE_SIZE, offset);
+}
+
+void DiskManager::AddWrite(IoBatch &batch, page_id_t logical_page_id, const char *page_data) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (read_only_) {
+    return;
+  }
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  batch.AddWrite(db_fd_, page_data, PAGE_SIZE, offset);
+  // the page belongs to the file from now on, a read of it must not be answered with zeros while it is in flight
+  size_t end = offset + PAGE_SIZE;
+  size_t size = file_size_.load(std::memory_order_relaxed);
+  while (size < end && !file_size_.compare_exchange_weak(size, end, std::memory_order_release)) {
+  }
+}
+
+size_t DiskManager::AddWrites(IoBatch &batch, std::vector<std::pair<page_id_t, const char *>> &pages) {
+  if (read_only_ || pages.empty()) {
+    return 0;
+  }
+  std::sort(pages.begin(), pages.end());
+  size_t writes = 0;
+  size_t end = 0;
+  std::vector<iovec> iov;
+  page_id_t first = INVALID_PAGE_ID;
+  page_id_t last = INVALID_PAGE_ID;
+  auto add_write = [&]() {
+    size_t offset = static_cast<size_t>(first) * PAGE_SIZE;
+    if (iov.size() == 1) {
+      batch.AddWrite(db_fd_, static_cast<const char *>(iov[0].iov_base), PAGE_SIZE, offset);
+    } else {
+      batch.AddWritev(db_fd_, std::move(iov), offset);
+    }
+    iov.clear();
+    end = std::max(end, offset + static_cast<size_t>(last - first + 1) * PAGE_SIZE);
+    writes++;
+  };
+  for (auto &[logical_page_id, page_data] : pages) {
+    ASSERT(logical_page_id >= 0, "Invalid page id.");
+    page_id_t physical_page_id = MapPageId(logical_page_id);
+    // a bitmap page between two extents breaks a run
+    if (!iov.empty() && (physical_page_id != last + 1 || iov.size() == MAX_COALESCED_PAGES)) {
+      add_write();
+    }
+    if (iov.empty()) {
+      first = physical_page_id;
+    }
+    iov.push_back({const_cast<char *>(page_data), static_cast<size_t>(PAGE_SIZE)});
+    last = physical_page_id;
+  }
+  add_write();
+  // the pages belong to the file from now on, see AddWrite()
+  size_t size = file_size_.load(std::memory_order_relaxed);
+  while (size < end && !file_size_.compare_exchange_weak(size, end, std::memory_order_release)) {
+  }
+  return writes;
+}
+
+char *DiskManager::GetMappedPage(page_id_t logical_page_id) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (mapping_ == nullptr) {
+    return nullptr;
+  }
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  return offset + PAGE_SIZE <= mapping_size_ ? mapping_ + offset : nullptr;
+}
+
 page_id_t DiskManager::AllocatePage() {
-  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(GetMetaData());
-  char buf[PAGE_SIZE];
-  page_id_t physical_page_id;
-  uint32_t i = 0;
-  BitmapPage<PAGE_SIZE> *bitmap_page;
-  uint32_t page_offset;
-  if(meta_page->GetAllocatedPages() >= MAX_VALID_PAGE_ID){
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (read_only_) {
+    LOG(ERROR) << "cannot allocate a page in read-only db file " << file_name_;
     return INVALID_PAGE_ID;
   }
-  for (i = 0; i < meta_page->GetExtentNums(); i++) {
-    if (meta_page->GetExtentUsedPage(i) < BITMAP_SIZE) {
-      physical_page_id = i * (BITMAP_SIZE + 1) + 1;
-      meta_page->num_allocated_pages_++;
-      meta_page->extent_used_page_[i]++;
-      if(meta_page->extent_used_page_[i] == 1){
-        meta_page->num_extents_++;
-      }
-      ReadPhysicalPage(physical_page_id, buf);
-      bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
-      for(page_offset = 0; page_offset < BITMAP_SIZE; page_offset++){
-        if(bitmap_page->AllocatePage(page_offset)){
-          WritePhysicalPage(physical_page_id, buf);
-          return i * BITMAP_SIZE + page_offset;
-        }
-      }
+  for (uint32_t extent_id = free_extent_hint_; extent_id < MAX_EXTENTS; extent_id++) {
+    if (extent_id == bitmaps_.size()) {
+      AddExtent();
     }
-  }
-  meta_page->num_allocated_pages_++;
-  meta_page->extent_used_page_[i] = 1;
-  meta_page->num_extents_++;
-  physical_page_id = i * (BITMAP_SIZE + 1) + 1;
-  ReadPhysicalPage(physical_page_id, buf);
-  bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
-  if(bitmap_page->AllocatePage(page_offset)){
-    WritePhysicalPage(physical_page_id, buf);
-    return i * BITMAP_SIZE + page_offset;
+    uint32_t page_offset;
+    if (!bitmaps_[extent_id]->AllocatePage(page_offset)) {
+      continue;
     }
+    dirty_bitmaps_[extent_id] = true;
+    free_extent_hint_ = extent_id;
+    CountPage(extent_id, true);
+    return extent_id * BITMAP_SIZE + page_offset;
+  }
   return INVALID_PAGE_ID;
 }
 
-/**
- * TODO: Student Implement
- */
+page_id_t DiskManager::AllocatePage(const void *owner) {
+  if (owner == nullptr || read_only_) {
+    return AllocatePage();
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto run = runs_.find(owner);
+  if (run == runs_.end() || run->second.first == run->second.second) {
+    if (!AllocateExtent(owner)) {
+      return AllocatePage();
+    }
+    run = runs_.find(owner);
+  }
+  page_id_t page_id = run->second.first++;
+  CountPage(page_id / BITMAP_SIZE, true);
+  // the run is written as free by Sync(), the page handed out has to be written again
+  dirty_bitmaps_[page_id / BITMAP_SIZE] = true;
+  return page_id;
+}
+
+bool DiskManager::AllocateExtent(const void *owner) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (read_only_) {
+    return false;
+  }
+  ReleaseExtent(owner);
+  for (uint32_t extent_id = std::max(free_extent_hint_, run_extent_hint_); extent_id < MAX_EXTENTS; extent_id++) {
+    if (extent_id == bitmaps_.size()) {
+      AddExtent();
+    }
+    uint32_t page_offset;
+    if (!bitmaps_[extent_id]->AllocateRun(page_offset)) {
+      run_extent_hint_ = extent_id + 1;
+      continue;
+    }
+    dirty_bitmaps_[extent_id] = true;
+    run_extent_hint_ = extent_id;
+    page_id_t first_page_id = extent_id * BITMAP_SIZE + page_offset;
+    runs_[owner] = {first_page_id, first_page_id + RUN_SIZE};
+    return true;
+  }
+  return false;
+}
+
+void DiskManager::ReleaseExtent(const void *owner) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto run = runs_.find(owner);
+  if (run == runs_.end()) {
+    return;
+  }
+  FreeRun(run->second.first, run->second.second);
+  runs_.erase(run);
+}
+
+void DiskManager::FreeRun(page_id_t page_id, page_id_t end) {
+  if (page_id == end) {
+    return;
+  }
+  uint32_t extent_id = page_id / BITMAP_SIZE;
+  for (; page_id < end; page_id++) {
+    bitmaps_[extent_id]->DeAllocatePage(page_id % BITMAP_SIZE);
+  }
+  dirty_bitmaps_[extent_id] = true;
+  free_extent_hint_ = std::min(free_extent_hint_, extent_id);
+  run_extent_hint_ = std::min(run_extent_hint_, extent_id);
+}
+
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  //std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  char buf[PAGE_SIZE];
-  page_id_t physical_page_id = (logical_page_id / BITMAP_SIZE) * (BITMAP_SIZE + 1) + 1;
-  uint32_t page_offset = MapPageId(logical_page_id) - physical_page_id - 1;
-  ReadPhysicalPage(physical_page_id, buf);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
-  if(bitmap_page->DeAllocatePage(page_offset)){
-    DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (read_only_ || logical_page_id < 0 || extent_id >= bitmaps_.size() ||
+      !bitmaps_[extent_id]->DeAllocatePage(logical_page_id % BITMAP_SIZE)) {
+    return;
+  }
+  dirty_bitmaps_[extent_id] = true;
+  free_extent_hint_ = std::min(free_extent_hint_, extent_id);
+  run_extent_hint_ = std::min(run_extent_hint_, extent_id);
+  CountPage(extent_id, false);
+}
+
+void DiskManager::DeAllocatePages(std::vector<page_id_t> page_ids) {
+  std::sort(page_ids.begin(), page_ids.end());
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (read_only_) {
+    return;
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  auto it = std::lower_bound(page_ids.begin(), page_ids.end(), 0);
+  while (it != page_ids.end()) {
+    uint32_t extent_id = *it / BITMAP_SIZE;
+    if (extent_id >= bitmaps_.size()) {
+      break;
+    }
+    // pages of this extent, the batch is sorted so they are next to each other
+    uint32_t freed = 0;
+    for (; it != page_ids.end() && *it / BITMAP_SIZE == extent_id; ++it) {
+      if (bitmaps_[extent_id]->DeAllocatePage(*it % BITMAP_SIZE)) {
+        freed++;
+      }
+    }
+    if (freed == 0) {
+      continue;
+    }
+    dirty_bitmaps_[extent_id] = true;
+    free_extent_hint_ = std::min(free_extent_hint_, extent_id);
+    run_extent_hint_ = std::min(run_extent_hint_, extent_id);
+    uint32_t &used = extent_used_[extent_id];
+    meta_page->num_allocated_pages_ -= freed;
+    used -= freed;
+    if (used == 0) {
+      meta_page->num_extents_--;
+    }
+    if (extent_id < DiskFileMetaPage::META_EXTENTS) {
+      meta_page->extent_used_page_[extent_id] = used;
+    }
+  }
+}
+
+void DiskManager::CountPage(uint32_t extent_id, bool allocated) {
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t &used = extent_used_[extent_id];
+  if (allocated) {
+    meta_page->num_allocated_pages_++;
+    if (used++ == 0) {
+      meta_page->num_extents_++;
+    }
+  } else {
     meta_page->num_allocated_pages_--;
-    meta_page->extent_used_page_[logical_page_id / BITMAP_SIZE]--;
-    if(meta_page->extent_used_page_[logical_page_id / BITMAP_SIZE] == 0){
+    if (--used == 0) {
       meta_page->num_extents_--;
     }
-    WritePhysicalPage(physical_page_id, buf);
+  }
+  if (extent_id < DiskFileMetaPage::META_EXTENTS) {
+    meta_page->extent_used_page_[extent_id] = used;
   }
 }
 
-/**
- * TODO: Student Implement
- */
+void DiskManager::AddExtent() {
+  bitmaps_.emplace_back(new BitmapPage<PAGE_SIZE>());
+  dirty_bitmaps_.push_back(true);
+  extent_used_.push_back(0);
+}
+
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  char buf[PAGE_SIZE];
-  page_id_t physical_bitpage_id = (logical_page_id / BITMAP_SIZE) * (BITMAP_SIZE + 1) + 1;
-  ReadPhysicalPage(physical_bitpage_id, buf);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
-  uint32_t page_offset = MapPageId(logical_page_id) - physical_bitpage_id - 1;
-  return bitmap_page->IsPageFree(page_offset);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (extent_id >= bitmaps_.size()) {
+    return true;
+  }
+  return bitmaps_[extent_id]->IsPageFree(logical_page_id % BITMAP_SIZE);
 }
 
 /**
@@ -132,45 +419,63 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   return logical_page_id / BITMAP_SIZE + logical_page_id + 2;
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+size_t DiskManager::GetFileSize(int fd) {
   struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? stat_buf.st_size : -1;
+  int rc = fstat(fd, &stat_buf);
+  return rc == 0 ? stat_buf.st_size : 0;
 }
 
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file_size_.load(std::memory_order_acquire)) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return;
+  }
+  size_t read_count = 0;
+  while (read_count < PAGE_SIZE) {
+    ssize_t n = pread(db_fd_, page_data + read_count, PAGE_SIZE - read_count, offset + read_count);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      LOG(ERROR) << "I/O error while reading: " << strerror(errno);
+    }
+    if (n <= 0) {
+      break;
+    }
+    read_count += n;
+  }
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
   }
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
-    return;
+  size_t write_count = 0;
+  while (write_count < PAGE_SIZE) {
+    ssize_t n = pwrite(db_fd_, page_data + write_count, PAGE_SIZE - write_count, offset + write_count);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (n < 0) {
+      LOG(ERROR) << "I/O error while writing: " << strerror(errno);
+      return;
+    }
+    write_count += n;
+  }
+  // the file grows when a page past its end is written
+  size_t end = offset + PAGE_SIZE;
+  size_t size = file_size_.load(std::memory_order_relaxed);
+  while (size < end && !file_size_.compare_exchange_weak(size, end, std::memory_order_release)) {
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
@@ -1,62 +1,135 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+
 /**
  * TODO: Student Implement
  */
 bool TableHeap::InsertTuple(Row &row, Txn *txn) {
-
+  // The pages of a read-only database cannot be written, the other changes are refused by FetchPageWrite().
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return false;
+  }
   auto columns = schema_->GetColumns();
   for (auto column : columns) {
     if (column->IsUnique()) {
-      for (auto iter = Begin(txn); iter != End(); iter++) {
-        if (iter->GetField(column->GetTableInd())->CompareEquals(*(row.GetField(column->GetTableInd())))) {
+      // the rows are read in place and compared with the kernel of the column, a null is taken as a duplicate
+      uint32_t column_index = column->GetTableInd();
+      const Field *value = row.GetField(column_index);
+      FieldCompareFn compare = schema_->GetCompareFn(column_index);
+      for (auto iter = Begin(txn); iter != End(); ++iter) {
+        Field other = iter.View().GetField(column_index);
+        if (value->IsNull() || other.IsNull() || compare(other, *value) == 0) {
           return false;
         }
       }
     }
   }
 
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  page->WLatch();
-  bool good_insert = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  while (!good_insert) {
+  std::vector<page_id_t> overflow_pages;
+  if (!SpillValues(row, &overflow_pages)) {
+    return false;
+  }
+  if (!PlaceTuple(row, txn, overflow_pages)) {
+    FreeOverflowPages(overflow_pages);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @return the overflow pages of a row as a page can keep them, nullptr if the row keeps all its values
+ */
+static const page_id_t *OverflowPagesFor(TablePage *page, const std::vector<page_id_t> &overflow_pages) {
+  if (overflow_pages.empty() || page->GetRowFormat() != RowFormat::kCompact) {
+    return nullptr;
+  }
+  return overflow_pages.data();
+}
+
+bool TableHeap::PlaceTuple(Row &row, Txn *txn, const std::vector<page_id_t> &overflow_pages) {
+  page_id_t page_id = first_page_id_;
+  while (true) {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    if (!guard) {
+      return false;
+    }
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    const page_id_t *stubs = OverflowPagesFor(page, overflow_pages);
+    if (page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_, stubs)) {
+      guard.SetDirty();
+      if (stubs == nullptr) {
+        // a tagged page keeps the values in the row
+        FreeOverflowPages(overflow_pages);
+      }
+      return true;
+    }
     page_id_t next_id = page->GetNextPageId();
-    if (next_id == INVALID_PAGE_ID) {
-      page_id_t now_id = page->GetTablePageId();
-      page_id_t new_id;
-      TablePage *old_page = page;
-      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_id));
-      old_page->SetNextPageId(new_id);
-      page->Init(new_id, now_id, log_manager_, txn);
-      page->WLatch();
-      good_insert = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(now_id, true);
-    } else {
-      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_id));
-      page->WLatch();
-      good_insert = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+    if (next_id != INVALID_PAGE_ID) {
+      page_id = next_id;
+      continue;
+    }
+    // Every page is full, chain a new one behind the last page.
+    BasicPageGuard new_guard = buffer_pool_manager_->NewPageGuarded(next_id, this);
+    if (!new_guard) {
+      return false;
     }
+    auto new_page = reinterpret_cast<TablePage *>(new_guard.GetPageMut());
+    new_page->Init(next_id, page_id, log_manager_, txn);
+    page->SetNextPageId(next_id);
+    guard.SetDirty();
+    // A tuple that does not fit in an empty page does not fit anywhere.
+    return new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_,
+                                 OverflowPagesFor(new_page, overflow_pages));
+  }
+}
+
+bool TableHeap::SpillValues(const Row &row, std::vector<page_id_t> *overflow_pages) {
+  if (!schema_->MayOverflow()) {
+    return true;
+  }
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    const Column *column = schema_->GetColumn(i);
+    const Field *field = row.GetField(i);
+    if (column->GetType() != TypeId::kTypeChar || column->GetLength() <= CHAR_OVERFLOW_THRESHOLD || field->IsNull() ||
+        field->GetLength() <= CHAR_OVERFLOW_THRESHOLD) {
+      continue;
+    }
+    if (overflow_pages->empty()) {
+      overflow_pages->resize(schema_->GetColumnCount(), INVALID_PAGE_ID);
+    }
+    // the prefix stays in the row, the chain holds the rest
+    page_id_t page_id = OverflowPage::WriteChain(buffer_pool_manager_, field->GetData() + CHAR_OVERFLOW_PREFIX_LEN,
+                                                 field->GetLength() - CHAR_OVERFLOW_PREFIX_LEN, this);
+    if (page_id == INVALID_PAGE_ID) {
+      FreeOverflowPages(*overflow_pages);
+      overflow_pages->clear();
+      return false;
+    }
+    (*overflow_pages)[i] = page_id;
   }
   return true;
 }
 
+size_t TableHeap::FreeOverflowPages(const std::vector<page_id_t> &overflow_pages) {
+  size_t freed = 0;
+  for (auto page_id : overflow_pages) {
+    if (page_id != INVALID_PAGE_ID) {
+      freed += OverflowPage::FreeChain(buffer_pool_manager_, page_id);
+    }
+  }
+  return freed;
+}
+
 bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the recovery.
-  if (page == nullptr) {
+  if (!guard) {
     return false;
   }
   // Otherwise, mark the tuple as deleted.
-  page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  reinterpret_cast<TablePage *>(guard.GetPageMut())->MarkDelete(rid, txn, lock_manager_, log_manager_);
   return true;
 }
 
@@ -64,34 +137,52 @@ bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
  * TODO: Student Implement
  */
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
-  Row old_row(rid);
-  page_id_t page_id = rid.GetPageId();
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-  if (page == nullptr) {
+  std::vector<page_id_t> overflow_pages;
+  if (!SpillValues(row, &overflow_pages)) {
     return false;
   }
-  page->WLatch();
-  TABLE_PAGE_UPDATE update = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
+  std::vector<page_id_t> old_overflow_pages;
+  Row old_row(rid);
+  TABLE_PAGE_UPDATE update;
+  bool keeps_stubs;
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+    if (!guard) {
+      FreeOverflowPages(overflow_pages);
+      return false;
+    }
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    const page_id_t *stubs = OverflowPagesFor(page, overflow_pages);
+    keeps_stubs = stubs != nullptr;
+    page->GetOverflowPages(rid, schema_, &old_overflow_pages);
+    update = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_, stubs, buffer_pool_manager_);
+    if (update == TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_SUCCESS) {
+      guard.SetDirty();
+      row.SetRowId(rid);
+    }
+  }
   if (update == TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_SUCCESS) {
-    row.SetRowId(rid);
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+    // the chains of the old values go, and so do the new ones if the page keeps the values in the row
+    FreeOverflowPages(old_overflow_pages);
+    if (!keeps_stubs) {
+      FreeOverflowPages(overflow_pages);
+    }
     return true;
   }
-  else if (update == TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_NEW_PAGE) {
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+  if (update == TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_NEW_PAGE) {
+    // The new tuple does not fit in the page any more, move it. The page latch is released by now.
     bool flag1;
     bool flag2;
     flag1 = MarkDelete(rid, txn);
     ApplyDelete(rid, txn);
-    flag2 = InsertTuple(row, txn);
+    flag2 = PlaceTuple(row, txn, overflow_pages);
+    if (!flag2) {
+      FreeOverflowPages(overflow_pages);
+    }
     return flag1 & flag2;
-  } else {
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    return false;
   }
-
+  FreeOverflowPages(overflow_pages);
+  return false;
 }
 
 /**
@@ -99,78 +190,255 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
  */
 void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
   // Step1: Find the page which contains the tuple.
-  // Step2: Delete the tuple from the page.
-  page_id_t page_id = rid.GetPageId();
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-  if (page == nullptr) {
-    return;
+  // Step2: Delete the tuple from the page, then the chains of the values it kept out of line.
+  std::vector<page_id_t> overflow_pages;
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+    if (!guard) {
+      return;
+    }
+    auto page = reinterpret_cast<TablePage *>(guard.GetPageMut());
+    page->GetOverflowPages(rid, schema_, &overflow_pages);
+    page->ApplyDelete(rid, txn, log_manager_);
   }
-  page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  FreeOverflowPages(overflow_pages);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  assert(page != nullptr);
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  if (!guard) {
+    return;
+  }
   // Rollback to delete.
-  page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  reinterpret_cast<TablePage *>(guard.GetPageMut())->RollbackDelete(rid, txn, log_manager_);
 }
 
 /**
  * TODO: Student Implement
  */
-bool TableHeap::GetTuple(Row *row, Txn *txn) {
+bool TableHeap::GetTuple(Row *row, Txn *txn, BufferAccessStrategy *strategy) {
   RowId rid = row->GetRowId();
-  page_id_t page_id = rid.GetPageId();
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-
-  if (page == nullptr) {
+  ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(rid.GetPageId(), strategy);
+  if (!guard) {
     return false;
   }
-
-  if (page->GetTuple(row, schema_, txn, lock_manager_)) {
+  bool found = reinterpret_cast<TablePage *>(guard.GetPage())
+                   ->GetTuple(row, schema_, txn, lock_manager_, buffer_pool_manager_);
+  if (found) {
     row->SetRowId(rid);
-    buffer_pool_manager_->UnpinPage(page_id, false);
-    return true;
   }
-  else
+  return found;
+}
+
+bool TableHeap::GetTupleView(const RowId &rid, ReadPageGuard &guard, RowView *view, BufferAccessStrategy *strategy) {
+  if (!guard || guard.PageId() != rid.GetPageId()) {
+    // let go of the old page before latching the new one
+    guard.Drop();
+    guard = buffer_pool_manager_->FetchPageRead(rid.GetPageId(), strategy);
+    if (!guard) {
+      return false;
+    }
+  }
+  return reinterpret_cast<TablePage *>(guard.GetPage())->GetTupleView(rid, schema_, view, buffer_pool_manager_);
+}
+
+size_t TableHeap::DeleteTable() {
+  if (buffer_pool_manager_->IsReadOnly()) {
+    return 0;
+  }
+  buffer_pool_manager_->ReleaseExtent(this);
+  auto strategy = std::make_shared<BufferAccessStrategy>(buffer_pool_manager_);
+  ReadAheadWindow read_ahead;
+  size_t freed = 0;
+  vector<page_id_t> batch;
+  batch.reserve(DEFAULT_DELETE_BATCH_PAGES);
+  vector<page_id_t> overflow_pages;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    {
+      ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id, strategy.get());
+      if (!guard) {
+        break;
+      }
+      batch.push_back(page_id);
+      auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+      page->GetOverflowPages(schema_, &overflow_pages);
+      page_id = page->GetNextPageId();
+    }
+    size_t ahead = read_ahead.Advance();
+    if (ahead > 0 && page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->PrefetchChain(page_id, ahead, TablePage::NextPageOf, strategy);
+    }
+    if (batch.size() == DEFAULT_DELETE_BATCH_PAGES) {
+      freed += buffer_pool_manager_->DeletePages(batch);
+      batch.clear();
+    }
+  }
+  freed += buffer_pool_manager_->DeletePages(batch);
+  freed += FreeOverflowPages(overflow_pages);
+  first_page_id_ = INVALID_PAGE_ID;
+  return freed;
+}
+
+VacuumStats TableHeap::Vacuum(Txn *txn, const TupleMoveFunc &on_move) {
+  VacuumStats stats;
+  // The pages this heap reserved and did not use yet would keep the end of the file allocated.
+  buffer_pool_manager_->ReleaseExtent(this);
+  // 1. Give the space of deleted tuples back to their pages.
+  vector<page_id_t> page_ids;
+  vector<page_id_t> overflow_pages;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    if (!guard) {
+      FreeOverflowPages(overflow_pages);
+      return stats;
+    }
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    uint32_t purged = page->PurgeDeleted(txn, log_manager_, schema_, &overflow_pages);
+    if (purged > 0) {
+      guard.SetDirty();
+      stats.purged_tuples_ += purged;
+    }
+    page_ids.push_back(page_id);
+    page_id = page->GetNextPageId();
+  }
+  FreeOverflowPages(overflow_pages);
+  if (page_ids.empty()) {
+    return stats;
+  }
+  // 2. Fill the pages with the lowest ids from the pages with the highest ids, the first page is filled first.
+  sort(page_ids.begin() + 1, page_ids.end());
+  size_t to = 0;
+  size_t from = page_ids.size() - 1;
+  while (to < from) {
+    if (MoveTuples(page_ids[from], page_ids[to], txn, on_move, stats)) {
+      UnlinkPage(page_ids[from]);
+      stats.freed_pages_++;
+      from--;
+    } else {
+      to++;
+    }
+  }
+  page_ids.resize(from + 1);
+  // 3. Move the pages left, highest first, to the lowest free page of the file while that one is lower.
+  for (size_t i = page_ids.size() - 1; i > 0; i--) {
+    page_id_t old_page_id = page_ids[i];
+    page_id_t new_page_id;
+    {
+      BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(new_page_id);
+      if (!guard) {
+        break;
+      }
+      if (new_page_id > old_page_id) {
+        guard.Drop();
+        buffer_pool_manager_->DeletePage(new_page_id);
+        break;
+      }
+      reinterpret_cast<TablePage *>(guard.GetPageMut())->Init(new_page_id, old_page_id, log_manager_, txn);
+    }
+    // Chain the new page right behind the old one, then empty and unlink the old one.
+    {
+      WritePageGuard old_guard = buffer_pool_manager_->FetchPageWrite(old_page_id);
+      WritePageGuard new_guard = buffer_pool_manager_->FetchPageWrite(new_page_id);
+      auto old_page = reinterpret_cast<TablePage *>(old_guard.GetPageMut());
+      auto new_page = reinterpret_cast<TablePage *>(new_guard.GetPageMut());
+      page_id_t next_page_id = old_page->GetNextPageId();
+      new_page->SetNextPageId(next_page_id);
+      old_page->SetNextPageId(new_page_id);
+      if (next_page_id != INVALID_PAGE_ID) {
+        WritePageGuard next_guard = buffer_pool_manager_->FetchPageWrite(next_page_id);
+        reinterpret_cast<TablePage *>(next_guard.GetPageMut())->SetPrevPageId(new_page_id);
+      }
+    }
+    if (MoveTuples(old_page_id, new_page_id, txn, on_move, stats)) {
+      UnlinkPage(old_page_id);
+      stats.relocated_pages_++;
+    }
+  }
+  return stats;
+}
+
+bool TableHeap::MoveTuples(page_id_t from_page_id, page_id_t to_page_id, Txn *txn, const TupleMoveFunc &on_move,
+                           VacuumStats &stats) {
+  WritePageGuard to_guard = buffer_pool_manager_->FetchPageWrite(to_page_id);
+  WritePageGuard from_guard = buffer_pool_manager_->FetchPageWrite(from_page_id);
+  if (!to_guard || !from_guard) {
     return false;
+  }
+  auto to_page = reinterpret_cast<TablePage *>(to_guard.GetPage());
+  auto from_page = reinterpret_cast<TablePage *>(from_guard.GetPage());
+  RowId rid;
+  RowId new_rid;
+  while (from_page->GetFirstTupleRid(&rid)) {
+    if (from_page->GetRowFormat() == RowFormat::kCompact && to_page->GetRowFormat() == RowFormat::kCompact) {
+      // the bytes move as they are: the values kept out of line stay where they are and are not read
+      if (!to_page->CopyTuple(from_page, rid, &new_rid)) {
+        break;
+      }
+      from_page->ApplyDelete(rid, txn, log_manager_);
+    } else {
+      // a tagged page keeps every value in the row, a tagged row has none out of line
+      Row row(rid);
+      from_page->GetTuple(&row, schema_, txn, lock_manager_, buffer_pool_manager_);
+      vector<page_id_t> overflow_pages;
+      from_page->GetOverflowPages(rid, schema_, &overflow_pages);
+      if (!to_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+        break;
+      }
+      from_page->ApplyDelete(rid, txn, log_manager_);
+      FreeOverflowPages(overflow_pages);
+      new_rid = row.GetRowId();
+    }
+    to_guard.SetDirty();
+    from_guard.SetDirty();
+    RowView view;
+    to_page->GetTupleView(new_rid, schema_, &view, buffer_pool_manager_);
+    on_move(view, rid);
+    stats.moved_tuples_++;
+  }
+  return !from_page->GetFirstTupleRid(&rid);
 }
 
-void TableHeap::DeleteTable(page_id_t page_id) {
-  if (page_id != INVALID_PAGE_ID) {
-    auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
-    if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
-      DeleteTable(temp_table_page->GetNextPageId());
-    buffer_pool_manager_->UnpinPage(page_id, false);
-    buffer_pool_manager_->DeletePage(page_id);
-  } else {
-    DeleteTable(first_page_id_);
+void TableHeap::UnlinkPage(page_id_t page_id) {
+  page_id_t prev_page_id;
+  page_id_t next_page_id;
+  {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id);
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    prev_page_id = page->GetPrevPageId();
+    next_page_id = page->GetNextPageId();
+  }
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(prev_page_id);
+    reinterpret_cast<TablePage *>(guard.GetPageMut())->SetNextPageId(next_page_id);
+  }
+  if (next_page_id != INVALID_PAGE_ID) {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(next_page_id);
+    reinterpret_cast<TablePage *>(guard.GetPageMut())->SetPrevPageId(prev_page_id);
   }
+  buffer_pool_manager_->DeletePage(page_id);
 }
 
 /**
  * TODO: Student Implement
  */
 TableIterator TableHeap::Begin(Txn *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (page == nullptr)
-    return TableIterator(this, RowId(), nullptr);
-
-  RowId rowId;
-  while (!page->GetFirstTupleRid(&rowId) && page->GetNextPageId() != INVALID_PAGE_ID) {
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page->GetNextPageId()));
-  }
-  if (page->GetFirstTupleRid(&rowId)) {
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    return TableIterator(this, rowId, txn);
+  auto strategy = std::make_shared<BufferAccessStrategy>(buffer_pool_manager_);
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id, strategy.get());
+    if (!guard) {
+      break;
+    }
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    RowId rowId;
+    bool found = page->GetFirstTupleRid(&rowId);
+    page_id = page->GetNextPageId();
+    if (found) {
+      return TableIterator(this, rowId, txn, strategy);
+    }
   }
   return TableIterator(this, RowId(), nullptr);
 }
@@ -6,17 +6,19 @@
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, std::shared_ptr<BufferAccessStrategy> strategy)
+    : strategy_(std::move(strategy)) {
   this->tableHeap = table_heap;
   this->rid = rid;
   this->txn = txn;
-
 }
 
 TableIterator::TableIterator(const TableIterator &other) {
   this->tableHeap = other.tableHeap;
   this->rid = other.rid;
   this->txn = other.txn;
+  this->strategy_ = other.strategy_;
+  this->read_ahead_ = other.read_ahead_;
   row = Row();
 }
 
@@ -41,43 +43,79 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
+  Release();
   row = Row();
   row.SetRowId(this->rid);
-  this->tableHeap->GetTuple(&row, this->txn);
+  this->tableHeap->GetTuple(&row, this->txn, strategy_.get());
 
   return row;
 }
 
 Row *TableIterator::operator->() {
+  Release();
   row = Row();
   row.SetRowId(this->rid);
-  this->tableHeap->GetTuple(&row, this->txn);
+  this->tableHeap->GetTuple(&row, this->txn, strategy_.get());
 
   return &row;
 }
 
-TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept = default;
+const RowView &TableIterator::View() {
+  tableHeap->GetTupleView(rid, guard_, &view_, strategy_.get());
+  return view_;
+}
+
+TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
+  Release();
+  this->tableHeap = itr.tableHeap;
+  this->rid = itr.rid;
+  this->txn = itr.txn;
+  this->row = itr.row;
+  this->strategy_ = itr.strategy_;
+  this->read_ahead_ = itr.read_ahead_;
+  return *this;
+}
 
 // ++iter
 TableIterator &TableIterator::operator++() {
-  page_id_t page_id = rid.GetPageId();
-  auto page = reinterpret_cast<TablePage *>(tableHeap->buffer_pool_manager_->FetchPage(page_id));
+  BufferPoolManager *buffer_pool_manager = tableHeap->buffer_pool_manager_;
+  // A viewed page is kept, and so is the page the iterator moves to, for the next View().
+  bool viewing = guard_ && guard_.PageId() == rid.GetPageId();
+  page_id_t next_page_id;
   RowId next_rid;
-  if (page->GetNextTupleRid(this->rid, &next_rid)) {
-    this->rid = next_rid;
-    tableHeap->buffer_pool_manager_->UnpinPage(page_id, false);
-    return *this;
+  {
+    ReadPageGuard guard =
+        viewing ? std::move(guard_) : buffer_pool_manager->FetchPageRead(rid.GetPageId(), strategy_.get());
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    if (page->GetNextTupleRid(this->rid, &next_rid)) {
+      this->rid = next_rid;
+      if (viewing) {
+        guard_ = std::move(guard);
+      }
+      return *this;
+    }
+    next_page_id = page->GetNextPageId();
   }
-
-  while (page->GetNextPageId() != INVALID_PAGE_ID) {
-    page = reinterpret_cast<TablePage *>(tableHeap->buffer_pool_manager_->FetchPage(page->GetNextPageId()));
-    if (page->GetFirstTupleRid(&next_rid)) {
+  Release();
+  while (next_page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = buffer_pool_manager->FetchPageRead(next_page_id, strategy_.get());
+    auto page = reinterpret_cast<TablePage *>(guard.GetPage());
+    bool found = page->GetFirstTupleRid(&next_rid);
+    next_page_id = page->GetNextPageId();
+    if (!found || !viewing) {
+      guard.Drop();
+    }
+    // Have the following pages read while this one is scanned.
+    size_t read_ahead = read_ahead_.Advance();
+    if (read_ahead > 0 && next_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager->PrefetchChain(next_page_id, read_ahead, TablePage::NextPageOf, strategy_);
+    }
+    if (found) {
       this->rid = next_rid;
-      tableHeap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+      guard_ = std::move(guard);
       return *this;
     }
   }
-  tableHeap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
   rid = RowId();
   txn = nullptr;
   return *this;
@@ -85,25 +123,7 @@ TableIterator &TableIterator::operator++() {
 
 // iter++
 TableIterator TableIterator::operator++(int) {
-  page_id_t page_id = rid.GetPageId();
-  RowId old_rid = rid;
-  auto page = reinterpret_cast<TablePage *>(tableHeap->buffer_pool_manager_->FetchPage(page_id));
-  RowId next_rid;
-  if (page->GetNextTupleRid(this->rid, &next_rid)) {
-    this->rid = next_rid;
-    tableHeap->buffer_pool_manager_->UnpinPage(page_id, false);
-    return TableIterator(tableHeap, old_rid, txn);
-  }
-
-  while (page->GetNextPageId() != INVALID_PAGE_ID) {
-    page = reinterpret_cast<TablePage *>(tableHeap->buffer_pool_manager_->FetchPage(page->GetNextPageId()));
-    if (page->GetFirstTupleRid(&next_rid)) {
-      this->rid = next_rid;
-      tableHeap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-      return TableIterator(tableHeap, old_rid, txn);
-    }
-  }
-  this->rid = RowId();
-  this->txn = nullptr;
-  return TableIterator(tableHeap, RowId(), nullptr);
+  TableIterator old(*this);
+  ++(*this);
+  return old;
 }
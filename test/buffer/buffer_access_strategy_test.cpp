@@ -0,0 +1,76 @@
+#include "buffer/buffer_access_strategy.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(BufferAccessStrategyTest, ScanKeepsWorkingSetTest) {
+  const std::string db_name = "bpm_strategy_test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_hot_pages = 8;
+  const int num_scan_pages = 100;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  std::vector<page_id_t> scan_pages;
+  for (int i = 0; i < num_scan_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    scan_pages.push_back(page_id);
+  }
+  // Scenario: the hot pages are written to disk, then changed in memory only. A hot page that gets evicted would be
+  // read back with its old content.
+  std::vector<page_id_t> hot_pages;
+  for (int i = 0; i < num_hot_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "disk");
+    EXPECT_TRUE(bpm->FlushPage(page_id));
+    snprintf(page->GetData(), PAGE_SIZE, "memory");
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    hot_pages.push_back(page_id);
+  }
+
+  // Scenario: a scan through a small ring reads every page without touching the hot pages.
+  {
+    BufferAccessStrategy strategy(bpm, 4);
+    for (auto page_id : scan_pages) {
+      Page *page = bpm->FetchPage(page_id, &strategy);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+  }
+  for (auto page_id : hot_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("memory", std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: the same scan without a strategy flushes the hot pages out.
+  for (auto page_id : scan_pages) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  Page *page = bpm->FetchPage(hot_pages[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("disk", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(hot_pages[0], false));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
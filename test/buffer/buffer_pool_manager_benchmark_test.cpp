@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+/**
+ * Measures the throughput of buffer hits (FetchPage + UnpinPage on resident pages) from 1 to 32 threads. The whole
+ * working set fits in one instance, so every thread goes through the same page table and the numbers show how well
+ * the hit path scales without a latch.
+ */
+TEST(BufferPoolManagerBenchmarkTest, HitPathScalingTest) {
+  const std::string db_name = "bpm_benchmark_test.db";
+  const size_t buffer_pool_size = 1024;
+  const int working_set = 256;
+  const int ops_per_thread = 200000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1);
+
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < working_set; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    page_ids.push_back(page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        std::minstd_rand rng(t);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t page_id = page_ids[rng() % working_set];
+          Page *page = bpm->FetchPage(page_id);
+          ASSERT_NE(nullptr, page);
+          ASSERT_EQ(page_id, page->GetPageId());
+          bpm->UnpinPage(page_id, false);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double total_ops = static_cast<double>(num_threads) * ops_per_thread;
+    std::cout << "threads: " << num_threads << ", hits: " << total_ops / elapsed.count() / 1e6 << " M/s"
+              << std::endl;
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
@@ -1,9 +1,14 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "buffer/read_ahead_window.h"
 #include "gtest/gtest.h"
 
 TEST(BufferPoolManagerTest, BinaryDataTest) {
@@ -71,4 +76,655 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, ParallelInstancesTest) {
+  const std::string db_name = "bpm_parallel_test.db";
+  const size_t buffer_pool_size = 64;
+  const size_t num_instances = 4;
+  const int num_threads = 8;
+  const int pages_per_thread = 100;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, num_instances);
+  EXPECT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: concurrent sessions create pages, every page is routed to exactly one instance.
+  std::vector<std::vector<page_id_t>> page_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+        page_ids[t].push_back(page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  // Scenario: pages were evicted from their instances and can be read back concurrently.
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (auto page_id : page_ids[t]) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, ConcurrentHitAndEvictionTest) {
+  const std::string db_name = "bpm_eviction_test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+  const int num_threads = 8;
+  const int ops_per_thread = 2000;
+
+  for (auto replacer_type : {ReplacerType::kLRU, ReplacerType::kClock, ReplacerType::kLRUK, ReplacerType::k2Q}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1, replacer_type);
+
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+      page_ids.push_back(page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // Scenario: lock-free hits race with evictions, a pinned page must always hold the requested content.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        std::minstd_rand rng(t);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t page_id = page_ids[rng() % (i % 2 == 0 ? 4 : num_pages)];
+          Page *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          EXPECT_EQ(page_id, page->GetPageId());
+          EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+          EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+    disk_manager->Close();
+    remove(db_name.c_str());
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerTest, PageCleanerTest) {
+  const std::string db_name = "bpm_cleaner_test.db";
+  const size_t buffer_pool_size = 32;
+  const size_t clean_target = 8;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1);
+
+  auto add_dirty_pages = [&](size_t num_pages) {
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  };
+
+  // Scenario: the free frames are enough to reach the clean target, the cleaner leaves the dirty pages alone.
+  add_dirty_pages(buffer_pool_size - clean_target);
+  bpm->StartCleaner(clean_target, 1);
+  for (int i = 0; i < 1000 && bpm->GetCleanerStats().rounds_ < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopCleaner();
+  EXPECT_LE(2, bpm->GetCleanerStats().rounds_);
+  EXPECT_EQ(0, bpm->GetCleanerStats().pages_cleaned_);
+
+  // Scenario: once the pool is full of dirty unpinned pages, the cleaner writes back the pages at the cold end of the
+  // pool in the background.
+  add_dirty_pages(clean_target);
+  bpm->StartCleaner(clean_target, 1);
+  for (int i = 0; i < 1000 && bpm->GetCleanerStats().pages_cleaned_ < clean_target; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopCleaner();
+  CleanerStats stats = bpm->GetCleanerStats();
+  EXPECT_LE(1, stats.rounds_);
+  EXPECT_EQ(clean_target, stats.pages_cleaned_);
+
+  // Scenario: new pages take the cleaned frames, nobody has to write a victim back.
+  for (size_t i = 0; i < clean_target; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetCleanerStats().dirty_evictions_);
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(clean_target); page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: after FlushAllPages the whole pool can be replaced without writing anything.
+  bpm->FlushAllPages();
+  uint64_t dirty_evictions = bpm->GetCleanerStats().dirty_evictions_;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(dirty_evictions, bpm->GetCleanerStats().dirty_evictions_);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, ReadAheadTest) {
+  const std::string db_name = "bpm_read_ahead_test.db";
+  const size_t buffer_pool_size = 32;
+  const int num_pages = 20;
+  const size_t chain_length = 10;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: a chain of pages linked through their first bytes is written to disk.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    page_ids.push_back(page_id);
+  }
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    page_id_t next_page_id = i + 1 < num_pages ? page_ids[i + 1] : INVALID_PAGE_ID;
+    memcpy(page->GetData(), &next_page_id, sizeof(page_id_t));
+    snprintf(page->GetData() + sizeof(page_id_t), PAGE_SIZE - sizeof(page_id_t), "disk");
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  delete bpm;
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: the I/O thread follows the chain and loads the listed pages.
+  auto next_page = [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); };
+  bpm->PrefetchChain(page_ids[0], chain_length, next_page);
+  bpm->PrefetchPages({page_ids[num_pages - 2], page_ids[num_pages - 1]});
+  for (int i = 0; i < 1000 && bpm->GetPrefetchedPages() < chain_length + 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(chain_length + 2, bpm->GetPrefetchedPages());
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: the pages change on disk, fetching the prefetched ones still returns the content that was read ahead.
+  char buf[PAGE_SIZE];
+  for (int i = 0; i < num_pages; i++) {
+    memset(buf, 0, PAGE_SIZE);
+    snprintf(buf + sizeof(page_id_t), PAGE_SIZE - sizeof(page_id_t), "changed");
+    disk_manager->WritePage(page_ids[i], buf);
+  }
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    bool prefetched = i < static_cast<int>(chain_length) || i >= num_pages - 2;
+    EXPECT_EQ(prefetched ? "disk" : "changed", std::string(page->GetData() + sizeof(page_id_t)));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(chain_length + 2, bpm->GetPrefetchedPages());
+
+  disk_manager->Close();
+  remove(db_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ReadAheadWindowTest, GrowTest) {
+  ReadAheadWindow window(8);
+  // The first request asks for the initial window, later ones double it once half of the window is used up.
+  EXPECT_EQ(DEFAULT_READ_AHEAD_MIN_PAGES, window.Advance());
+  EXPECT_EQ(4, window.Advance());
+  EXPECT_EQ(0, window.Advance());
+  EXPECT_EQ(8, window.Advance());
+  for (int i = 0; i < 100; i++) {
+    size_t read_ahead = window.Advance();
+    EXPECT_TRUE(read_ahead == 0 || read_ahead == 8);
+  }
+  EXPECT_EQ(8, window.GetWindow());
+}
+
+TEST(BufferPoolManagerTest, SharedPoolTest) {
+  const std::vector<std::string> db_names = {"bpm_shared_test_0.db", "bpm_shared_test_1.db"};
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 24;
+
+  auto *buffer_pool = new BufferPool(buffer_pool_size, 2);
+  std::vector<DiskManager *> disk_managers;
+  std::vector<BufferPoolManager *> bpms;
+  for (auto &db_name : db_names) {
+    remove(db_name.c_str());
+    disk_managers.push_back(new DiskManager(db_name));
+    bpms.push_back(new BufferPoolManager(buffer_pool, disk_managers.back()));
+  }
+  EXPECT_NE(bpms[0]->GetDatabaseId(), bpms[1]->GetDatabaseId());
+  EXPECT_EQ(buffer_pool_size, bpms[1]->GetPoolSize());
+
+  // Scenario: both databases use the same page ids, together they need more frames than the pool has.
+  for (int i = 0; i < num_pages; i++) {
+    for (size_t db = 0; db < bpms.size(); db++) {
+      page_id_t page_id;
+      Page *page = bpms[db]->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(i, page_id);
+      snprintf(page->GetData(), PAGE_SIZE, "%zu:%d", db, page_id);
+      EXPECT_TRUE(bpms[db]->UnpinPage(page_id, true));
+    }
+  }
+  for (int i = num_pages - 1; i >= 0; i--) {
+    for (size_t db = 0; db < bpms.size(); db++) {
+      Page *page = bpms[db]->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(db) + ":" + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpms[db]->UnpinPage(i, false));
+    }
+  }
+
+  // Scenario: closing a database writes its pages back and leaves the other one alone.
+  delete bpms[0];
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpms[1]->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("1:" + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpms[1]->UnpinPage(i, false));
+  }
+  bpms[0] = new BufferPoolManager(buffer_pool, disk_managers[0]);
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpms[0]->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("0:" + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpms[0]->UnpinPage(i, false));
+  }
+  EXPECT_TRUE(bpms[0]->CheckAllUnpinned());
+  EXPECT_TRUE(bpms[1]->CheckAllUnpinned());
+
+  for (size_t db = 0; db < bpms.size(); db++) {
+    delete bpms[db];
+    disk_managers[db]->Close();
+    delete disk_managers[db];
+    remove(db_names[db].c_str());
+  }
+  delete buffer_pool;
+}
+
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "bpm_resize_test.db";
+  const size_t buffer_pool_size = 8;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: grow the pool while pages are pinned, the pinned pages keep their frames.
+  std::vector<Page *> pinned;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    pinned.push_back(page);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  EXPECT_EQ(3 * buffer_pool_size, bpm->Resize(3 * buffer_pool_size));
+  EXPECT_EQ(3 * buffer_pool_size, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < 3 * buffer_pool_size; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(pinned[i], bpm->FetchPage(i));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: shrink below the number of pinned pages, only the unpinned pages are written back and dropped.
+  EXPECT_EQ(buffer_pool_size, bpm->Resize(2));
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(pinned[i], bpm->FetchPage(i));
+    EXPECT_EQ("page " + std::to_string(i), std::string(pinned[i]->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  EXPECT_EQ(2, bpm->Resize(2));
+  for (page_id_t i = 0; i < static_cast<page_id_t>(3 * buffer_pool_size); i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: grow again, the retired frames come back before new ones are allocated.
+  EXPECT_EQ(4 * buffer_pool_size, bpm->Resize(4 * buffer_pool_size));
+  for (page_id_t i = 0; i < static_cast<page_id_t>(3 * buffer_pool_size); i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+  }
+  for (page_id_t i = 0; i < static_cast<page_id_t>(3 * buffer_pool_size); i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ReadOnlyMappingTest) {
+  const std::string db_name = "bpm_read_only_test.db";
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 16;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+  delete bpm;
+  delete disk_manager;
+
+  // Scenario: the frames of a read-only database point into the mapping, through misses and evictions.
+  disk_manager = new DiskManager(db_name, true);
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  ASSERT_TRUE(disk_manager->IsReadOnly());
+  for (int round = 0; round < 2; round++) {
+    for (page_id_t i = 0; i < num_pages; i++) {
+      Page *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(disk_manager->GetMappedPage(i), page->GetData());
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+  }
+  // Read-ahead maps the pages as well.
+  bpm->PrefetchPages({0, 1, 2});
+  for (int i = 0; i < 1000 && bpm->GetPrefetchedPages() < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  Page *page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(disk_manager->GetMappedPage(1), page->GetData());
+
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  // Scenario: a page cannot be written, allocated or deleted.
+  EXPECT_TRUE(bpm->IsReadOnly());
+  EXPECT_FALSE(bpm->FetchPageWrite(1));
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  EXPECT_FALSE(bpm->DeletePage(1));
+  EXPECT_EQ(0, bpm->DeletePages({1, 2}));
+  EXPECT_FALSE(bpm->IsPageFree(1));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+
+  // Scenario: the frames go back to their own memory once the database is writable again.
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(nullptr, disk_manager->GetMappedPage(1));
+  EXPECT_EQ("page 1", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, StatsTest) {
+  const std::string db_name = "bpm_stats_test.db";
+  const size_t buffer_pool_size = 4;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.pool_size_);
+  EXPECT_EQ(0, stats.hits_ + stats.misses_ + stats.evictions_ + stats.dirty_write_backs_);
+
+  // Scenario: new pages beyond the pool size evict the oldest ones, which are dirty.
+  for (size_t i = 0; i < buffer_pool_size + 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(2, stats.evictions_);
+  EXPECT_EQ(2, stats.dirty_write_backs_);
+  EXPECT_EQ(2, stats.write_latency_.count_);
+  EXPECT_EQ(0, stats.hits_ + stats.misses_);
+
+  // Scenario: a resident page is a hit, an evicted one is a miss that reads from disk.
+  ASSERT_NE(nullptr, bpm->FetchPage(buffer_pool_size + 1));
+  EXPECT_TRUE(bpm->UnpinPage(buffer_pool_size + 1, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_EQ(3, stats.evictions_);
+  EXPECT_EQ(3, stats.dirty_write_backs_);
+  EXPECT_EQ(1, stats.read_latency_.count_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, LRUHitTest) {
+  const std::string db_name = "bpm_lru_hit_test.db";
+  const size_t buffer_pool_size = 3;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1, ReplacerType::kLRU);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: hits taken without the latch still reach the replacer, page 2 is now the least recently used and page 1
+  // the next one.
+  for (page_id_t page_id : {1, 0}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(2, bpm->GetStats().hits_);
+  for (int i = 0; i < 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: the most recently used page survived both evictions.
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(3, stats.hits_);
+  EXPECT_EQ(0, stats.misses_);
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ(1, bpm->GetStats().misses_);
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ScanResistantHitTest) {
+  const std::string db_name = "bpm_scan_resistant_hit_test.db";
+  const size_t buffer_pool_size = 8;
+  const page_id_t num_hot_pages = 2;
+  const page_id_t num_scan_pages = 16;
+
+  for (auto replacer_type : {ReplacerType::kLRUK, ReplacerType::k2Q}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1, replacer_type);
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: the hot pages are accessed again through buffer hits only, which the replacer must learn about.
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+    EXPECT_EQ(num_hot_pages, bpm->GetStats().hits_);
+    EXPECT_EQ(0, bpm->GetStats().misses_);
+
+    // Scenario: a scan twice the size of the pool goes through without pushing the hot pages out.
+    for (page_id_t i = 0; i < num_scan_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+    EXPECT_EQ(2 * num_hot_pages, bpm->GetStats().hits_);
+    EXPECT_EQ(0, bpm->GetStats().misses_);
+
+    delete bpm;
+    disk_manager->Close();
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FlushPagesTest) {
+  const std::string db_name = "bpm_flush_test.db";
+  const size_t buffer_pool_size = 64;
+  const page_id_t num_pages = 40;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (page_id_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: only the dirty pages of the list are written, pages that are not resident are skipped.
+  std::vector<page_id_t> page_ids;
+  for (page_id_t i = 10; i < 20; i++) {
+    page_ids.push_back(i);
+  }
+  page_ids.push_back(1000);
+  EXPECT_EQ(10, bpm->FlushPages(page_ids));
+  EXPECT_EQ(10, bpm->GetStats().dirty_write_backs_);
+  EXPECT_EQ(10, bpm->FlushPages(page_ids));
+  EXPECT_EQ(10, bpm->GetStats().dirty_write_backs_);
+
+  // Scenario: the rest is written by FlushAllPages, nothing is left for the shutdown.
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_pages, bpm->GetStats().dirty_write_backs_);
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (page_id_t i = 0; i < num_pages; i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(LatencyHistogramTest, PercentileTest) {
+  EXPECT_EQ(0, LatencyHistogram::BucketOf(0));
+  EXPECT_EQ(1, LatencyHistogram::BucketOf(1));
+  EXPECT_EQ(2, LatencyHistogram::BucketOf(2));
+  EXPECT_EQ(2, LatencyHistogram::BucketOf(3));
+  EXPECT_EQ(11, LatencyHistogram::BucketOf(1024));
+  EXPECT_EQ(LatencyHistogram::NUM_BUCKETS - 1, LatencyHistogram::BucketOf(UINT64_MAX));
+
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Percentile(0.99));
+  for (uint64_t latency : {1, 1, 1, 1, 1, 1, 1, 1, 1, 1000}) {
+    histogram.buckets_[LatencyHistogram::BucketOf(latency)]++;
+    histogram.count_++;
+    histogram.total_micros_ += latency;
+  }
+  EXPECT_EQ(2, histogram.Percentile(0.5));
+  EXPECT_EQ(2, histogram.Percentile(0.9));
+  EXPECT_EQ(1024, histogram.Percentile(0.99));
+  EXPECT_DOUBLE_EQ(100.9, histogram.Mean());
+}
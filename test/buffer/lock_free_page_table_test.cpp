@@ -0,0 +1,69 @@
+#include "buffer/lock_free_page_table.h"
+
+#include <iterator>
+#include <random>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+TEST(LockFreePageTableTest, SampleTest) {
+  LockFreePageTable page_table(8);
+  EXPECT_EQ(16, page_table.Capacity());
+
+  for (int i = 0; i < 8; i++) {
+    page_table.Insert(0, i * 8, i);
+  }
+  EXPECT_EQ(8, page_table.Size());
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(i, page_table.Find(0, i * 8));
+  }
+  EXPECT_EQ(INVALID_FRAME_ID, page_table.Find(0, 1));
+
+  EXPECT_TRUE(page_table.Erase(0, 0));
+  EXPECT_FALSE(page_table.Erase(0, 0));
+  EXPECT_EQ(INVALID_FRAME_ID, page_table.Find(0, 0));
+  EXPECT_EQ(7, page_table.Size());
+}
+
+TEST(LockFreePageTableTest, DatabasesTest) {
+  // Scenario: databases sharing the pool use the same page ids, each one finds its own frames.
+  LockFreePageTable page_table(8);
+  for (db_id_t db_id = 0; db_id < 4; db_id++) {
+    page_table.Insert(db_id, 1, db_id);
+  }
+  page_table.Insert(MAX_OPEN_DATABASES - 1, 1, 4);
+  for (db_id_t db_id = 0; db_id < 4; db_id++) {
+    EXPECT_EQ(db_id, page_table.Find(db_id, 1));
+  }
+  EXPECT_EQ(4, page_table.Find(MAX_OPEN_DATABASES - 1, 1));
+  EXPECT_EQ(INVALID_FRAME_ID, page_table.Find(4, 1));
+
+  EXPECT_TRUE(page_table.Erase(2, 1));
+  EXPECT_EQ(INVALID_FRAME_ID, page_table.Find(2, 1));
+  EXPECT_EQ(3, page_table.Find(3, 1));
+}
+
+TEST(LockFreePageTableTest, ChurnTest) {
+  // Scenario: a full table keeps replacing its entries, erased slots must never make lookups miss or loop.
+  const int num_frames = 64;
+  LockFreePageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::minstd_rand rng(0);
+  for (int i = 0; i < num_frames; i++) {
+    page_table.Insert(0, i, i);
+    expected[i] = i;
+  }
+  for (int i = num_frames; i < 100 * num_frames; i++) {
+    auto iter = expected.begin();
+    std::advance(iter, rng() % expected.size());
+    frame_id_t frame_id = iter->second;
+    EXPECT_TRUE(page_table.Erase(0, iter->first));
+    expected.erase(iter);
+    page_table.Insert(0, i, frame_id);
+    expected[i] = frame_id;
+  }
+  EXPECT_EQ(expected.size(), page_table.Size());
+  for (auto &entry : expected) {
+    EXPECT_EQ(entry.second, page_table.Find(0, entry.first));
+  }
+}
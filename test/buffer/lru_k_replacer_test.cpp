@@ -0,0 +1,67 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frames 1-6 are loaded, frame 1 is accessed twice, so it has a finite backward 2-distance.
+  for (int i = 1; i <= 6; i++) {
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.Unpin(i);
+  }
+  lru_k_replacer.RecordAccess(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames accessed only once go first, oldest first access first.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(4, lru_k_replacer.Size());
+
+  // Scenario: pinning keeps the history, 4 comes back with two accesses.
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.RecordAccess(4);
+  lru_k_replacer.Unpin(4);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+
+  // Scenario: among frames with two accesses, the oldest second-to-last access loses.
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const int num_pages = 16;
+  LRUKReplacer lru_k_replacer(num_pages, 2);
+
+  // Scenario: frames 0-3 hold hot pages, the rest of the pool is filled by a scan.
+  for (int i = 0; i < 4; i++) {
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.Unpin(i);
+  }
+  for (int i = 4; i < num_pages; i++) {
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.Unpin(i);
+  }
+  // Scenario: the scan keeps recycling its own frames, the hot ones are never picked.
+  for (int round = 0; round < 3; round++) {
+    for (int i = 4; i < num_pages; i++) {
+      int value;
+      ASSERT_TRUE(lru_k_replacer.Victim(&value));
+      EXPECT_LE(4, value);
+      lru_k_replacer.Remove(value);
+      lru_k_replacer.RecordAccess(value);
+      lru_k_replacer.Unpin(value);
+    }
+  }
+  EXPECT_EQ(num_pages, lru_k_replacer.Size());
+}
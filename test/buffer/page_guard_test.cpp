@@ -0,0 +1,108 @@
+#include "buffer/page_guard.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(PageGuardTest, BasicGuardTest) {
+  const std::string db_name = "page_guard_test.db";
+  const size_t buffer_pool_size = 5;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  {
+    BasicPageGuard guard = bpm->NewPageGuarded(page_id_temp);
+    ASSERT_TRUE(guard);
+    EXPECT_EQ(page_id_temp, guard.PageId());
+    EXPECT_EQ(1, guard.GetPage()->GetPinCount());
+    std::strcpy(guard.GetDataMut(), "Hello");
+
+    // Scenario: moving a guard hands its pin over instead of taking another one.
+    BasicPageGuard moved = std::move(guard);
+    EXPECT_FALSE(guard);
+    EXPECT_EQ(1, moved.GetPage()->GetPinCount());
+
+    // Scenario: fetching the page again through a second guard takes a second pin.
+    BasicPageGuard other = bpm->FetchPageBasic(page_id_temp);
+    EXPECT_EQ(2, other.GetPage()->GetPinCount());
+    other.Drop();
+    EXPECT_FALSE(other);
+    EXPECT_EQ(1, moved.GetPage()->GetPinCount());
+  }
+  // Scenario: the guard unpinned the page when it went out of scope.
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: assigning to a guard releases the page it held.
+  page_id_t second_id;
+  BasicPageGuard guard = bpm->NewPageGuarded(second_id);
+  Page *second = guard.GetPage();
+  guard = bpm->FetchPageBasic(page_id_temp);
+  EXPECT_EQ(0, second->GetPinCount());
+  EXPECT_EQ(0, std::strcmp(guard.GetData(), "Hello"));
+  guard.Drop();
+
+  // Scenario: the write through the guard marked the page dirty, so it survives eviction.
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    page_id_t id;
+    bpm->NewPageGuarded(id);
+  }
+  {
+    BasicPageGuard reread = bpm->FetchPageBasic(page_id_temp);
+    EXPECT_EQ(0, std::strcmp(reread.GetData(), "Hello"));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(PageGuardTest, LatchGuardTest) {
+  const std::string db_name = "page_guard_test.db";
+  const size_t buffer_pool_size = 5;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  bpm->NewPageGuarded(page_id_temp);
+  {
+    // Scenario: readers share the page.
+    ReadPageGuard reader1 = bpm->FetchPageRead(page_id_temp);
+    ReadPageGuard reader2 = bpm->FetchPageRead(page_id_temp);
+    EXPECT_EQ(2, reader1.GetPage()->GetPinCount());
+    ReadPageGuard moved = std::move(reader1);
+    EXPECT_FALSE(reader1);
+    EXPECT_EQ(2, moved.GetPage()->GetPinCount());
+  }
+  {
+    // Scenario: the read latches were released, otherwise this would block.
+    WritePageGuard writer = bpm->FetchPageWrite(page_id_temp);
+    std::strcpy(writer.GetDataMut(), "World");
+    writer.Drop();
+    // Scenario: so was the write latch.
+    ReadPageGuard reader = bpm->FetchPageRead(page_id_temp);
+    EXPECT_EQ(0, std::strcmp(reader.GetData(), "World"));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: a page that cannot be fetched gives an empty guard.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t id;
+    bpm->NewPage(id);
+  }
+  WritePageGuard missing = bpm->FetchPageWrite(page_id_temp);
+  EXPECT_FALSE(missing);
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,39 @@
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: frames 0-5 are loaded, 0 and 1 are accessed again and move to Am.
+  for (int i = 0; i < 6; i++) {
+    two_queue_replacer.RecordAccess(i);
+    two_queue_replacer.Unpin(i);
+  }
+  two_queue_replacer.RecordAccess(1);
+  two_queue_replacer.RecordAccess(0);
+  EXPECT_EQ(6, two_queue_replacer.Size());
+
+  // Scenario: A1 is over its share, victims come out of it in FIFO order.
+  int value;
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: A1 is down to its share, Am gives its least recently used frame.
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: a pinned frame keeps its queue.
+  two_queue_replacer.Pin(0);
+  EXPECT_EQ(2, two_queue_replacer.Size());
+  two_queue_replacer.Unpin(0);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(two_queue_replacer.Victim(&value));
+}
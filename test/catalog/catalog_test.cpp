@@ -128,4 +128,127 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+
+TEST(CatalogTest, DropTableTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(db_01->disk_mgr_->GetMetaData());
+  uint32_t allocated_pages = meta_page->GetAllocatedPages();
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = Schema(columns);
+  Txn txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", &schema, &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  for (int i = 0; i < 5000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    Row key_row;
+    row.GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key_row, row.GetRowId(), &txn));
+  }
+  ASSERT_GT(meta_page->GetAllocatedPages(), allocated_pages + 10);
+  // The table is gone from the catalog right away, its pages are freed in the background.
+  ASSERT_EQ(DB_SUCCESS, catalog_01->DropTable("table-1", false));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->GetTable("table-1", table_info));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-1", index_info));
+  catalog_01->WaitForDrops();
+  ASSERT_EQ(allocated_pages, meta_page->GetAllocatedPages());
+  ASSERT_TRUE(db_01->bpm_->CheckAllUnpinned());
+  delete db_01;
+  /** Stage 2: the dropped table is not loaded again */
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  delete db_02;
+}
+
+TEST(CatalogTest, ReadOnlyTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = Schema(columns);
+  Txn txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", &schema, &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", {"id"}, &txn, index_info, "bptree"));
+  const int num_rows = 1000;
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), &txn));
+  }
+  delete db_01;
+
+  // Scenario: the tables and indexes of a database opened read-only can be scanned and probed.
+  auto db_02 = DBStorageEngine::OpenReadOnly(db_file_name);
+  auto &catalog_02 = db_02->catalog_mgr_;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-1", table_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-1", index_info));
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); ++iter) {
+    count++;
+  }
+  EXPECT_EQ(num_rows, count);
+  for (int i = 0; i < num_rows; i += 7) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, &txn));
+    ASSERT_EQ(1, result.size());
+  }
+
+  // Scenario: every change is refused before it touches a page, the mapping is not writable.
+  std::vector<Field> fields{Field(TypeId::kTypeInt, num_rows),
+                            Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+  Row row(fields);
+  EXPECT_FALSE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  RowId first_rid = table_info->GetTableHeap()->Begin(&txn)->GetRowId();
+  EXPECT_FALSE(table_info->GetTableHeap()->MarkDelete(first_rid, &txn));
+  Row updated(fields);
+  EXPECT_FALSE(table_info->GetTableHeap()->UpdateTuple(updated, first_rid, &txn));
+  table_info->GetTableHeap()->ApplyDelete(first_rid, &txn);
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, num_rows)};
+  Row key(key_fields);
+  EXPECT_EQ(DB_READ_ONLY, index_info->GetIndex()->InsertEntry(key, first_rid, &txn));
+  EXPECT_EQ(DB_READ_ONLY, index_info->GetIndex()->RemoveEntry(key, first_rid, &txn));
+  TableInfo *new_table_info = nullptr;
+  EXPECT_EQ(DB_READ_ONLY, catalog_02->CreateTable("table-2", &schema, &txn, new_table_info));
+  EXPECT_EQ(DB_READ_ONLY, catalog_02->CreateIndex("table-1", "index-2", {"name"}, &txn, index_info, "bptree"));
+  EXPECT_EQ(DB_READ_ONLY, catalog_02->DropIndex("table-1", "index-1"));
+  EXPECT_EQ(DB_READ_ONLY, catalog_02->DropTable("table-1"));
+  count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); ++iter) {
+    count++;
+  }
+  EXPECT_EQ(num_rows, count);
+  db_02.reset();
+
+  // Scenario: a read-only database shares a buffer pool with the other databases, as opened by USE ... READONLY.
+  BufferPool buffer_pool(DEFAULT_BUFFER_POOL_SIZE, DEFAULT_BUFFER_POOL_INSTANCES);
+  auto db_03 = DBStorageEngine::OpenReadOnly(db_file_name, &buffer_pool);
+  ASSERT_TRUE(db_03->bpm_->IsReadOnly());
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetTable("table-1", table_info));
+  count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); ++iter) {
+    count++;
+  }
+  EXPECT_EQ(num_rows, count);
+  EXPECT_FALSE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  EXPECT_GT(buffer_pool.GetStats().misses_, 0);
+  db_03.reset();
+
+  // Scenario: a database that does not exist cannot be opened read-only.
+  EXPECT_THROW(DBStorageEngine::OpenReadOnly("catalog_test_missing.db"), std::runtime_error);
+}
@@ -1,6 +1,7 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include "executor/executors/seq_scan_executor.h"
 #include "executor/plans/delete_plan.h"
 #include "executor/plans/insert_plan.h"
 #include "executor/plans/seq_scan_plan.h"
@@ -156,3 +157,38 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// DELETE FROM table-1, whose rows are dropped one by one instead of being kept until the statement ends
+TEST_F(ExecutorTest, ScanArenaBoundedTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  auto scan_plan = std::make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(), nullptr);
+
+  // A scan whose rows are not kept reuses the memory of the last row.
+  SeqScanExecutor scan(GetExecutorContext(), scan_plan.get(), false);
+  scan.Init();
+  Row row;
+  RowId rid;
+  size_t count = 0;
+  size_t max_bytes = 0;
+  while (scan.Next(&row, &rid)) {
+    ASSERT_NE(GetExecutorContext()->GetArena(), row.GetArena());
+    max_bytes = std::max(max_bytes, row.GetArena()->GetAllocatedBytes());
+    ASSERT_EQ(1, row.GetArena()->GetBlockCount());
+    count++;
+  }
+  ASSERT_EQ(1000, count);
+  EXPECT_LE(max_bytes, 3 * sizeof(Field) + 64 + 3 * alignof(std::max_align_t));
+  ASSERT_EQ(0, GetExecutorContext()->GetArena()->GetAllocatedBytes());
+
+  // The scan under a delete does not keep the rows in the arena of the statement either.
+  auto delete_plan = std::make_shared<DeletePlanNode>(schema, scan_plan, table_info->GetTableName());
+  std::vector<Row> result_set;
+  GetExecutionEngine()->ExecutePlan(delete_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(1000, result_set.size());
+  EXPECT_EQ(0, GetExecutorContext()->GetArena()->GetAllocatedBytes());
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(scan_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_TRUE(result_set.empty());
+}
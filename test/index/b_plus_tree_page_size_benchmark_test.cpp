@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/comparator.h"
+
+static const std::string db_name = "bp_tree_page_size_test.db";
+
+/**
+ * Height and point lookup latency of a B+ tree with 256 byte keys on the real pages of the build. The page size is a
+ * build option, so "make page-size-benchmark" builds and runs this test once with 4 KB and once with 16 KB pages.
+ */
+TEST(BPlusTreePageSizeBenchmarkTest, HeightAndLookupTest) {
+  const int key_size = 256;
+  const int num_keys = 50000;
+  const int num_lookups = 50000;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, key_size);
+  std::vector<GenericKey *> keys;
+  for (int i = 0; i < num_keys; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    keys.push_back(key);
+  }
+  std::vector<int> insert_order(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    insert_order[i] = i;
+  }
+  std::shuffle(insert_order.begin(), insert_order.end(), std::minstd_rand(0));
+
+  BPlusTree tree(0, engine.bpm_, KP);
+  for (auto i : insert_order) {
+    ASSERT_TRUE(tree.Insert(keys[i], RowId(i)));
+  }
+  std::minstd_rand rng(1);
+  std::vector<RowId> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_lookups; i++) {
+    int k = static_cast<int>(rng() % num_keys);
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(keys[k], result));
+    ASSERT_EQ(RowId(k), result[0]);
+  }
+  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  int height = tree.GetHeight();
+  int internal_max_size = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (key_size + sizeof(RowId)) - 1;
+  std::cout << "page size: " << PAGE_SIZE << ", internal fan-out: " << internal_max_size << ", height: " << height
+            << ", point lookup: " << elapsed.count() / num_lookups << " us" << std::endl;
+  // With every node at least half full the tree is no deeper than log_{fan-out / 2} of the number of keys.
+  int max_height = 1;
+  for (long reach = internal_max_size / 2; reach < num_keys; reach *= internal_max_size / 2) {
+    max_height++;
+  }
+  EXPECT_LE(height, max_height);
+  ASSERT_TRUE(tree.Check());
+  for (auto key : keys) {
+    free(key);
+  }
+  delete table_schema;
+}
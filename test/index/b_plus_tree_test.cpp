@@ -70,3 +70,35 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
 }
+
+TEST(BPlusTreeTests, DestroyTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 21);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData());
+  uint32_t allocated_pages = meta_page->GetAllocatedPages();
+  const int n = 5000;
+  {
+    // Small nodes, so that the tree has a few levels.
+    BPlusTree tree(0, engine.bpm_, KP, 8, 8);
+    GenericKey *key = KP.InitKey();
+    for (int i = 0; i < n; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+      KP.SerializeFromKey(key, Row(fields), table_schema);
+      ASSERT_TRUE(tree.Insert(key, RowId(i)));
+    }
+    free(key);
+    ASSERT_GE(tree.GetHeight(), 4);
+    ASSERT_GT(meta_page->GetAllocatedPages(), allocated_pages + n / 8);
+    tree.Destroy();
+    ASSERT_TRUE(tree.IsEmpty());
+    ASSERT_EQ(allocated_pages, meta_page->GetAllocatedPages());
+    ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  }
+  // The root of the destroyed tree is not found again.
+  BPlusTree tree(0, engine.bpm_, KP);
+  ASSERT_TRUE(tree.IsEmpty());
+}
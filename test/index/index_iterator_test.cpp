@@ -53,4 +53,6 @@ TEST(BPlusTreeTests, IndexIteratorTest) {
     EXPECT_EQ(RowId((2 * i - 1) * 100), (*iter).second);
   }
   ASSERT_EQ(25, i);
+  // The iterators hold the leaf they point at pinned, and nothing else once they are gone
+  ASSERT_TRUE(tree.Check());
 }
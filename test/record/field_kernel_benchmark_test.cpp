@@ -0,0 +1,102 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/field_kernels.h"
+#include "record/schema.h"
+
+/**
+ * Build fields of a type with random values, CHAR values share a common prefix as keys often do.
+ */
+static void MakeFields(TypeId type, size_t count, std::vector<std::string> &texts, std::vector<Field> &fields) {
+  std::mt19937 rng(2024);
+  fields.reserve(count);
+  texts.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    switch (type) {
+      case TypeId::kTypeInt:
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(rng() % 1000));
+        break;
+      case TypeId::kTypeFloat:
+        fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(rng() % 1000) / 8);
+        break;
+      default:
+        texts.emplace_back("customer-" + std::to_string(rng() % 1000));
+        fields.emplace_back(TypeId::kTypeChar, texts.back().data(), texts.back().size(), false);
+    }
+  }
+}
+
+/**
+ * Compare and hash through the per-column kernels, against the virtual CompareLessThan / CompareEquals path.
+ */
+TEST(FieldKernelBenchmarkTest, CompareAndHashTest) {
+  const size_t num_fields = 4096;
+  const int rounds = 50;
+  Schema schema({new Column("i", TypeId::kTypeInt, 0, false, false),
+                 new Column("f", TypeId::kTypeFloat, 1, false, false),
+                 new Column("c", TypeId::kTypeChar, 16, 2, false, false)},
+                true);
+  std::vector<std::string> names = {"int", "float", "char"};
+  for (uint32_t c = 0; c < schema.GetColumnCount(); c++) {
+    std::vector<std::string> texts;
+    std::vector<Field> fields;
+    MakeFields(schema.GetColumn(c)->GetType(), num_fields, texts, fields);
+
+    // virtual path: a CmpBool per call, as in CompareKeys before the kernels
+    size_t virtual_less = 0;
+    size_t virtual_equal = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (size_t i = 1; i < num_fields; i++) {
+        virtual_less += fields[i - 1].CompareLessThan(fields[i]) == CmpBool::kTrue;
+        virtual_equal += fields[i - 1].CompareEquals(fields[i]) == CmpBool::kTrue;
+      }
+    }
+    std::chrono::duration<double, std::nano> virtual_elapsed = std::chrono::steady_clock::now() - start;
+
+    // kernel path: one three-way comparison
+    FieldCompareFn compare = schema.GetCompareFn(c);
+    size_t kernel_less = 0;
+    size_t kernel_equal = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (size_t i = 1; i < num_fields; i++) {
+        int cmp = compare(fields[i - 1], fields[i]);
+        kernel_less += cmp < 0;
+        kernel_equal += cmp == 0;
+      }
+    }
+    std::chrono::duration<double, std::nano> kernel_elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(virtual_less, kernel_less);
+    EXPECT_EQ(virtual_equal, kernel_equal);
+
+    // hash: fields that compare equal hash alike
+    FieldHashFn hash = schema.GetHashFn(c);
+    size_t hash_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < num_fields; i++) {
+        hash_sum += hash(fields[i]);
+      }
+    }
+    std::chrono::duration<double, std::nano> hash_elapsed = std::chrono::steady_clock::now() - start;
+    for (size_t i = 1; i < num_fields; i++) {
+      if (compare(fields[i - 1], fields[i]) == 0) {
+        EXPECT_EQ(hash(fields[i - 1]), hash(fields[i]));
+      }
+    }
+
+    double count = static_cast<double>(rounds) * (num_fields - 1);
+    std::cout << names[c] << ": compare " << virtual_elapsed.count() / count << " -> "
+              << kernel_elapsed.count() / count << " ns, hash " << hash_elapsed.count() / (rounds * num_fields)
+              << " ns (" << hash_sum % 10 << ")" << std::endl;
+  }
+  Field zero(TypeId::kTypeFloat, 0.0f);
+  Field negative_zero(TypeId::kTypeFloat, -0.0f);
+  EXPECT_EQ(0, FieldKernel<kTypeFloat>::Compare(zero, negative_zero));
+  EXPECT_EQ(FieldKernel<kTypeFloat>::Hash(zero), FieldKernel<kTypeFloat>::Hash(negative_zero));
+}
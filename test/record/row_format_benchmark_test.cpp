@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "page/table_page.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Fill a table page with copies of a row in the given format.
+ * @return the number of rows that fit
+ */
+static uint32_t FillPage(TablePage &page, RowFormat format, std::vector<Field> &fields, Schema *schema) {
+  page.Init(0, INVALID_PAGE_ID, nullptr, nullptr, format);
+  uint32_t count = 0;
+  Row row(fields);
+  while (page.InsertTuple(row, schema, nullptr, nullptr, nullptr)) {
+    count++;
+  }
+  return count;
+}
+
+/**
+ * Rows per page and decode time of the tagged and the compact row format, for a few schemas.
+ */
+TEST(RowFormatBenchmarkTest, TupleDensityTest) {
+  const int num_reads = 200000;
+  std::string text(24, 'x');
+  std::vector<std::vector<Column *>> schemas = {
+      {new Column("a", TypeId::kTypeInt, 0, false, false), new Column("b", TypeId::kTypeInt, 1, false, false),
+       new Column("c", TypeId::kTypeInt, 2, false, false)},
+      {new Column("id", TypeId::kTypeInt, 0, false, false), new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+       new Column("account", TypeId::kTypeFloat, 2, true, false)},
+      {new Column("id", TypeId::kTypeInt, 0, false, false), new Column("a", TypeId::kTypeFloat, 1, true, false),
+       new Column("b", TypeId::kTypeFloat, 2, true, false), new Column("c", TypeId::kTypeFloat, 3, true, false),
+       new Column("d", TypeId::kTypeFloat, 4, true, false), new Column("e", TypeId::kTypeInt, 5, true, false),
+       new Column("f", TypeId::kTypeInt, 6, true, false), new Column("g", TypeId::kTypeInt, 7, true, false)}};
+  std::vector<std::string> names = {"3 x int", "int, char(24), float", "8 x int/float"};
+  for (size_t s = 0; s < schemas.size(); s++) {
+    Schema schema(schemas[s], true);
+    std::vector<Field> fields;
+    for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+      switch (schema.GetColumn(i)->GetType()) {
+        case TypeId::kTypeInt:
+          fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i));
+          break;
+        case TypeId::kTypeFloat:
+          fields.emplace_back(TypeId::kTypeFloat, 1.5f);
+          break;
+        default:
+          fields.emplace_back(TypeId::kTypeChar, text.data(), text.size(), false);
+      }
+    }
+    uint32_t counts[2];
+    double read_us[2];
+    RowFormat formats[] = {RowFormat::kTagged, RowFormat::kCompact};
+    for (int f = 0; f < 2; f++) {
+      TablePage page;
+      counts[f] = FillPage(page, formats[f], fields, &schema);
+      ASSERT_GT(counts[f], 0);
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_reads; i++) {
+        Row row(RowId(0, i % counts[f]));
+        ASSERT_TRUE(page.GetTuple(&row, &schema, nullptr, nullptr));
+      }
+      std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+      read_us[f] = elapsed.count() / num_reads;
+    }
+    std::cout << names[s] << ": " << counts[0] << " -> " << counts[1] << " rows per page (+"
+              << (counts[1] - counts[0]) * 100 / counts[0] << "%), decode " << read_us[0] << " -> " << read_us[1]
+              << " us per row" << std::endl;
+    EXPECT_GT(counts[1], counts[0]);
+  }
+}
@@ -160,3 +160,210 @@ TEST(TupleTest, SerializeDeserializeTest) {
     ASSERT(true, sp->CompareEqualTo(&schema));
 }
 
+
+TEST(TupleTest, CompactRowTest) {
+  std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 64, 0, true, false),
+                                   new Column("id", TypeId::kTypeInt, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  Schema schema(columns, true);
+  // 1 byte of null bitmap, 2 fixed-width values, then 2 end offsets
+  EXPECT_EQ(1, schema.GetNullBitmapSize());
+  EXPECT_EQ(1, schema.GetFieldOffset(1));
+  EXPECT_EQ(5, schema.GetFieldOffset(2));
+  EXPECT_EQ(9, schema.GetFieldOffset(0));
+  EXPECT_EQ(11, schema.GetFieldOffset(3));
+  EXPECT_EQ(13, schema.GetFixedLength());
+
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+       Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeFloat, 19.99f),
+       Field(TypeId::kTypeChar, const_cast<char *>("hello"), strlen("hello"), false)},
+      {Field(TypeId::kTypeChar), Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeFloat),
+       Field(TypeId::kTypeChar, const_cast<char *>(""), 0, false)},
+      {Field(TypeId::kTypeChar, const_cast<char *>("x"), 1, false), Field(TypeId::kTypeInt, 0),
+       Field(TypeId::kTypeFloat), Field(TypeId::kTypeChar)}};
+  for (auto &fields : rows) {
+    Row row(fields);
+    char buffer[PAGE_SIZE];
+    uint32_t size = row.SerializeTo(buffer, &schema);
+    ASSERT_EQ(row.GetSerializedSize(&schema), size);
+    EXPECT_LT(size, row.GetSerializedSize(&schema, RowFormat::kTagged));
+    Row row2(RowId(1, 2));
+    ASSERT_EQ(size, row2.DeserializeFrom(buffer, &schema));
+    EXPECT_EQ(RowId(1, 2), row2.GetRowId());
+    ASSERT_EQ(fields.size(), row2.GetFieldCount());
+    for (size_t i = 0; i < fields.size(); i++) {
+      ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+      if (!fields[i].IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+      }
+    }
+  }
+
+  // Scenario: a row of 3 integers takes the null bitmap and the values only.
+  std::vector<Column *> int_columns = {new Column("a", TypeId::kTypeInt, 0, false, false),
+                                       new Column("b", TypeId::kTypeInt, 1, false, false),
+                                       new Column("c", TypeId::kTypeInt, 2, false, false)};
+  Schema int_schema(int_columns, true);
+  std::vector<Field> int_row_fields = {Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeInt, -65537),
+                                       Field(TypeId::kTypeInt, 33389)};
+  Row int_row(int_row_fields);
+  EXPECT_EQ(13, int_row.GetSerializedSize(&int_schema));
+  EXPECT_EQ(37, int_row.GetSerializedSize(&int_schema, RowFormat::kTagged));
+}
+
+TEST(TupleTest, TaggedPageTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns, true);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)};
+  std::vector<Field> new_fields = {Field(TypeId::kTypeInt, 189),
+                                   Field(TypeId::kTypeChar, const_cast<char *>("sql"), strlen("sql"), false)};
+  // Scenario: a page keeps the row format it was written in, for reads, inserts and updates.
+  for (auto format : {RowFormat::kTagged, RowFormat::kCompact}) {
+    TablePage table_page;
+    table_page.Init(3, INVALID_PAGE_ID, nullptr, nullptr, format);
+    ASSERT_EQ(format, table_page.GetRowFormat());
+    std::vector<RowId> rids;
+    for (int i = 0; i < 3; i++) {
+      Row row(fields);
+      ASSERT_TRUE(table_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    ASSERT_EQ(format, table_page.GetRowFormat());
+    Row new_row(new_fields);
+    Row old_row(rids[1]);
+    ASSERT_EQ(TABLE_PAGE_UPDATE::TABLE_PAGE_UPDATE_SUCCESS,
+              table_page.UpdateTuple(new_row, &old_row, &schema, nullptr, nullptr, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, old_row.GetField(1)->CompareEquals(fields[1]));
+    for (size_t i = 0; i < rids.size(); i++) {
+      Row row(rids[i]);
+      ASSERT_TRUE(table_page.GetTuple(&row, &schema, nullptr, nullptr));
+      auto &expected = i == 1 ? new_fields : fields;
+      for (size_t j = 0; j < expected.size(); j++) {
+        ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(expected[j]));
+      }
+    }
+  }
+}
+
+TEST(TupleTest, RowViewTest) {
+  std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 64, 0, true, false),
+                                   new Column("id", TypeId::kTypeInt, 1, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  Schema schema(columns, true);
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+       Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeFloat, 19.99f),
+       Field(TypeId::kTypeChar, const_cast<char *>("hello"), strlen("hello"), false)},
+      {Field(TypeId::kTypeChar), Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeFloat),
+       Field(TypeId::kTypeChar, const_cast<char *>(""), 0, false)},
+      {Field(TypeId::kTypeChar, const_cast<char *>("x"), 1, false), Field(TypeId::kTypeInt, 0),
+       Field(TypeId::kTypeFloat), Field(TypeId::kTypeChar)}};
+  // output schema of a projection on (id, note)
+  std::unique_ptr<Schema> output_schema(Schema::ShallowCopySchema(&schema, {1, 3}));
+  // Scenario: a view reads the same fields as a deserialized row, in either page format.
+  for (auto format : {RowFormat::kTagged, RowFormat::kCompact}) {
+    TablePage table_page;
+    table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr, format);
+    for (auto &fields : rows) {
+      Row row(fields);
+      ASSERT_TRUE(table_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+      RowView view;
+      ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), &schema, &view));
+      ASSERT_EQ(row.GetRowId(), view.GetRowId());
+      ASSERT_EQ(fields.size(), view.GetFieldCount());
+      for (uint32_t i = 0; i < fields.size(); i++) {
+        ASSERT_EQ(fields[i].IsNull(), view.IsNull(i));
+        Field field = view.GetField(i);
+        ASSERT_EQ(fields[i].IsNull(), field.IsNull());
+        if (!fields[i].IsNull()) {
+          ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+        }
+      }
+      Row copy;
+      view.Materialize(&copy);
+      ASSERT_EQ(row.GetRowId(), copy.GetRowId());
+      ASSERT_EQ(fields.size(), copy.GetFieldCount());
+      Row projection;
+      view.Materialize(&projection, output_schema.get());
+      ASSERT_EQ(2, projection.GetFieldCount());
+      ASSERT_EQ(CmpBool::kTrue, projection.GetField(0)->CompareEquals(fields[1]));
+      ASSERT_EQ(fields[3].IsNull(), projection.GetField(1)->IsNull());
+    }
+    // the copies outlive the page
+    Row copy;
+    {
+      TablePage other_page;
+      other_page.Init(1, INVALID_PAGE_ID, nullptr, nullptr, format);
+      Row row(rows[0]);
+      ASSERT_TRUE(other_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+      RowView view;
+      ASSERT_TRUE(other_page.GetTupleView(row.GetRowId(), &schema, &view));
+      view.Materialize(&copy);
+    }
+    ASSERT_EQ(CmpBool::kTrue, copy.GetField(0)->CompareEquals(rows[0][0]));
+    ASSERT_EQ(CmpBool::kTrue, copy.GetField(3)->CompareEquals(rows[0][3]));
+  }
+}
+
+TEST(TupleTest, ArenaRowTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns, true);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat)};
+  TablePage table_page;
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  Row row(fields);
+  ASSERT_TRUE(table_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), &schema, &view));
+
+  // Scenario: rows materialized in an arena are handed over by moves, copies own their data and outlive the arena.
+  std::vector<Row> result_set;
+  Row copy;
+  {
+    MemoryArena arena(1024);
+    Row arena_row;
+    for (int i = 0; i < 100; i++) {
+      view.Materialize(&arena_row, &arena);
+      ASSERT_EQ(&arena, arena_row.GetArena());
+      result_set.push_back(std::move(arena_row));
+      ASSERT_EQ(0, arena_row.GetFieldCount());
+    }
+    EXPECT_GE(arena.GetAllocatedBytes(), 100 * (3 * sizeof(Field) + strlen("minisql")));
+    EXPECT_GT(arena.GetBlockCount(), 1);
+    for (auto &r : result_set) {
+      ASSERT_EQ(row.GetRowId(), r.GetRowId());
+      ASSERT_EQ(CmpBool::kTrue, r.GetField(1)->CompareEquals(fields[1]));
+      ASSERT_TRUE(r.GetField(2)->IsNull());
+    }
+    copy = result_set.back();
+    ASSERT_EQ(nullptr, copy.GetArena());
+    result_set.clear();
+
+    // a request larger than a quarter of a block gets a block of its own, alignment is kept
+    auto big = static_cast<char *>(arena.Allocate(4000));
+    memset(big, 1, 4000);
+    auto *aligned = arena.New<double>(1.5);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % alignof(double));
+    arena.Reset();
+    EXPECT_EQ(0, arena.GetAllocatedBytes());
+    EXPECT_EQ(1, arena.GetBlockCount());
+  }
+  ASSERT_EQ(CmpBool::kTrue, copy.GetField(0)->CompareEquals(fields[0]));
+  ASSERT_EQ(CmpBool::kTrue, copy.GetField(1)->CompareEquals(fields[1]));
+
+  // Scenario: a moved field hands its CHAR data over.
+  Field owner(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), true);
+  const char *data = owner.GetData();
+  Field moved(std::move(owner));
+  ASSERT_EQ(data, moved.GetData());
+  ASSERT_EQ(CmpBool::kTrue, moved.CompareEquals(fields[1]));
+}
@@ -0,0 +1,170 @@
+#include "storage/async_io_engine.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+static const AsyncIoEngine::Type engine_types[] = {AsyncIoEngine::Type::IO_URING, AsyncIoEngine::Type::THREAD_POOL};
+
+TEST(AsyncIoEngineTest, BatchReadWriteTest) {
+  for (auto engine_type : engine_types) {
+    std::string db_name = "async_io_test.db";
+    remove(db_name.c_str());
+    // A queue depth smaller than the batches makes the engine wait for room in the middle of a batch.
+    auto engine = AsyncIoEngine::Create(engine_type, 8);
+    std::cout << "engine: " << engine->GetName() << std::endl;
+    const int num_pages = 200;
+    auto *disk_mgr = new DiskManager(db_name);
+    std::vector<char> pages(num_pages * PAGE_SIZE);
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr->AllocatePage());
+      memset(&pages[i * PAGE_SIZE], 'a' + i % 26, PAGE_SIZE);
+      memcpy(&pages[i * PAGE_SIZE], &i, sizeof(i));
+    }
+
+    // Scenario: a batch of writes lands on disk, reads of single pages see it.
+    IoBatch writes;
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->AddWrite(writes, i, &pages[i * PAGE_SIZE]);
+    }
+    ASSERT_EQ(num_pages, writes.Size());
+    engine->Submit(writes);
+    writes.Wait();
+    EXPECT_EQ(0, writes.GetErrorCount());
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->ReadPage(i, buf);
+      ASSERT_EQ(0, memcmp(buf, &pages[i * PAGE_SIZE], PAGE_SIZE));
+    }
+
+    // Scenario: a batch of reads in reverse order, pages past the end of the file read as zeros without any I/O.
+    std::vector<char> read_pages((num_pages + 2) * PAGE_SIZE, 1);
+    IoBatch reads;
+    for (int i = num_pages + 1; i >= 0; i--) {
+      disk_mgr->AddRead(reads, i, &read_pages[i * PAGE_SIZE]);
+    }
+    EXPECT_EQ(num_pages, reads.Size());
+    engine->Submit(reads);
+    reads.Wait();
+    EXPECT_EQ(0, reads.GetErrorCount());
+    ASSERT_EQ(0, memcmp(read_pages.data(), pages.data(), pages.size()));
+    for (size_t i = num_pages * PAGE_SIZE; i < read_pages.size(); i++) {
+      ASSERT_EQ(0, read_pages[i]);
+    }
+
+    // Scenario: waiting for an empty batch, or one that was never submitted, returns at once.
+    IoBatch empty;
+    engine->Submit(empty);
+    empty.Wait();
+
+    disk_mgr->Close();
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
+
+TEST(AsyncIoEngineTest, CoalescedWriteTest) {
+  for (auto engine_type : engine_types) {
+    std::string db_name = "async_io_test.db";
+    remove(db_name.c_str());
+    auto engine = AsyncIoEngine::Create(engine_type, 8);
+    const page_id_t num_pages = DiskManager::BITMAP_SIZE + 300;
+    auto *disk_mgr = new DiskManager(db_name);
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr->AllocatePage());
+    }
+    // runs: 3-5, 10, the last page of the first extent, the first pages of the second extent, which are not next to it
+    // in the file, and a run longer than the largest write
+    std::vector<page_id_t> page_ids = {5, 3, 10, 4, DiskManager::BITMAP_SIZE - 1};
+    const page_id_t second_extent = DiskManager::BITMAP_SIZE;
+    for (page_id_t i = 0; i < static_cast<page_id_t>(DiskManager::MAX_COALESCED_PAGES) + 10; i++) {
+      page_ids.push_back(second_extent + i);
+    }
+    std::vector<char> data(page_ids.size() * PAGE_SIZE);
+    std::vector<std::pair<page_id_t, const char *>> pages;
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      memset(&data[i * PAGE_SIZE], 'a' + i % 26, PAGE_SIZE);
+      memcpy(&data[i * PAGE_SIZE], &page_ids[i], sizeof(page_id_t));
+      pages.emplace_back(page_ids[i], &data[i * PAGE_SIZE]);
+    }
+
+    // Scenario: adjacent pages are merged into vectored writes, which land every page at its place.
+    IoBatch writes;
+    ASSERT_EQ(5, disk_mgr->AddWrites(writes, pages));
+    ASSERT_EQ(5, writes.Size());
+    engine->Submit(writes);
+    writes.Wait();
+    EXPECT_EQ(0, writes.GetErrorCount());
+    char buf[PAGE_SIZE];
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      disk_mgr->ReadPage(page_ids[i], buf);
+      ASSERT_EQ(0, memcmp(buf, &data[i * PAGE_SIZE], PAGE_SIZE)) << "page " << page_ids[i];
+    }
+    // the pages in between were not written
+    disk_mgr->ReadPage(6, buf);
+    for (char c : buf) {
+      ASSERT_EQ(0, c);
+    }
+
+    disk_mgr->Close();
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
+
+/**
+ * Random page reads, one batch of queue depth pages at a time. Prints the throughput of each engine so that they can
+ * be compared with the synchronous reads of DiskManagerTest.ConcurrentRandomReadTest.
+ */
+TEST(AsyncIoEngineTest, RandomReadTest) {
+  for (auto engine_type : engine_types) {
+    std::string db_name = "async_io_test.db";
+    remove(db_name.c_str());
+    const int num_pages = 1024;
+    const int num_batches = 500;
+    auto engine = AsyncIoEngine::Create(engine_type, DEFAULT_IO_QUEUE_DEPTH);
+    auto *disk_mgr = new DiskManager(db_name);
+    char data[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr->AllocatePage());
+      memset(data, 0, PAGE_SIZE);
+      memcpy(data, &i, sizeof(i));
+      disk_mgr->WritePage(i, data);
+    }
+    disk_mgr->Sync();
+
+    std::vector<char> buf(DEFAULT_IO_QUEUE_DEPTH * PAGE_SIZE);
+    std::vector<int> page_ids(DEFAULT_IO_QUEUE_DEPTH);
+    uint32_t seed = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < num_batches; b++) {
+      IoBatch batch;
+      for (int i = 0; i < DEFAULT_IO_QUEUE_DEPTH; i++) {
+        seed = seed * 1103515245 + 12345;
+        page_ids[i] = static_cast<int>((seed >> 8) % num_pages);
+        disk_mgr->AddRead(batch, page_ids[i], &buf[i * PAGE_SIZE]);
+      }
+      engine->Submit(batch);
+      batch.Wait();
+      for (int i = 0; i < DEFAULT_IO_QUEUE_DEPTH; i++) {
+        int head;
+        memcpy(&head, &buf[i * PAGE_SIZE], sizeof(head));
+        ASSERT_EQ(page_ids[i], head);
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "engine: " << engine->GetName() << ", random reads: "
+              << static_cast<double>(num_batches) * DEFAULT_IO_QUEUE_DEPTH / elapsed.count() / 1e3 << " K/s"
+              << std::endl;
+
+    disk_mgr->Close();
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
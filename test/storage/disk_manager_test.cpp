@@ -1,6 +1,16 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -56,4 +66,364 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE - 5, meta_page->GetAllocatedPages());
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
-}
\ No newline at end of file
+}
+
+/**
+ * Allocation state is kept in memory and written back by Sync(). Also prints the allocation rate, which used to cost
+ * a bitmap read and write per page.
+ */
+TEST(DiskManagerTest, AllocationPersistenceTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE * 2 + 100;
+  auto *disk_mgr = new DiskManager(db_name);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "page allocations: " << num_pages / elapsed.count() / 1e3 << " K/s" << std::endl;
+  std::vector<page_id_t> freed = {7, 64, 65, DiskManager::BITMAP_SIZE + 3, num_pages - 1};
+  for (auto page_id : freed) {
+    disk_mgr->DeAllocatePage(page_id);
+  }
+
+  // Scenario: the bitmaps are only written by Close(), reopening the file sees the same allocation state.
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages - freed.size(), meta_page->GetAllocatedPages());
+  EXPECT_EQ(3, meta_page->GetExtentNums());
+  for (auto page_id : freed) {
+    EXPECT_TRUE(disk_mgr->IsPageFree(page_id));
+  }
+  EXPECT_FALSE(disk_mgr->IsPageFree(0));
+  EXPECT_FALSE(disk_mgr->IsPageFree(num_pages - 2));
+  EXPECT_TRUE(disk_mgr->IsPageFree(num_pages));
+
+  // Scenario: freed pages are handed out again lowest first, then the file grows.
+  for (auto page_id : freed) {
+    EXPECT_EQ(page_id, disk_mgr->AllocatePage());
+  }
+  EXPECT_EQ(num_pages, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * Truncate() cuts the free pages at the end of the file off, including the extents left without an allocated page.
+ */
+TEST(DiskManagerTest, TruncateTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto file_pages = [&]() {
+    struct stat st;
+    stat(db_name.c_str(), &st);
+    return static_cast<size_t>(st.st_size) / PAGE_SIZE;
+  };
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE + 100;
+  const uint32_t kept_pages = 50;
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  memset(data, 'x', PAGE_SIZE);
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->WritePage(num_pages - 1, data);
+  // meta page, two bitmap pages and the data pages
+  ASSERT_EQ(num_pages + 3, file_pages());
+  // a run reserved by an owner is released rather than keeping the end of the file
+  int owner;
+  page_id_t run_page = disk_mgr->AllocatePage(&owner);
+  ASSERT_GE(run_page, num_pages);
+  disk_mgr->DeAllocatePage(run_page);
+  for (uint32_t i = kept_pages; i < num_pages; i++) {
+    disk_mgr->DeAllocatePage(i);
+  }
+
+  ASSERT_EQ(num_pages + 3 - (kept_pages + 2), disk_mgr->Truncate());
+  ASSERT_EQ(kept_pages + 2, file_pages());
+  ASSERT_EQ(0, disk_mgr->Truncate());
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the file reopens with one extent, and grows again from the first free page.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(kept_pages, meta_page->GetAllocatedPages());
+  EXPECT_EQ(1, meta_page->GetExtentNums());
+  EXPECT_FALSE(disk_mgr->IsPageFree(kept_pages - 1));
+  EXPECT_EQ(kept_pages, disk_mgr->AllocatePage());
+
+  // Scenario: a file with no page allocated shrinks to its meta page.
+  for (uint32_t i = 0; i <= kept_pages; i++) {
+    disk_mgr->DeAllocatePage(i);
+  }
+  disk_mgr->Truncate();
+  EXPECT_EQ(1, file_pages());
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ExtentAllocationTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  int table;
+  int index;
+  // Scenario: two owners growing at the same time each get a contiguous run, plain allocations go around them.
+  std::vector<page_id_t> table_pages;
+  std::vector<page_id_t> index_pages;
+  std::vector<page_id_t> other_pages;
+  for (size_t i = 0; i < DiskManager::RUN_SIZE + 10; i++) {
+    table_pages.push_back(disk_mgr->AllocatePage(&table));
+    index_pages.push_back(disk_mgr->AllocatePage(&index));
+    other_pages.push_back(disk_mgr->AllocatePage());
+  }
+  for (size_t i = 1; i < DiskManager::RUN_SIZE; i++) {
+    ASSERT_EQ(table_pages[0] + i, table_pages[i]);
+    ASSERT_EQ(index_pages[0] + i, index_pages[i]);
+  }
+  EXPECT_EQ(0, table_pages[0] % DiskManager::RUN_SIZE);
+  EXPECT_EQ(0, index_pages[0] % DiskManager::RUN_SIZE);
+  std::unordered_set<page_id_t> all_pages;
+  for (auto *pages : {&table_pages, &index_pages, &other_pages}) {
+    for (auto page_id : *pages) {
+      ASSERT_TRUE(all_pages.insert(page_id).second);
+    }
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(all_pages.size(), meta_page->GetAllocatedPages());
+
+  // Scenario: the unused pages of the index run are written as free, and the table run is given back explicitly.
+  page_id_t next_table_page = table_pages.back() + 1;
+  page_id_t next_index_page = index_pages.back() + 1;
+  EXPECT_FALSE(disk_mgr->IsPageFree(next_table_page));
+  disk_mgr->ReleaseExtent(&table);
+  EXPECT_TRUE(disk_mgr->IsPageFree(next_table_page));
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_TRUE(disk_mgr->IsPageFree(next_index_page));
+  for (auto page_id : all_pages) {
+    ASSERT_FALSE(disk_mgr->IsPageFree(page_id));
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, RunAllocationAfterSyncTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  int table;
+  // Scenario: pages taken from a run after Sync() wrote the rest of the run as free survive a reopen.
+  std::vector<page_id_t> pages;
+  pages.push_back(disk_mgr->AllocatePage(&table));
+  disk_mgr->Sync();
+  pages.push_back(disk_mgr->AllocatePage(&table));
+  pages.push_back(disk_mgr->AllocatePage(&table));
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  for (auto page_id : pages) {
+    ASSERT_FALSE(disk_mgr->IsPageFree(page_id));
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(pages.size(), meta_page->GetAllocatedPages());
+  page_id_t next_page = disk_mgr->AllocatePage();
+  for (auto page_id : pages) {
+    ASSERT_NE(page_id, next_page);
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * A file whose first META_EXTENTS extents are full, i.e. the largest file the meta page alone can describe. The file is
+ * sparse, only the meta and bitmap pages are written.
+ */
+TEST(DiskManagerTest, LargeFileTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  const uint32_t full_extents = DiskFileMetaPage::META_EXTENTS;
+  const page_id_t full_pages = full_extents * DiskManager::BITMAP_SIZE;
+  {
+    int fd = open(db_name.c_str(), O_RDWR | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+    char buf[PAGE_SIZE];
+    memset(buf, 0, PAGE_SIZE);
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(buf);
+    meta_page->num_allocated_pages_ = full_pages;
+    meta_page->num_extents_ = full_extents;
+    meta_page->SetPageSize(PAGE_SIZE);
+    for (uint32_t i = 0; i < full_extents; i++) {
+      meta_page->extent_used_page_[i] = DiskManager::BITMAP_SIZE;
+    }
+    ASSERT_EQ(PAGE_SIZE, pwrite(fd, buf, PAGE_SIZE, 0));
+    memset(buf, 0xff, PAGE_SIZE);
+    auto page_counts = reinterpret_cast<uint32_t *>(buf);
+    page_counts[0] = DiskManager::BITMAP_SIZE;
+    page_counts[1] = DiskManager::BITMAP_SIZE;
+    for (uint32_t i = 0; i < full_extents; i++) {
+      off_t offset = static_cast<off_t>(i) * (DiskManager::BITMAP_SIZE + 1) * PAGE_SIZE + PAGE_SIZE;
+      ASSERT_EQ(PAGE_SIZE, pwrite(fd, buf, PAGE_SIZE, offset));
+    }
+    close(fd);
+  }
+
+  // Scenario: the next page comes from a new extent past the meta page limit, at an offset far beyond 4 GB.
+  auto *disk_mgr = new DiskManager(db_name);
+  page_id_t page_id = disk_mgr->AllocatePage();
+  ASSERT_EQ(full_pages, page_id);
+  char data[PAGE_SIZE];
+  memset(data, 'x', PAGE_SIZE);
+  disk_mgr->WritePage(page_id, data);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the page and the count of the new extent survive reopening the file.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(full_pages + 1, meta_page->GetAllocatedPages());
+  EXPECT_EQ(full_extents + 1, meta_page->GetExtentNums());
+  EXPECT_FALSE(disk_mgr->IsPageFree(page_id));
+  EXPECT_TRUE(disk_mgr->IsPageFree(page_id + 1));
+  char buf[PAGE_SIZE];
+  disk_mgr->ReadPage(page_id, buf);
+  EXPECT_EQ(0, memcmp(buf, data, PAGE_SIZE));
+  EXPECT_EQ(page_id + 1, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(page_id);
+  EXPECT_EQ(full_pages + 1, meta_page->GetAllocatedPages());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageSizeTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  // Scenario: a new file records the page size of the build.
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(PAGE_SIZE, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetPageSize());
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: a file with another page size is refused, a file without a recorded page size has 4 KB pages.
+  char buf[DiskFileMetaPage::META_SIZE];
+  int fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_EQ(sizeof(buf), pread(fd, buf, sizeof(buf), 0));
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(buf);
+  meta_page->SetPageSize(PAGE_SIZE * 2);
+  ASSERT_EQ(sizeof(buf), pwrite(fd, buf, sizeof(buf), 0));
+  EXPECT_THROW(DiskManager{db_name}, std::runtime_error);
+  meta_page->magic_ = 0;
+  ASSERT_EQ(sizeof(buf), pwrite(fd, buf, sizeof(buf), 0));
+  close(fd);
+  if (PAGE_SIZE == DiskFileMetaPage::LEGACY_PAGE_SIZE) {
+    disk_mgr = new DiskManager(db_name);
+    EXPECT_FALSE(disk_mgr->IsPageFree(0));
+    disk_mgr->Close();
+    delete disk_mgr;
+  } else {
+    EXPECT_THROW(DiskManager{db_name}, std::runtime_error);
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageReadWriteTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  const int num_pages = 100;
+  char buf[PAGE_SIZE];
+  char data[PAGE_SIZE];
+  auto *disk_mgr = new DiskManager(db_name);
+  // Scenario: a page past the end of the file reads as zeros.
+  memset(buf, 1, PAGE_SIZE);
+  disk_mgr->ReadPage(num_pages, buf);
+  for (char c : buf) {
+    ASSERT_EQ(0, c);
+  }
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    memset(data, 'a' + i % 26, PAGE_SIZE);
+    disk_mgr->WritePage(i, data);
+  }
+  // Scenario: pages and allocation state survive closing and reopening the file.
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages, meta_page->GetAllocatedPages());
+  for (int i = num_pages - 1; i >= 0; i--) {
+    ASSERT_FALSE(disk_mgr->IsPageFree(i));
+    disk_mgr->ReadPage(i, buf);
+    memset(data, 'a' + i % 26, PAGE_SIZE);
+    ASSERT_EQ(0, memcmp(buf, data, PAGE_SIZE));
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * Random page reads from 1 to 16 threads. Reads use pread with no shared cursor and no latch, so they should scale
+ * with the threads as long as the file is in the page cache.
+ */
+TEST(DiskManagerTest, ConcurrentRandomReadTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  const int num_pages = 1024;
+  const int reads_per_thread = 20000;
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    memset(data, 0, PAGE_SIZE);
+    memcpy(data, &i, sizeof(i));
+    memcpy(data + PAGE_SIZE - sizeof(i), &i, sizeof(i));
+    disk_mgr->WritePage(i, data);
+  }
+  disk_mgr->Sync();
+
+  for (int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        std::minstd_rand rng(t);
+        char buf[PAGE_SIZE];
+        for (int i = 0; i < reads_per_thread; i++) {
+          int page_id = static_cast<int>(rng() % num_pages);
+          disk_mgr->ReadPage(page_id, buf);
+          int head;
+          int tail;
+          memcpy(&head, buf, sizeof(head));
+          memcpy(&tail, buf + PAGE_SIZE - sizeof(tail), sizeof(tail));
+          ASSERT_EQ(page_id, head);
+          ASSERT_EQ(page_id, tail);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double total_reads = static_cast<double>(num_threads) * reads_per_thread;
+    std::cout << "threads: " << num_threads << ", random reads: " << total_reads / elapsed.count() / 1e3 << " K/s"
+              << std::endl;
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
@@ -1,5 +1,7 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+#include <map>
 #include <unordered_map>
 #include <vector>
 
@@ -60,6 +62,7 @@ TEST(TableHeapTest, TableHeapSampleTest) {
     delete row_kv.second;
   }
   ASSERT_EQ(size, 0);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
 }
 
 
@@ -160,4 +163,295 @@ TEST(TableHeapTest, TableHeapOperateTest) {
       std::cerr << "Pointer is already null for RowId: " << row_kv.first << std::endl;
     }
   }
-}
\ No newline at end of file
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+}
+static int32_t IdOf(Row &row) {
+  int32_t id;
+  row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&id));
+  return id;
+}
+
+TEST(TableHeapTest, VacuumTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  // a small pool, so that the vacuum fetches pages back from the file
+  auto bpm_ = new BufferPoolManager(64, disk_mgr_);
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'a', sizeof(characters));
+  // row id of each row that is kept, indexed by the id column
+  std::unordered_map<int32_t, RowId> kept;
+  size_t deleted = 0;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    // keep one row out of eight, and all the rows at the end of the table
+    if (i % 8 == 0 || i >= row_nums - 100) {
+      kept.emplace(i, row.GetRowId());
+    } else {
+      ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+      deleted++;
+    }
+  }
+  auto count_pages = [&]() {
+    size_t pages = 0;
+    for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+      auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+      page_id_t next_page_id = page->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return pages;
+  };
+  size_t pages_before = count_pages();
+  // with large pages the whole table fits in the pool, it has to be on disk for the file to be truncated
+  bpm_->FlushAllPages();
+
+  size_t moves = 0;
+  auto stats = table_heap->Vacuum(nullptr, [&](const RowView &view, const RowId &old_rid) {
+    int32_t id;
+    view.GetField(0).SerializeTo(reinterpret_cast<char *>(&id));
+    auto it = kept.find(id);
+    ASSERT_NE(kept.end(), it);
+    ASSERT_EQ(it->second, old_rid);
+    it->second = view.GetRowId();
+    moves++;
+  });
+  ASSERT_EQ(deleted, stats.purged_tuples_);
+  ASSERT_EQ(moves, stats.moved_tuples_);
+  ASSERT_GT(stats.freed_pages_, 0);
+  size_t pages_after = count_pages();
+  ASSERT_EQ(pages_before - stats.freed_pages_, pages_after);
+  ASSERT_LT(pages_after * 4, pages_before);
+
+  // every kept row is found at its new row id, and nothing else is left in the table
+  for (auto &kv : kept) {
+    Row row(kv.second);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(kv.first, IdOf(row));
+  }
+  size_t scanned = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    scanned++;
+  }
+  ASSERT_EQ(kept.size(), scanned);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+
+  // the pages given back are cut off the end of the file
+  ASSERT_GT(bpm_->Truncate(), 0);
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, characters, 64, true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  Row fetched(row.GetRowId());
+  ASSERT_TRUE(table_heap->GetTuple(&fetched, nullptr));
+  ASSERT_EQ(row_nums, IdOf(fetched));
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, DeleteTableTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("a", TypeId::kTypeChar, CHAR_OVERFLOW_THRESHOLD, 1, true, false),
+                                   new Column("b", TypeId::kTypeChar, CHAR_OVERFLOW_THRESHOLD, 2, true, false),
+                                   new Column("c", TypeId::kTypeChar, CHAR_OVERFLOW_THRESHOLD, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr_->GetMetaData());
+  uint32_t allocated_pages = meta_page->GetAllocatedPages();
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  // the longest values kept in the row
+  char characters[CHAR_OVERFLOW_THRESHOLD];
+  memset(characters, 'a', sizeof(characters));
+  // more pages than a batch of the drop
+  const int row_nums = 6000;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, CHAR_OVERFLOW_THRESHOLD, true),
+                  Field(TypeId::kTypeChar, characters, CHAR_OVERFLOW_THRESHOLD, true),
+                  Field(TypeId::kTypeChar, characters, CHAR_OVERFLOW_THRESHOLD, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  std::vector<page_id_t> page_ids;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_ids.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_GT(page_ids.size(), DEFAULT_DELETE_BATCH_PAGES);
+
+  ASSERT_EQ(page_ids.size(), table_heap->DeleteTable());
+  for (auto page_id : page_ids) {
+    ASSERT_TRUE(bpm_->IsPageFree(page_id));
+  }
+  ASSERT_EQ(allocated_pages, meta_page->GetAllocatedPages());
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, OverflowTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr_->GetMetaData());
+  uint32_t allocated_pages = meta_page->GetAllocatedPages();
+
+  // a chain longer than a page
+  std::string data(3 * PAGE_SIZE, 'x');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  page_id_t chain = OverflowPage::WriteChain(bpm_, data.data(), data.size());
+  ASSERT_NE(INVALID_PAGE_ID, chain);
+  std::string read(data.size(), '\0');
+  ASSERT_TRUE(OverflowPage::ReadChain(bpm_, chain, read.data(), read.size()));
+  ASSERT_EQ(data, read);
+  ASSERT_EQ((data.size() + OverflowPage::SIZE_MAX_DATA - 1) / OverflowPage::SIZE_MAX_DATA,
+            OverflowPage::FreeChain(bpm_, chain));
+
+  // long values of odd rows go out of line, even rows keep a short one
+  const int row_nums = 400;
+  const uint32_t long_len = VARCHAR_MAX_LEN - 1;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("note", TypeId::kTypeChar, VARCHAR_MAX_LEN, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  ASSERT_TRUE(schema->MayOverflow());
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  auto note_of = [&](int i) {
+    return i % 2 == 1 ? std::string(long_len, static_cast<char>('a' + i % 26)) : "short " + std::to_string(i);
+  };
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string note = note_of(i);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, note.data(), note.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // the heap keeps only the stubs: a handful of pages instead of one per long row
+  size_t heap_pages = 0;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; heap_pages++) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    page_id = reinterpret_cast<TablePage *>(guard.GetPage())->GetNextPageId();
+  }
+  ASSERT_LT(heap_pages * 20, static_cast<size_t>(row_nums));
+
+  for (int i = 0; i < row_nums; i++) {
+    Row row(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(i, IdOf(row));
+    ASSERT_EQ(note_of(i), row.GetField(1)->toString());
+    // the other column is read in place without the buffer pool, which the long value would need
+    ReadPageGuard guard = bpm_->FetchPageRead(rids[i].GetPageId());
+    RowView view;
+    ASSERT_TRUE(reinterpret_cast<TablePage *>(guard.GetPage())->GetTupleView(rids[i], schema.get(), &view));
+    ASSERT_EQ(CmpBool::kTrue, view.GetField(0).CompareEquals(Field(TypeId::kTypeInt, i)));
+    ASSERT_EQ(i % 2 == 1, view.GetOverflowPageId(1) != INVALID_PAGE_ID);
+  }
+  // a scan materializes the long values through the buffer pool
+  int scanned = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    Row row(*it);
+    ASSERT_EQ(note_of(IdOf(row)), row.GetField(1)->toString());
+    scanned++;
+  }
+  ASSERT_EQ(row_nums, scanned);
+
+  // updates and deletes give the chains of the old values back
+  for (int i = 0; i < row_nums; i++) {
+    std::string note = i % 4 < 2 ? note_of(i + 1) : "";
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, note.data(), note.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+    rids[i] = row.GetRowId();
+    Row fetched(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&fetched, nullptr));
+    ASSERT_EQ(note, fetched.GetField(1)->toString());
+  }
+  for (int i = 0; i < row_nums; i += 2) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+
+  // a vacuum moves the stubs of long values, the chains behind them stay where they are
+  std::vector<RowId> fillers;
+  for (int i = 0; i < row_nums * 4; i++) {
+    Fields fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, const_cast<char *>("filler"), 6, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    fillers.push_back(row.GetRowId());
+  }
+  std::map<int, page_id_t> chains;
+  for (int i = row_nums; i < row_nums + 50; i++) {
+    std::string note = note_of(1);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, note.data(), note.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ReadPageGuard guard = bpm_->FetchPageRead(row.GetRowId().GetPageId());
+    RowView view;
+    ASSERT_TRUE(reinterpret_cast<TablePage *>(guard.GetPage())->GetTupleView(row.GetRowId(), schema.get(), &view));
+    chains.emplace(i, view.GetOverflowPageId(1));
+  }
+  for (auto &rid : fillers) {
+    ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+  }
+  size_t moved_chains = 0;
+  table_heap->Vacuum(nullptr, [&](const RowView &view, const RowId &) {
+    int32_t id;
+    view.GetField(0).SerializeTo(reinterpret_cast<char *>(&id));
+    if (chains.count(id) > 0) {
+      ASSERT_EQ(chains[id], view.GetOverflowPageId(1));
+      moved_chains++;
+    }
+  });
+  ASSERT_GT(moved_chains, 0);
+  int long_rows = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    Row row(*it);
+    if (IdOf(row) >= row_nums) {
+      ASSERT_EQ(note_of(1), row.GetField(1)->toString());
+      long_rows++;
+    }
+  }
+  ASSERT_EQ(50, long_rows);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+
+  // a stub whose chain cannot be read gives a null value instead of garbage
+  std::string note = note_of(1);
+  Fields fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, note.data(), note.size(), true)};
+  Row row(fields);
+  const page_id_t stub_pages[] = {INVALID_PAGE_ID, 0x5a5a5a5a};
+  std::vector<char> buf(row.GetSerializedSize(schema.get(), RowFormat::kCompact, stub_pages));
+  row.SerializeTo(buf.data(), schema.get(), RowFormat::kCompact, stub_pages);
+  auto stub = std::search(buf.begin(), buf.end(), reinterpret_cast<const char *>(&stub_pages[1]),
+                          reinterpret_cast<const char *>(&stub_pages[1]) + sizeof(page_id_t));
+  ASSERT_NE(buf.end(), stub);
+  memcpy(&*stub, &stub_pages[0], sizeof(page_id_t));
+  RowView broken(buf.data(), schema.get(), RowFormat::kCompact, RowId(), bpm_);
+  ASSERT_TRUE(broken.GetField(1).IsNull());
+  Row materialized;
+  broken.Materialize(&materialized);
+  ASSERT_TRUE(materialized.GetField(1)->IsNull());
+  Row deserialized;
+  deserialized.DeserializeFrom(buf.data(), schema.get(), RowFormat::kCompact, bpm_);
+  ASSERT_TRUE(deserialized.GetField(1)->IsNull());
+  ASSERT_EQ(CmpBool::kTrue, deserialized.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 0)));
+  table_heap->DeleteTable();
+  ASSERT_EQ(allocated_pages, meta_page->GetAllocatedPages());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+}